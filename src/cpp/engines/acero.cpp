@@ -19,12 +19,586 @@
 // ------------------------------
 // Dependencies
 
-#include "../headers/arrow_deps.hpp"
+#include "adapter_acero.hpp"
 
 
 // ------------------------------
-// Classes and Functions
+// Functions
 
 namespace mohair::adapters {
 
-} // mohair::adapters
+  // >> Convenience functions for executing Acero plans
+
+  /**
+   * Executes an Acero plan (arrow::engine::PlanInfo) using arrow::acero::DeclarationToTable.
+   *
+   * DeclarationToTable takes a Declaration, then creates and executes an ExecPlan. There
+   * are async versions (with an async suffix) and the "ToTable" suffix indicates that the
+   * results are returned as an arrow::Table.
+   */
+  Result<shared_ptr<Table>> ExecutePlan(PlanInfo &acero_plan) {
+    QueryOptions default_planopts;
+    const Declaration &plan_root = acero_plan.root.declaration;
+
+    return arrow::acero::DeclarationToTable(plan_root, std::move(default_planopts));
+  }
+
+  /**
+   * Executes an Acero plan using arrow::acero::DeclarationToReader.
+   *
+   * Unlike `ExecutePlan`, results are not materialized. The ExecPlan runs in the
+   * background and each call to `ReadNext` on the returned reader produces the next
+   * batch of results (or nullptr when the plan is finished).
+   */
+  Result<unique_ptr<RecordBatchReader>> StreamPlan(PlanInfo &acero_plan) {
+    QueryOptions default_planopts;
+    const Declaration &plan_root = acero_plan.root.declaration;
+
+    return arrow::acero::DeclarationToReader(plan_root, std::move(default_planopts));
+  }
+
+  /**
+   * Executes an Acero plan within `query_ctx` and materializes its results.
+   *
+   * The plan runs on the context's executor and allocates from a memory pool of its own
+   * (see `QueryContext::MemoryPoolForQuery`). This blocks until the context admits the plan.
+   */
+  Result<shared_ptr<Table>> ExecutePlan(PlanInfo &acero_plan, QueryContext &query_ctx) {
+    query_ctx.Admit();
+    auto query_pool = query_ctx.MemoryPoolForQuery();
+
+    // the plan's output is a single table, instead of a stream of batches
+    shared_ptr<Table> result_table;
+    arrow::acero::TableSinkNodeOptions sink_opts { &result_table };
+    sink_opts.sequence_output = query_ctx.sequence_output;
+
+    auto exec_plan = ExecPlan::Make(
+       query_ctx.OptionsForQuery(query_pool.get())
+      ,query_ctx.ComputeContextForQuery(query_pool.get())
+    );
+
+    Status exec_status = exec_plan.status();
+    if (exec_status.ok()) {
+      auto sink_decl = Declaration::Sequence({
+        acero_plan.root.declaration, { "table_sink", sink_opts }
+      });
+
+      exec_status = sink_decl.AddToPlan(exec_plan->get()).status();
+    }
+
+    if (exec_status.ok()) {
+      (*exec_plan)->StartProducing();
+      exec_status = (*exec_plan)->finished().status();
+    }
+
+    query_ctx.Release();
+    ARROW_RETURN_NOT_OK(exec_status);
+
+    return result_table;
+  }
+
+  /**
+   * Executes an Acero plan within `query_ctx` and streams its results.
+   *
+   * Like `ExecutePlan(PlanInfo&, QueryContext&)`, but the returned reader keeps the plan's
+   * admission until the plan's results have been consumed (or the reader is closed). The
+   * plan only runs ahead of the reader by a bounded number of bytes (see
+   * `BackpressureOptions::DefaultBackpressure`).
+   */
+  Result<unique_ptr<RecordBatchReader>>
+  StreamPlan(PlanInfo &acero_plan, QueryContext &query_ctx) {
+    query_ctx.Admit();
+
+    // the reader releases the admission if we return early
+    auto plan_reader = std::make_unique<ContextPlanReader>(&query_ctx);
+
+    auto query_pool = plan_reader->query_pool.get();
+    ARROW_ASSIGN_OR_RAISE(
+       plan_reader->exec_plan
+      ,ExecPlan::Make(
+          query_ctx.OptionsForQuery(query_pool)
+         ,query_ctx.ComputeContextForQuery(query_pool)
+       )
+    );
+
+    // the sink pauses the plan's sources when unread batches exceed the default bound, so
+    // a slow consumer doesn't accumulate the plan's output in memory
+    arrow::acero::SinkNodeOptions sink_opts {
+       &(plan_reader->batch_gen)
+      ,&(plan_reader->output_schema)
+      ,arrow::acero::BackpressureOptions::DefaultBackpressure()
+      ,&(plan_reader->backpressure_monitor)
+    };
+    sink_opts.sequence_output = query_ctx.sequence_output;
+
+    auto sink_decl = Declaration::Sequence({
+      acero_plan.root.declaration, { "sink", sink_opts }
+    });
+
+    ARROW_RETURN_NOT_OK(sink_decl.AddToPlan(plan_reader->exec_plan.get()));
+    plan_reader->exec_plan->StartProducing();
+    plan_reader->is_started = true;
+
+    return unique_ptr<RecordBatchReader> { std::move(plan_reader) };
+  }
+
+
+  // >> Convenience functions for translating plans
+
+  /**
+   * Replaces each "named_table" declaration in a plan with the Declaration that
+   * `provider` returns for it.
+   */
+  Status BindNamedTables(Declaration &plan_decl, const NamedTableProvider &provider) {
+    if (plan_decl.factory_name == "named_table") {
+      const auto &table_opts = static_cast<const NamedTableNodeOptions&>(*plan_decl.options);
+      ARROW_ASSIGN_OR_RAISE(plan_decl, provider(table_opts.names, *table_opts.schema));
+
+      return Status::OK();
+    }
+
+    for (auto &decl_input : plan_decl.inputs) {
+      auto input_decl = std::get_if<Declaration>(&decl_input);
+      if (input_decl != nullptr) { ARROW_RETURN_NOT_OK(BindNamedTables(*input_decl, provider)); }
+    }
+
+    return Status::OK();
+  }
+
+
+  // >> Convenience functions for consuming streamed results
+
+  /**
+   * Reads batches from `reader` until at least `chunk_size` rows have been read, then
+   * returns them as a Table (the batches are not copied). Returns nullptr when the reader
+   * is exhausted.
+   */
+  Result<shared_ptr<Table>> NextChunk(RecordBatchReader *reader, int64_t chunk_size) {
+    vector<shared_ptr<RecordBatch>> chunk_batches;
+    int64_t                         chunk_rows = 0;
+
+    while (chunk_rows < chunk_size) {
+      shared_ptr<RecordBatch> next_batch;
+      ARROW_RETURN_NOT_OK(reader->ReadNext(&next_batch));
+
+      // a null batch signals the end of the stream
+      if (next_batch == nullptr) { break; }
+
+      chunk_rows += next_batch->num_rows();
+      chunk_batches.push_back(std::move(next_batch));
+    }
+
+    if (chunk_batches.empty()) { return nullptr; }
+    return Table::FromRecordBatches(reader->schema(), chunk_batches);
+  }
+
+} // namespace: mohair::adapters
+
+
+// ------------------------------
+// Classes and Methods
+
+namespace mohair::adapters {
+
+  //  >> QueryContext
+
+  QueryContext::QueryContext( shared_ptr<ThreadPool> pool
+                             ,bool                   threads
+                             ,bool                   sequenced
+                             ,size_t                 query_limit)
+    :  cpu_pool(std::move(pool))
+      ,memory_pool(arrow::default_memory_pool())
+      ,use_threads(threads)
+      ,sequence_output(sequenced)
+      ,max_queries(query_limit)
+  {
+    // Acero requires an executor, so serial plans are given a pool of a single thread
+    if (not use_threads and cpu_pool == nullptr) {
+      auto serial_pool = ThreadPool::Make(1);
+      if (serial_pool.ok()) { cpu_pool = std::move(serial_pool).ValueOrDie(); }
+      else { mohair::PrintError("Unable to create serial executor", serial_pool.status()); }
+    }
+  }
+
+  /**
+   * Creates a context with a dedicated thread pool of `thread_count` threads (as many as
+   * the machine has cores, if not positive). A context with a single thread executes
+   * plans serially.
+   */
+  Result<shared_ptr<QueryContext>>
+  QueryContext::Make(int thread_count, size_t query_limit, bool sequenced) {
+    if (thread_count < 1) { thread_count = ThreadPool::DefaultCapacity(); }
+    ARROW_ASSIGN_OR_RAISE(auto thread_pool, ThreadPool::Make(thread_count));
+
+    return std::make_shared<QueryContext>(
+      std::move(thread_pool), /*threads=*/thread_count > 1, sequenced, query_limit
+    );
+  }
+
+  /** The executor for plans in this context (Arrow's CPU pool if none was given). */
+  Executor* QueryContext::QueryExecutor() {
+    if (cpu_pool != nullptr) { return cpu_pool.get(); }
+
+    return arrow::internal::GetCpuThreadPool();
+  }
+
+  /**
+   * Creates a memory pool for a query, which tracks the query's allocations and forwards
+   * them to the context's pool. The pool is shared by the query's owner and this context:
+   * batches of a query's result may outlive the query, so the context keeps the pool
+   * until its owner releases it and every allocation from it is freed.
+   */
+  shared_ptr<ProxyMemoryPool> QueryContext::MemoryPoolForQuery() {
+    auto query_pool = std::make_shared<ProxyMemoryPool>(&memory_pool);
+
+    std::lock_guard<std::mutex> pool_lock { pool_mutex };
+    query_pools.erase(
+       std::remove_if(
+          query_pools.begin()
+         ,query_pools.end()
+         ,[](const shared_ptr<ProxyMemoryPool> &released_pool) {
+            return released_pool.use_count() == 1 and released_pool->bytes_allocated() == 0;
+          }
+       )
+      ,query_pools.end()
+    );
+
+    query_pools.push_back(query_pool);
+    return query_pool;
+  }
+
+  /** Options for a query that allocates from `query_pool` (see `MemoryPoolForQuery`). */
+  QueryOptions QueryContext::OptionsForQuery(MemoryPool *query_pool) {
+    QueryOptions query_opts;
+    query_opts.use_threads = use_threads;
+    query_opts.memory_pool = query_pool;
+
+    return query_opts;
+  }
+
+  ComputeContext QueryContext::ComputeContextForQuery(MemoryPool *query_pool) {
+    return ComputeContext { query_pool, QueryExecutor() };
+  }
+
+  /** Blocks until fewer than `max_queries` plans are executing, then admits a plan. */
+  void QueryContext::Admit() {
+    std::unique_lock<std::mutex> admit_lock { admit_mutex };
+    admit_cv.wait(admit_lock, [this] { return active_queries < max_queries; });
+
+    ++active_queries;
+  }
+
+  /** Releases the admission of a finished plan, which admits a waiting plan (if any). */
+  void QueryContext::Release() {
+    {
+      std::lock_guard<std::mutex> admit_lock { admit_mutex };
+      --active_queries;
+    }
+
+    admit_cv.notify_one();
+  }
+
+
+  //  >> ContextPlanReader
+
+  ContextPlanReader::~ContextPlanReader() {
+    auto close_status = Close();
+    if (not close_status.ok()) {
+      mohair::PrintError("Error when closing plan reader:", close_status);
+    }
+  }
+
+  shared_ptr<Schema> ContextPlanReader::schema() const { return output_schema; }
+
+  /** Emits the next batch produced by the plan, closing the reader after the last one. */
+  Status ContextPlanReader::ReadNext(shared_ptr<RecordBatch> *batch) {
+    *batch = nullptr;
+    if (exec_plan == nullptr) { return Status::OK(); }
+
+    ARROW_ASSIGN_OR_RAISE(auto exec_batch, batch_gen().result());
+
+    // an empty batch signals the end of the plan's output
+    if (not exec_batch.has_value()) { return Close(); }
+
+    ARROW_ASSIGN_OR_RAISE(
+      *batch, exec_batch->ToRecordBatch(output_schema, query_pool.get())
+    );
+
+    return Status::OK();
+  }
+
+  /** Stops the plan (if it is still running), then releases its admission. */
+  Status ContextPlanReader::Close() {
+    Status plan_status;
+
+    if (exec_plan != nullptr and is_started) {
+      if (not exec_plan->finished().is_finished()) { exec_plan->StopProducing(); }
+      plan_status = exec_plan->finished().status();
+    }
+    exec_plan = nullptr;
+
+    if (is_admitted) {
+      query_ctx->Release();
+      is_admitted = false;
+    }
+
+    return plan_status;
+  }
+
+
+  //  >> SliceRequest
+
+  SliceRequest SliceRequest::FromSkyRel(const SkyRel &sky_rel) {
+    return SliceRequest {
+       sky_rel.domain()
+      ,sky_rel.partition()
+      ,vector<uint32_t>(sky_rel.slices().begin(), sky_rel.slices().end())
+    };
+  }
+
+  bool SliceRequest::IsSliceRequest(const vector<string> &tname) {
+    return tname.size() >= 3 and tname[0] == sky_slices_marker;
+  }
+
+  bool SliceRequest::IsSchemaRequest(const vector<string> &tname) {
+    return tname.size() == 3 and tname[0] == sky_schema_marker;
+  }
+
+  /** Parses a slice request or a schema request (which names no slices). */
+  Result<SliceRequest> SliceRequest::FromNames(const vector<string> &tname) {
+    if (not IsSliceRequest(tname) and not IsSchemaRequest(tname)) {
+      return Status::Invalid("Table name is not a slice request: ", JoinStr(tname, "."));
+    }
+
+    SliceRequest request { tname[1], tname[2], {} };
+    request.slice_ids.reserve(tname.size() - 3);
+
+    for (size_t name_ndx = 3; name_ndx < tname.size(); ++name_ndx) {
+      try { request.slice_ids.push_back(std::stoul(tname[name_ndx])); }
+      catch (const std::exception &) {
+        return Status::Invalid("Invalid slice id in slice request: ", tname[name_ndx]);
+      }
+    }
+
+    return request;
+  }
+
+  vector<string> SliceRequest::ToNames() const {
+    vector<string> tname { sky_slices_marker, domain, partition };
+
+    tname.reserve(3 + slice_ids.size());
+    for (const auto slice_id : slice_ids) { tname.push_back(std::to_string(slice_id)); }
+
+    return tname;
+  }
+
+  vector<string> SliceRequest::SchemaNames() const {
+    return vector<string> { sky_schema_marker, domain, partition };
+  }
+
+  /** Name of the partition, as used for statistics and plan views (see SourceNameForSky). */
+  string SliceRequest::PartitionName() const { return domain + "." + partition; }
+
+
+  //  >> SkyExtensionProvider
+
+  Result<DeclarationInfo>
+  SkyExtensionProvider::MakeRel( const ConversionOptions       &conv_opts
+                                ,const vector<DeclarationInfo> &inputs
+                                ,const google::protobuf::Any   &rel
+                                ,const ExtensionSet            &ext_set) {
+    if (not rel.Is<SkyRel>()) {
+      return DefaultExtensionProvider::MakeRel(conv_opts, inputs, rel, ext_set);
+    }
+
+    SkyRel sky_rel;
+    if (not rel.UnpackTo(&sky_rel)) { return Status::Invalid("Unable to unpack SkyRel"); }
+
+    // resolve the schema of the partition, then leave a placeholder to be bound later
+    auto   slice_request = SliceRequest::FromSkyRel(sky_rel);
+    auto   slice_names   = slice_request.ToNames();
+    Schema unknown_schema { arrow::FieldVector {} };
+
+    ARROW_ASSIGN_OR_RAISE(
+       auto schema_decl
+      ,table_provider(slice_request.SchemaNames(), unknown_schema)
+    );
+    ARROW_ASSIGN_OR_RAISE(auto slice_schema, arrow::acero::DeclarationToSchema(schema_decl));
+
+    return DeclarationInfo {
+       Declaration { "named_table", NamedTableNodeOptions { slice_names, slice_schema } }
+      ,slice_schema
+    };
+  }
+
+
+  //  >> PlanCache
+
+  /**
+   * Indexes `entry` by a serialized form of its plan, so later requests with the same
+   * bytes skip canonicalization. An entry keeps at most `max_raw_plans_per_entry` forms.
+   */
+  void PlanCache::IndexRawPlan(EntryList::iterator entry, std::string_view raw_plan) {
+    auto &raw_plans = entry->raw_plans;
+    if (raw_plans.size() >= max_raw_plans_per_entry) { return; }
+    if (std::find(raw_plans.begin(), raw_plans.end(), raw_plan) != raw_plans.end()) { return; }
+
+    raw_plans.emplace_back(raw_plan);
+    raw_index[std::hash<std::string_view>{}(raw_plan)] = entry;
+  }
+
+  /** Removes `entry` and each index that refers to it. */
+  void PlanCache::EraseEntry(EntryList::iterator entry) {
+    for (const auto &raw_plan : entry->raw_plans) {
+      auto raw_entry = raw_index.find(std::hash<string>{}(raw_plan));
+      if (raw_entry != raw_index.end() and raw_entry->second == entry) {
+        raw_index.erase(raw_entry);
+      }
+    }
+
+    auto index_entry = entry_index.find(std::hash<string>{}(entry->canonical_plan));
+    if (index_entry != entry_index.end() and index_entry->second == entry) {
+      entry_index.erase(index_entry);
+    }
+
+    entries.erase(entry);
+  }
+
+  /**
+   * Returns the cached template (an Acero plan with unbound named tables) for `plan_msg`.
+   *
+   * The serialized plan is looked up first, so a repeated request is neither parsed nor
+   * canonicalized. Otherwise, the plan's canonical form is looked up and, on a cache miss,
+   * the plan is translated with named tables left unbound and the result is cached.
+   * `provider` is only used to resolve the schema of SkyRel reads (see
+   * `SkyExtensionProvider`) during translation.
+   */
+  Result<PlanInfo>
+  PlanCache::TemplateFor(const Buffer &plan_msg, const NamedTableProvider &provider) {
+    std::string_view raw_plan {
+      reinterpret_cast<const char*>(plan_msg.data()), static_cast<size_t>(plan_msg.size())
+    };
+
+    std::unique_lock<std::mutex> cache_lock { cache_mutex };
+    auto raw_entry = raw_index.find(std::hash<std::string_view>{}(raw_plan));
+    if (raw_entry != raw_index.end()) {
+      // a hit requires the serialized plans to match (not just their hashes)
+      const auto &raw_plans = raw_entry->second->raw_plans;
+      if (std::find(raw_plans.begin(), raw_plans.end(), raw_plan) != raw_plans.end()) {
+        entries.splice(entries.begin(), entries, raw_entry->second);
+        return entries.front().plan_template;
+      }
+    }
+    cache_lock.unlock();
+
+    auto  parse_arena    = mohair::NewPlanArena();
+    Plan& substrait_plan = *(Arena::Create<Plan>(parse_arena.get()));
+    if (not substrait_plan.ParseFromArray(plan_msg.data(), plan_msg.size())) {
+      return Status::Invalid("Unable to parse substrait plan");
+    }
+
+    string canonical_plan { mohair::CanonicalPlanString(substrait_plan) };
+    size_t plan_hash      { std::hash<string>{}(canonical_plan) };
+    PlanInfo acero_plan;
+
+    cache_lock.lock();
+    auto index_entry = entry_index.find(plan_hash);
+
+    // a cache hit requires the canonical plans to match (not just their hashes)
+    bool is_hit = (
+          index_entry != entry_index.end()
+      and index_entry->second->canonical_plan == canonical_plan
+    );
+
+    if (is_hit) {
+      // move the entry to the front of the list
+      entries.splice(entries.begin(), entries, index_entry->second);
+      IndexRawPlan(entries.begin(), raw_plan);
+      acero_plan = entries.front().plan_template;
+      cache_lock.unlock();
+    }
+
+    else {
+      cache_lock.unlock();
+
+      // narrow the schema of projected reads, so providers only produce needed columns
+      const Buffer *translated_msg = &plan_msg;
+      shared_ptr<Buffer> projected_msg;
+
+      if (mohair::PushReadProjections(substrait_plan) > 0) {
+        projected_msg  = Buffer::FromString(substrait_plan.SerializeAsString());
+        translated_msg = projected_msg.get();
+      }
+
+      // filters on reads are passed to providers, which may skip chunks using zone maps
+      auto zone_preds = mohair::ZonePredicatesForReads(substrait_plan);
+
+      // translate the plan, leaving named tables as placeholders
+      ConversionOptions conv_opts;
+      conv_opts.extension_provider   = std::make_shared<SkyExtensionProvider>(provider);
+      conv_opts.named_table_provider = [&zone_preds]( const vector<string> &tname
+                                                     ,const Schema         &tschema)
+                                                     -> Result<Declaration> {
+        auto table_meta = (
+            tschema.metadata() == nullptr
+          ? std::make_shared<arrow::KeyValueMetadata>()
+          : tschema.metadata()->Copy()
+        );
+
+        auto table_preds = zone_preds.find(mohair::JoinStr(tname, "."));
+        if (table_preds != zone_preds.end()) {
+          table_meta->Append(
+            mohair::zone_predicates_key, mohair::SerializeZonePredicates(table_preds->second)
+          );
+        }
+
+        return Declaration {
+           "named_table"
+          ,NamedTableNodeOptions {
+             tname, std::make_shared<Schema>(tschema.fields(), std::move(table_meta))
+           }
+        };
+      };
+
+      ExtensionSet acero_ext_set;
+      ARROW_ASSIGN_OR_RAISE(
+         acero_plan
+        ,arrow::engine::DeserializePlan(
+            *translated_msg
+           ,arrow::engine::default_extension_id_registry()
+           ,&acero_ext_set
+           ,conv_opts
+         )
+      );
+
+      cache_lock.lock();
+
+      // replace an entry with the same hash, then evict the least recently used entries
+      index_entry = entry_index.find(plan_hash);
+      if (index_entry != entry_index.end()) { EraseEntry(index_entry->second); }
+
+      entries.push_front(PlanCacheEntry { std::move(canonical_plan), {}, acero_plan });
+      entry_index[plan_hash] = entries.begin();
+      IndexRawPlan(entries.begin(), raw_plan);
+
+      while (entries.size() > capacity) { EraseEntry(std::prev(entries.end())); }
+
+      cache_lock.unlock();
+    }
+
+    return acero_plan;
+  }
+
+  /**
+   * Returns an Acero plan for `plan_msg` whose named tables are resolved by `provider`: a
+   * copy of the cached template (see `TemplateFor`), bound.
+   */
+  Result<PlanInfo>
+  PlanCache::PlanFor(const Buffer &plan_msg, const NamedTableProvider &provider) {
+    ARROW_ASSIGN_OR_RAISE(auto acero_plan, TemplateFor(plan_msg, provider));
+    ARROW_RETURN_NOT_OK(BindNamedTables(acero_plan.root.declaration, provider));
+
+    return acero_plan;
+  }
+
+} // namespace: mohair::adapters
@@ -22,6 +22,15 @@
 
 //  >> Internal libs
 #include "../mohair.hpp"
+#include "../query/plans.hpp"
+
+//  >> Standard libs
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <string_view>
+#include <algorithm>
 
 //  >> Acero deps
 #include <arrow/engine/api.h>
@@ -32,6 +41,8 @@
 #include <arrow/acero/exec_plan.h>
 #include <arrow/acero/options.h>
 
+#include <arrow/util/thread_pool.h>
+
 
 // ------------------------------
 // Type aliases
@@ -43,8 +54,258 @@ using arrow::engine::NamedTableProvider;
 using arrow::engine::ConversionOptions;
 using arrow::engine::ExtensionIdRegistry;
 using arrow::engine::ExtensionSet;
+using arrow::engine::DeclarationInfo;
+using arrow::engine::DefaultExtensionProvider;
 
 //  >> Acero types
 using arrow::acero::Declaration;
 using arrow::acero::TableSourceNodeOptions;
 using arrow::acero::QueryOptions;
+using arrow::acero::NamedTableNodeOptions;
+using arrow::acero::ExecPlan;
+
+using ComputeContext = arrow::compute::ExecContext;
+
+//  >> Arrow types
+using arrow::RecordBatch;
+using arrow::RecordBatchReader;
+using arrow::MemoryPool;
+using arrow::ProxyMemoryPool;
+
+using arrow::internal::Executor;
+using arrow::internal::ThreadPool;
+
+
+// ------------------------------
+// Classes
+
+namespace mohair::adapters {
+
+  // Default number of plans kept by a PlanCache
+  constexpr size_t default_plan_cache_size = 64;
+
+  // Default number of plans that a QueryContext executes concurrently
+  constexpr size_t default_max_queries = 8;
+
+  // Default sizes (in rows) for streaming execution
+  constexpr int64_t default_batch_size = TableSourceNodeOptions::kDefaultMaxBatchSize;
+  constexpr int64_t default_chunk_size = default_batch_size * 4;
+
+  /**
+   * Options for executing a plan incrementally rather than materializing its results.
+   *
+   * The batch size bounds the rows per batch produced by source nodes and the chunk size
+   * bounds the rows per chunk (table) that results are grouped into for output.
+   */
+  struct StreamOptions {
+    int64_t batch_size;
+    int64_t chunk_size;
+
+    StreamOptions(int64_t bsize, int64_t csize): batch_size(bsize), chunk_size(csize) {}
+    StreamOptions(): StreamOptions(default_batch_size, default_chunk_size) {}
+  };
+
+
+  // Most serialized forms of a plan that a PlanCache entry is found by (see `raw_plans`)
+  constexpr size_t max_raw_plans_per_entry = 4;
+
+  /**
+   * A translated plan, the canonical form of the substrait plan it came from, and the
+   * serialized forms (as received) that have been found to have that canonical form.
+   */
+  struct PlanCacheEntry {
+    string         canonical_plan;
+    vector<string> raw_plans;
+    PlanInfo       plan_template;
+  };
+
+  /**
+   * A bounded, least-recently-used cache of translated (Acero) plans.
+   *
+   * Entries are keyed by the hash of a plan's canonical form (see `CanonicalPlanString`).
+   * Canonicalization requires parsing a plan, so entries are also indexed by the hash of
+   * each serialized form they were requested with: a repeated request is found from its
+   * bytes alone and only a miss is parsed and canonicalized.
+   *
+   * A cached plan is a template: its named tables are unbound placeholders ("named_table"
+   * declarations) that are resolved by a NamedTableProvider each time the plan is used.
+   * A template's output schema is known, so describing a plan never binds its tables.
+   */
+  struct PlanCache {
+    using EntryList = std::list<PlanCacheEntry>;
+
+    size_t                                          capacity;
+    std::mutex                                      cache_mutex;
+    EntryList                                       entries;     // most recent first
+    std::unordered_map<size_t, EntryList::iterator> entry_index; // canonical hash -> entry
+    std::unordered_map<size_t, EntryList::iterator> raw_index;   // serialized hash -> entry
+
+    PlanCache(size_t max_entries): capacity(max_entries) {}
+    PlanCache(): PlanCache(default_plan_cache_size) {}
+
+    Result<PlanInfo> TemplateFor(const Buffer &plan_msg, const NamedTableProvider &provider);
+    Result<PlanInfo> PlanFor(const Buffer &plan_msg, const NamedTableProvider &provider);
+
+    // Functions that require `cache_mutex` to be held
+    void IndexRawPlan(EntryList::iterator entry, std::string_view raw_plan);
+    void EraseEntry(EntryList::iterator entry);
+  };
+
+
+  // First part of a table name that encodes a SliceRequest (or a request for its schema)
+  const string sky_slices_marker { "skytether.slices" };
+  const string sky_schema_marker { "skytether.schema" };
+
+  /**
+   * A request for specific slices of a Skytether partition (see `SkyRel`).
+   *
+   * Acero only passes table names to a NamedTableProvider, so a request is encoded as a
+   * table name: [sky_slices_marker, domain, partition, slice ids...]. The schema of a
+   * partition is requested as [sky_schema_marker, domain, partition]; a provider resolves
+   * it from the partition's metadata, without reading any slices.
+   */
+  struct SliceRequest {
+    string           domain;
+    string           partition;
+    vector<uint32_t> slice_ids;
+
+    static SliceRequest         FromSkyRel(const SkyRel &sky_rel);
+    static Result<SliceRequest> FromNames(const vector<string> &tname);
+    static bool                 IsSliceRequest(const vector<string> &tname);
+    static bool                 IsSchemaRequest(const vector<string> &tname);
+
+    vector<string> ToNames()       const;
+    vector<string> SchemaNames()   const;
+    string         PartitionName() const;
+  };
+
+  /**
+   * Translates SkyRel extension leaves into named tables that encode a SliceRequest, so
+   * they are bound like any other named table (see `BindNamedTables`). Other extension
+   * relations are translated by Arrow's default provider.
+   *
+   * Acero needs the schema of each relation at translation time, so `table_provider` is
+   * given a schema request (see `SliceRequest::SchemaNames`) once per SkyRel. No slices
+   * are read until the placeholder is bound.
+   */
+  struct SkyExtensionProvider : public DefaultExtensionProvider {
+    NamedTableProvider table_provider;
+
+    SkyExtensionProvider(NamedTableProvider provider): table_provider(std::move(provider)) {}
+
+    using DefaultExtensionProvider::MakeRel;
+    Result<DeclarationInfo> MakeRel( const ConversionOptions       &conv_opts
+                                    ,const vector<DeclarationInfo> &inputs
+                                    ,const google::protobuf::Any   &rel
+                                    ,const ExtensionSet            &ext_set) override;
+  };
+
+
+  /**
+   * State for executing Acero plans on behalf of a service.
+   *
+   * A context carries the executor that plans run on (Arrow's CPU pool, unless a thread
+   * pool is given), a memory pool that tracks the allocations of the context's queries,
+   * whether plans may use threads, and whether output should be sequenced (emitted in
+   * input order). Plans that may not use threads run on a pool of a single thread. At
+   * most `max_queries` plans execute at a time; other plans wait in `Admit` until a
+   * running plan finishes.
+   *
+   * Each query allocates from its own pool (see `MemoryPoolForQuery`), which tracks the
+   * query's allocations and forwards them to the context's pool.
+   */
+  struct QueryContext {
+    shared_ptr<ThreadPool>  cpu_pool;
+    ProxyMemoryPool         memory_pool;
+    bool                    use_threads;
+    bool                    sequence_output;
+    size_t                  max_queries;
+
+    // state for bounding admission
+    std::mutex              admit_mutex;
+    std::condition_variable admit_cv;
+    size_t                  active_queries { 0 };
+
+    // memory pools of queries, kept until their query and its allocations are released
+    std::mutex                          pool_mutex;
+    vector<shared_ptr<ProxyMemoryPool>> query_pools;
+
+    QueryContext( shared_ptr<ThreadPool> pool
+                 ,bool                   threads
+                 ,bool                   sequenced
+                 ,size_t                 query_limit);
+
+    QueryContext(): QueryContext(nullptr, true, false, default_max_queries) {}
+
+    static Result<shared_ptr<QueryContext>>
+    Make(int thread_count, size_t query_limit, bool sequenced = false);
+
+    Executor*                   QueryExecutor();
+    shared_ptr<ProxyMemoryPool> MemoryPoolForQuery();
+    QueryOptions                OptionsForQuery(MemoryPool *query_pool);
+    ComputeContext              ComputeContextForQuery(MemoryPool *query_pool);
+
+    void Admit();
+    void Release();
+  };
+
+  /**
+   * A RecordBatchReader over the output of a plan executed within a QueryContext.
+   *
+   * The reader owns the plan and the memory pool the plan allocates from, and holds the
+   * plan's admission until the plan's output is exhausted or the reader is closed. The
+   * plan's sink applies backpressure, and `backpressure_monitor` reports its state.
+   */
+  struct ContextPlanReader : public RecordBatchReader {
+    using BatchGenerator = std::function<
+      arrow::Future<std::optional<arrow::compute::ExecBatch>>()
+    >;
+
+    QueryContext                       *query_ctx;
+    shared_ptr<ProxyMemoryPool>         query_pool;
+    shared_ptr<ExecPlan>                exec_plan;
+    shared_ptr<Schema>                  output_schema;
+    BatchGenerator                      batch_gen;
+    arrow::acero::BackpressureMonitor  *backpressure_monitor;
+    bool                                is_started;
+    bool                                is_admitted;
+
+    ContextPlanReader(QueryContext *ctx)
+      :  query_ctx(ctx)
+        ,query_pool(ctx->MemoryPoolForQuery())
+        ,backpressure_monitor(nullptr)
+        ,is_started(false)
+        ,is_admitted(true) {}
+    ~ContextPlanReader() override;
+
+    shared_ptr<Schema> schema() const override;
+    Status             ReadNext(shared_ptr<RecordBatch> *batch) override;
+    Status             Close() override;
+  };
+
+} // namespace: mohair::adapters
+
+
+// ------------------------------
+// Functions
+
+namespace mohair::adapters {
+
+  // >> Convenience functions for executing Acero plans
+  Result<shared_ptr<Table>>             ExecutePlan(PlanInfo &acero_plan);
+  Result<unique_ptr<RecordBatchReader>> StreamPlan(PlanInfo &acero_plan);
+
+  // >> Variants that execute within a QueryContext
+  Result<shared_ptr<Table>>
+  ExecutePlan(PlanInfo &acero_plan, QueryContext &query_ctx);
+
+  Result<unique_ptr<RecordBatchReader>>
+  StreamPlan(PlanInfo &acero_plan, QueryContext &query_ctx);
+
+  // >> Convenience functions for translating plans
+  Status BindNamedTables(Declaration &plan_decl, const NamedTableProvider &provider);
+
+  // >> Convenience functions for consuming streamed results
+  Result<shared_ptr<Table>> NextChunk(RecordBatchReader *reader, int64_t chunk_size);
+
+} // namespace: mohair::adapters
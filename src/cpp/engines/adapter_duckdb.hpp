@@ -0,0 +1,182 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+#pragma once
+
+//  >> Configuration-based macros
+#include "../mohair-config.hpp"
+
+//  >> Internal libs
+#include "../mohair.hpp"
+#include "adapter_acero.hpp"
+
+//  >> Standard libs
+#include <unordered_map>
+
+//  >> DuckDB deps (only if duckdb is enabled)
+#if USE_DUCKDB
+  #include "duckdb.hpp"
+  #include "duckdb/common/arrow/arrow_wrapper.hpp"
+  #include "duckdb/common/arrow/result_arrow_wrapper.hpp"
+  #include "duckdb/function/table/arrow.hpp"
+
+  //    |> Arrow C data interface
+  #include <arrow/c/bridge.h>
+#endif
+
+
+// ------------------------------
+// Classes and Functions (independent of DuckDB)
+
+namespace mohair::adapters {
+
+  // Engines that can execute a (sub)plan
+  enum class ExecEngine : uint8_t { Acero, DuckDB };
+
+  ExecEngine EngineForPlan(Plan &plan_msg);
+
+} // namespace: mohair::adapters
+
+
+#if USE_DUCKDB
+
+  // ------------------------------
+  // Type Aliases
+
+  // >> DuckDB types
+  using duckdb::DuckDB;
+  using duckdb::Connection;
+  using duckdb::QueryResult;
+  using duckdb::ArrowArrayStreamWrapper;
+  using duckdb::ArrowStreamParameters;
+
+  using DuckValue = duckdb::Value;
+
+
+  // ------------------------------
+  // Classes
+
+  namespace mohair::adapters {
+
+    // Sources of a plan's input tables, keyed by the (single-part) name the plan reads
+    using ArrowSourceMap = std::unordered_map<string, Declaration>;
+
+    // DuckDB table function that translates and executes a substrait plan
+    const string duckdb_substrait_fn { "from_substrait" };
+
+    // DuckDB table function that scans an Arrow stream without pushing down projections
+    // or filters (DuckDB applies them itself)
+    const string duckdb_arrow_scan_fn { "arrow_scan_dumb" };
+
+    // First part of the names that the named tables of a plan are rewritten to
+    const string duckdb_input_prefix { "mohair_input_" };
+
+    /**
+     * An Arrow source (a Declaration from a NamedTableProvider) that DuckDB scans via its
+     * "arrow_scan_dumb" table function.
+     *
+     * DuckDB calls `Produce` for a stream over the source (once per scan) and `GetSchema`
+     * for the source's schema, each with a pointer to this struct. Each scan executes the
+     * source declaration and pulls its batches as DuckDB consumes them, through the Arrow
+     * C data interface, so inputs are neither materialized nor copied.
+     */
+    struct DuckArrowTable {
+      Declaration        source_decl;
+      shared_ptr<Schema> source_schema;
+      QueryOptions       scan_opts;
+
+      DuckArrowTable(Declaration decl, shared_ptr<Schema> schema, QueryOptions opts)
+        : source_decl(std::move(decl)), source_schema(std::move(schema)), scan_opts(opts) {}
+
+      static duckdb::unique_ptr<ArrowArrayStreamWrapper>
+      Produce(uintptr_t factory_ptr, ArrowStreamParameters &scan_params);
+
+      static void GetSchema(ArrowArrayStream *factory_ptr, ArrowSchema &schema);
+    };
+
+    /**
+     * A RecordBatchReader over the result of a plan executed by DuckDB.
+     *
+     * The reader owns the connection the plan ran on, the input tables registered on it
+     * and the memory pool that scans of the input tables allocate from. Members are
+     * released in reverse order, so the result is released first. Like a
+     * ContextPlanReader, the reader holds the plan's admission (to `query_ctx`) until the
+     * result is exhausted or the reader is closed.
+     */
+    struct DuckResultReader : public RecordBatchReader {
+      QueryContext                      *query_ctx;
+      bool                               is_admitted;
+      shared_ptr<ProxyMemoryPool>        query_pool;
+      unique_ptr<Connection>             duck_conn;
+      vector<unique_ptr<DuckArrowTable>> input_tables;
+      shared_ptr<Schema>                 output_schema;
+      shared_ptr<RecordBatchReader>      result_batches;
+
+      DuckResultReader(QueryContext *ctx, unique_ptr<Connection> conn)
+        :  query_ctx(ctx)
+          ,is_admitted(true)
+          ,query_pool(ctx->MemoryPoolForQuery())
+          ,duck_conn(std::move(conn)) {}
+      ~DuckResultReader() override;
+
+      shared_ptr<Schema> schema() const override;
+      Status             ReadNext(shared_ptr<RecordBatch> *batch) override;
+      Status             Close() override;
+    };
+
+    /**
+     * An in-memory DuckDB database that executes substrait (sub)plans over Arrow sources.
+     *
+     * Each plan runs on its own connection, where its input sources are registered as
+     * temporary views, so concurrent plans never see each other's tables. Plans are
+     * admitted by a QueryContext, like plans that Acero executes. Results are produced in
+     * batches of at most `batch_size` rows.
+     */
+    struct DuckEngine {
+      unique_ptr<DuckDB> duck_db;
+      int64_t            batch_size;
+
+      DuckEngine(unique_ptr<DuckDB> db, int64_t bsize)
+        : duck_db(std::move(db)), batch_size(bsize) {}
+
+      static Result<shared_ptr<DuckEngine>>
+      Make(int thread_count = 0, int64_t batch_size = default_batch_size);
+
+      Result<shared_ptr<DuckResultReader>>
+      StreamSubstrait( const string         &plan_msg
+                      ,const ArrowSourceMap &input_sources
+                      ,QueryContext         &query_ctx);
+
+      Status ExportSubstrait( const string         &plan_msg
+                             ,const ArrowSourceMap &input_sources
+                             ,QueryContext         &query_ctx
+                             ,ArrowArrayStream     *out_stream);
+
+      Result<shared_ptr<Table>>
+      ExecuteSubstrait( const string         &plan_msg
+                       ,const ArrowSourceMap &input_sources
+                       ,QueryContext         &query_ctx);
+    };
+
+    Result<ArrowSourceMap> InputSourcesFor(Plan &plan_msg, const NamedTableProvider &provider);
+
+  } // namespace: mohair::adapters
+
+#endif // essentially an include guard that uses USE_DUCKDB
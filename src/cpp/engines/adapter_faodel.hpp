@@ -15,6 +15,16 @@
 
 //  >> Standard libs
 #include <map>
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <condition_variable>
+
+//  >> Arrow deps
+#include <arrow/compute/api.h>
 
 //    |> Core faodel and MPI interface
 #include "faodel/faodel-services/MPISyncStart.hh"
@@ -48,6 +58,13 @@ using KelpPool = kelpie::Pool;
 
 // >> Arrow types
 using arrow::Table;
+using arrow::TableBatchReader;
+using arrow::io::BufferReader;
+using arrow::ipc::IpcReadOptions;
+using arrow::ipc::RecordBatchStreamReader;
+
+// >> Acero types
+using arrow::acero::RecordBatchReaderSourceNodeOptions;
 
 
 // ------------------------------
@@ -58,17 +75,335 @@ namespace mohair::adapters {
   const string default_pool_name { "/myplace" };
   string DefaultFaodelConfig(const string &pool_name);
 
+  // Configuration keys for the query context of compute functions (see `QueryContext`)
+  const string query_threads_key { "mohair.query_threads" };
+  const string query_limit_key   { "mohair.max_queries"   };
+
+  shared_ptr<QueryContext> QueryContextForConfig(const string &faodel_config);
+
   void InitializeMPI(int argc, char **argv, int *provided, int *rank, int *size);
   void BootstrapServices(string &faodel_config);
   void PrintStringObj(const string print_msg, const string string_obj);
 
+  // Default number of chunks that a FadoBatchReader extracts ahead of the chunk it reads
+  constexpr size_t default_chunk_prefetch = 4;
+
+  // Default number of keys that a scatter executes concurrently
+  constexpr size_t default_scatter_threads = 8;
+
+  // Default number of batches that a scatter's workers queue ahead of its reader
+  constexpr size_t default_scatter_queue_batches = 16;
+
+  // Default number of subplan results that an adapter keeps in its result cache
+  constexpr size_t default_result_cache_limit = 64;
+
+  // Schema metadata key that marks the last chunk of a streamed result
+  const string stream_end_key { "mohair.stream_end" };
+
+  /**
+   * The zone maps of the objects that a FadoBatchReader reads (one per object, or null if
+   * an object has none) and the predicates that each chunk is tested against. A reader
+   * finds the zone maps itself (see `ZoneMapForFado`), so only predicates are given.
+   */
+  struct ZoneFilter {
+    vector<shared_ptr<Table>> zone_maps;
+    vector<ZonePredicate>     zone_preds;
+
+    bool ChunkMayMatch(size_t fado_ndx, int chunk_ndx, int chunk_count) const;
+  };
+
   // Functions to support interfacing with Acero and other execution engines
-  NamedTableProvider ProviderForFadoMap(map<KelpKey, LunaDO> &fado_map);
-  FaoStatus ExecuteSubstrait(        FaoBucket       b
-                              ,const KelpKey         k
-                              ,const string         &args
-                              ,map<KelpKey, LunaDO>  fado_map
-                              ,LunaDO               *ext_ldo);
+  Result<Declaration> SourceForFados( const vector<LunaDO> &ldos
+                                     ,const string         &tname
+                                     ,int64_t               batch_size
+                                     ,const vector<string> &column_names = {}
+                                     ,const ZoneFilter     &zone_filter  = {}
+                                     ,Executor             *executor     = nullptr);
+
+  Result<Declaration> SourceForFado( const LunaDO         &ldo
+                                    ,const string         &tname
+                                    ,int64_t               batch_size
+                                    ,const vector<string> &column_names = {}
+                                    ,const ZoneFilter     &zone_filter  = {}
+                                    ,Executor             *executor     = nullptr);
+
+  // Functions to support zone maps (per-chunk statistics, see `PublishTable`)
+  shared_ptr<Table> ZoneMapForFado(const LunaDO &ldo);
+  int               ChunkCountForFado(ArrowDO &fado, const shared_ptr<Table> &zone_map);
+
+  Result<shared_ptr<Table>>
+  ReadFadoChunk(ArrowDO &fado, int table_ndx, const vector<string> &column_names);
+
+  // Functions to support Skytether reads (see `SliceRequest`)
+  KelpKey         SliceKeyFor(const SliceRequest &request, uint32_t slice_id);
+  KelpKey         PartitionSchemaKeyFor(const SliceRequest &request);
+  KelpKey         PartitionKeyFor(const SliceRequest &request);
+
+  Result<Declaration> SourceForPartitionSchema(const LunaDO &ldo);
+
+  Result<Declaration> SourceForSlices( const vector<string> &tname
+                                      ,map<KelpKey, LunaDO> &fado_map
+                                      ,int64_t               batch_size
+                                      ,const vector<string> &column_names = {}
+                                      ,Executor             *executor     = nullptr);
+
+  // Functions to route subplans to the keys that hold their data
+  KelpKey                 KeyForTableName(const vector<string> &tname);
+  string                  TableNameForKey(const KelpKey &kkey);
+  Result<KelpKey>         KeyForSubplan(Plan &plan_msg);
+  Result<vector<KelpKey>> KeysForBranches(const vector<string> &subplan_msgs);
+
+  NamedTableProvider ProviderForFadoMap( map<KelpKey, LunaDO> &fado_map
+                                        ,int64_t               batch_size = default_batch_size
+                                        ,const KelpKey        &shard_key  = KelpKey {}
+                                        ,Executor             *executor   = nullptr);
+
+  NamedTableProvider ProviderForKelpPool( KelpPool &kpool
+                                         ,int64_t   batch_size = default_batch_size
+                                         ,Executor *executor   = nullptr);
+
+  // Functions to gather statistics for estimating plan costs
+  Result<TableStats> StatsForFado(const LunaDO &ldo);
+  StatsMap           StatsForFadoMap(map<KelpKey, LunaDO> &fado_map);
+
+  Result<PlanInfo> AceroPlanForFadoMap( const string          &plan_msg
+                                       ,map<KelpKey, LunaDO>  &fado_map
+                                       ,int64_t                batch_size
+                                       ,const KelpKey         &shard_key = KelpKey {}
+                                       ,Executor              *executor  = nullptr);
+
+  FaoStatus ExecuteSubstrait(        QueryContext         &query_ctx
+                              ,      FaoBucket             b
+                              ,const KelpKey               k
+                              ,const string               &args
+                              ,map<KelpKey, LunaDO>        fado_map
+                              ,LunaDO                     *ext_ldo);
+
+  // Functions to support streamed results (see `ExecuteSubstraitStream`)
+  KelpKey StreamChunkKeyFor(const string &stream_row, int64_t chunk_ndx);
+  bool    IsLastStreamChunk(const Table &chunk_table);
+
+  Result<int64_t> PublishStream( KelpPool          &kpool
+                                ,const string      &stream_row
+                                ,RecordBatchReader *reader
+                                ,int64_t            chunk_size);
+
+  FaoStatus ExecuteSubstraitStream(       QueryContext   &query_ctx
+                                   ,const StreamOptions  &stream_opts
+                                   ,      KelpPool       &kpool
+                                   ,      FaoBucket       b
+                                   ,const KelpKey         k
+                                   ,const string         &args
+                                   ,map<KelpKey, LunaDO>  fado_map
+                                   ,LunaDO               *ext_ldo);
+
+  /**
+   * A RecordBatchReader over the tables (chunks) of one or more faodel arrow data objects
+   * (e.g. the slices of a partition), read in order. An object's zone map is not a chunk.
+   *
+   * Chunks are extracted one at a time as batches are read, and each batch references the
+   * extracted chunk, so the data objects are never concatenated into a single table. If
+   * `column_names` is not empty, only those columns of each chunk are decoded (see
+   * `ReadFadoChunk`), in that order.
+   * Chunks that `zone_filter` rules out are skipped without being extracted.
+   *
+   * Extracting a chunk decodes (and decompresses) it, so up to `prefetch_count` chunks
+   * are extracted ahead of the reader, concurrently, on `executor`: the executor of the
+   * query that reads them, or Arrow's CPU pool if the reader is given none.
+   */
+  struct FadoBatchReader : public RecordBatchReader {
+    using ChunkFuture = arrow::Future<shared_ptr<Table>>;
+
+    vector<ArrowDO>              fados;
+    size_t                       fado_ndx;
+    int                          chunk_count;
+    int                          chunk_ndx;
+    int64_t                      batch_size;
+    shared_ptr<Schema>           chunk_schema;
+    shared_ptr<Table>            chunk_table;
+    unique_ptr<TableBatchReader> chunk_reader;
+    vector<string>               column_names;
+    ZoneFilter                   zone_filter;
+    size_t                       prefetch_count;
+    std::deque<ChunkFuture>      prefetched_chunks;
+    Executor                    *executor;
+
+    FadoBatchReader( const vector<LunaDO> &ldos
+                    ,int64_t               bsize
+                    ,const vector<string> &cnames
+                    ,const ZoneFilter     &zfilter = {}
+                    ,Executor             *exec    = nullptr);
+    FadoBatchReader(const LunaDO &ldo, int64_t bsize);
+
+    static Result<shared_ptr<FadoBatchReader>>
+    Make( const vector<LunaDO> &ldos
+         ,int64_t               batch_size
+         ,const vector<string> &column_names = {}
+         ,const ZoneFilter     &zone_filter  = {}
+         ,Executor             *executor     = nullptr);
+
+    static Result<shared_ptr<FadoBatchReader>> Make(const LunaDO &ldo, int64_t batch_size);
+
+    int                ChunkCountFor(size_t fado_pos);
+    bool               HasNextChunk();
+    bool               HasPendingChunk();
+    void               PrefetchChunks();
+    Status             OpenNextChunk();
+    shared_ptr<Schema> schema() const override;
+    Status             ReadNext(shared_ptr<RecordBatch> *batch) override;
+  };
+
+  /**
+   * Wakes a reader of a streamed result (see `ResultChunkReader`) when a chunk it wants is
+   * published (see `Pool::Want`), or when the compute function producing the result
+   * returns. Shared with callbacks, so that it outlives any that never fire.
+   */
+  struct StreamSignal {
+    std::mutex              signal_mutex;
+    std::condition_variable signal;
+    map<int64_t, LunaDO>    ready_chunks;
+    bool                    is_computed;
+    FaoStatus               compute_status;
+
+    StreamSignal(): is_computed(false), compute_status(kelpie::KELPIE_OK) {}
+  };
+
+  /**
+   * A RecordBatchReader over a result published as chunks under `chunk_row` (see
+   * `StreamChunkKeyFor`), read in order. Each chunk is an object of one or more tables
+   * and is only read once the chunk before it is exhausted, so the result is never
+   * collected into a single table. The last chunk is chunk `chunk_count - 1` or, if the
+   * count is unknown (-1), the chunk marked by `IsLastStreamChunk`.
+   *
+   * A result that is being streamed (`stream_signal` is set) is read while the compute
+   * function producing it runs on `compute_thread`: the reader waits for each chunk to be
+   * published, or for the compute function to return without it. Chunks given to the
+   * reader (`held_chunks`) are read before any chunk in the pool.
+   *
+   * The reader closes when the result is exhausted, fails or is destroyed. Closing waits
+   * for the compute function, then calls `on_close` with the reader, which tells whether
+   * the whole result was read (`is_complete`) and in how many chunks (`chunk_ndx`).
+   * Unless `on_close` returns true (the chunks were kept, e.g. by a result cache), the
+   * chunks of a streamed result are dropped.
+   */
+  struct ResultChunkReader : public RecordBatchReader {
+    using CloseFn = std::function<bool(const ResultChunkReader &closed_reader)>;
+
+    KelpPool                     kpool;
+    string                       chunk_row;
+    int64_t                      chunk_count;
+    int64_t                      chunk_ndx;
+    std::deque<LunaDO>           held_chunks;
+    unique_ptr<ArrowDO>          chunk_fado;
+    int                          table_ndx;
+    shared_ptr<Table>            chunk_table;
+    unique_ptr<TableBatchReader> table_reader;
+    shared_ptr<Schema>           result_schema;
+    int64_t                      batch_size;
+    bool                         is_complete;
+    bool                         is_closed;
+    shared_ptr<StreamSignal>     stream_signal;
+    std::thread                  compute_thread;
+    CloseFn                      on_close;
+
+    ResultChunkReader( const KelpPool &pool
+                      ,const string   &row
+                      ,int64_t         count
+                      ,int64_t         bsize
+                      ,CloseFn         close_fn = nullptr);
+    ~ResultChunkReader() override;
+
+    Result<LunaDO>     NextChunk();
+    Result<bool>       OpenNextTable();
+    Status             Open();
+    shared_ptr<Schema> schema() const override;
+    Status             ReadNext(shared_ptr<RecordBatch> *batch) override;
+    Status             Close() override;
+  };
+
+  struct Faodel;
+
+  /**
+   * A RecordBatchReader over the results of plans executed against many keys (see
+   * `Faodel::ScatterEngineAcero`). Batches are emitted in the order that they are
+   * produced, so partial results are never gathered into a table.
+   *
+   * Each worker takes the next unexecuted key until none remain and queues the batches
+   * of that key's result (see `Faodel::ExecuteEngineAcero`). At most `max_queued` batches
+   * are queued, so workers wait for the reader instead of outpacing it. The first error
+   * of any worker is returned by `ReadNext`. Once the reader is closed, workers stop
+   * after the key they are executing. The reader must not outlive `faodel_if`.
+   */
+  struct ScatterBatchReader : public RecordBatchReader {
+    Faodel                             *faodel_if;
+    KelpPool                            kpool;
+    vector<KelpKey>                     kkeys;
+    vector<shared_ptr<Buffer>>          plan_msgs;
+    std::atomic<size_t>                 next_key_ndx;
+    size_t                              max_queued;
+
+    // state shared with workers
+    std::mutex                          queue_mutex;
+    std::condition_variable             queue_signal;
+    std::deque<shared_ptr<RecordBatch>> batch_queue;
+    shared_ptr<Schema>                  result_schema;
+    Status                              scatter_status;
+    size_t                              finished_workers;
+    std::atomic<bool>                   is_cancelled;
+
+    vector<std::thread>                 workers;
+    bool                                is_closed;
+
+    ScatterBatchReader( Faodel                           *adapter
+                       ,const KelpPool                   &pool
+                       ,const vector<KelpKey>            &keys
+                       ,const vector<shared_ptr<Buffer>> &plans
+                       ,size_t                            queue_limit);
+    ~ScatterBatchReader() override;
+
+    static Result<shared_ptr<ScatterBatchReader>>
+    Make( Faodel                           *adapter
+         ,const KelpPool                   &pool
+         ,const vector<KelpKey>            &keys
+         ,const vector<shared_ptr<Buffer>> &plans
+         ,size_t                            worker_count
+         ,size_t                            queue_limit = default_scatter_queue_batches);
+
+    void               ExecuteKeys();
+    bool               QueueBatch(shared_ptr<RecordBatch> batch);
+    shared_ptr<Schema> schema() const override;
+    Status             ReadNext(shared_ptr<RecordBatch> *batch) override;
+    Status             Close() override;
+  };
+
+  /** Bytes of the tables published under a key, before (raw) and after compression. */
+  struct PublishStats {
+    arrow::Compression::type codec;
+    int64_t                  raw_bytes;
+    int64_t                  stored_bytes;
+
+    double CompressionRatio() const;
+  };
+
+  /**
+   * A subplan result in a result cache (see `Faodel::CacheResult`), computed from
+   * `source_key` for exactly `canonical_plan` and published as `chunk_count` chunks under
+   * `chunk_row` (see `ResultChunkReader`).
+   *
+   * A result is not dropped from the pool while it is being served (`reader_count` is not
+   * 0). If it is invalidated or evicted in the meantime, it is marked stale and is no
+   * longer served; its last reader drops it instead.
+   */
+  struct CachedResult {
+    KelpKey source_key;
+    string  canonical_plan;
+    string  chunk_row;
+    int64_t chunk_count;
+    size_t  reader_count;
+    bool    is_stale;
+
+    vector<KelpKey> ChunkKeys() const;
+  };
 
   struct Faodel {
     // state for managing faodel
@@ -76,6 +411,35 @@ namespace mohair::adapters {
     string               pool_name;
     map<KelpKey, LunaDO> fado_map;
 
+    // rows per chunk (and per zone map entry) of published tables
+    int64_t publish_chunk_rows;
+
+    // codec policy for published tables: a default for the pool and overrides by row (K1)
+    arrow::Compression::type              publish_codec;
+    map<string, arrow::Compression::type> table_codecs;
+
+    // bytes of each published table (keyed by the table's key string)
+    std::mutex                publish_mutex;
+    map<string, PublishStats> publish_stats;
+
+    // keys executed concurrently by a scatter (see `ScatterEngineAcero`)
+    size_t scatter_threads;
+
+    // state for managing execution (streaming is used if `use_streaming` is true)
+    bool                     use_streaming;
+    StreamOptions            stream_opts;
+    shared_ptr<QueryContext> query_ctx;
+    std::atomic<uint64_t>    stream_count;
+
+    // state for caching subplan results (keyed by result key). At most
+    // `max_cached_results` results are kept; the oldest (`result_order`) are evicted first
+    bool                       use_result_cache;
+    size_t                     max_cached_results;
+    std::mutex                 result_mutex;
+    map<KelpKey, uint64_t>     table_versions;
+    map<KelpKey, CachedResult> cached_results;
+    std::deque<KelpKey>        result_order;
+
     // state for managing MPI
     bool initialized;
     int  provided;
@@ -91,12 +455,88 @@ namespace mohair::adapters {
     void     RegisterEngineAcero();
     KelpPool ConnectToPool();
 
-    void
+    arrow::Compression::type  CodecFor(const KelpKey &kkey);
+    map<string, PublishStats> PublishedStats();
+
+    Status
     PublishTable(const shared_ptr<Table> &data, KelpPool &kpool, KelpKey &kkey);
 
-    Result<shared_ptr<Table>>
+    Status
+    PublishTable( const shared_ptr<Table> &data
+                 ,KelpPool                &kpool
+                 ,const vector<string>    &tname);
+
+    Result<uint32_t>
+    PublishSlices( const shared_ptr<Table> &data
+                  ,KelpPool                &kpool
+                  ,const string            &domain
+                  ,const string            &partition
+                  ,int64_t                  slice_rows);
+
+    string NextStreamRow();
+
+    Result<shared_ptr<RecordBatchReader>>
     ExecuteEngineAcero(KelpPool &kpool, KelpKey &kkey, const shared_ptr<Buffer> &plan_msg);
 
+    Result<shared_ptr<RecordBatchReader>>
+    StreamEngineAcero( KelpPool                   &kpool
+                      ,KelpKey                    &kkey
+                      ,const shared_ptr<Buffer>   &plan_msg
+                      ,ResultChunkReader::CloseFn  on_close = nullptr);
+
+    Result<shared_ptr<RecordBatchReader>>
+    ExecuteSubplan(KelpPool &kpool, const shared_ptr<Buffer> &plan_msg);
+
+    // Functions for executing a plan against many keys (scatter/gather)
+    Result<vector<KelpKey>> KeysForPattern(KelpPool &kpool, const KelpKey &key_pattern);
+
+    Result<shared_ptr<RecordBatchReader>>
+    ScatterEngineAcero( KelpPool                         &kpool
+                       ,const vector<KelpKey>            &kkeys
+                       ,const vector<shared_ptr<Buffer>> &plan_msgs);
+
+    Result<shared_ptr<RecordBatchReader>>
+    ScatterEngineAcero( KelpPool                 &kpool
+                       ,const vector<KelpKey>    &kkeys
+                       ,const shared_ptr<Buffer> &plan_msg);
+
+    Result<shared_ptr<RecordBatchReader>>
+    ScatterEngineAcero( KelpPool                 &kpool
+                       ,const KelpKey            &key_pattern
+                       ,const shared_ptr<Buffer> &plan_msg);
+
+    // Functions for caching subplan results
+    Result<string> CanonicalPlanFor(const Buffer &plan_msg);
+    uint64_t       TableVersionFor(const KelpKey &kkey);
+
+    KelpKey ResultKeyFor( const KelpKey &kkey
+                         ,const string  &canonical_plan
+                         ,uint64_t       table_version);
+
+    Result<CachedResult> AcquireCachedResult( KelpPool      &kpool
+                                             ,const KelpKey &kkey
+                                             ,const KelpKey &result_key
+                                             ,const string  &canonical_plan);
+
+    void ReleaseCachedResult(KelpPool &kpool, const KelpKey &result_key);
+
+    Result<shared_ptr<RecordBatchReader>>
+    ReadCachedResult( KelpPool      &kpool
+                     ,const KelpKey &kkey
+                     ,const KelpKey &result_key
+                     ,const string  &canonical_plan);
+
+    bool CacheResult( KelpPool      &kpool
+                     ,const KelpKey &kkey
+                     ,const KelpKey &result_key
+                     ,const string  &canonical_plan
+                     ,uint64_t       table_version
+                     ,const string  &chunk_row
+                     ,int64_t        chunk_count);
+
+    void InvalidateResults(KelpPool &kpool, const KelpKey &kkey);
+    void RetireResult(const KelpKey &result_key, vector<KelpKey> *drop_keys);
+
     // Functions for MPI integration
     void Bootstrap(int argc, char **argv);
     void BootstrapWithKelpie(int argc, char **argv);
@@ -0,0 +1,164 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+#pragma once
+
+//  >> Internal libs
+#include "../mohair.hpp"
+#include "adapter_acero.hpp"
+
+//  >> Dataset deps
+#include <arrow/dataset/api.h>
+#include <arrow/dataset/file_parquet.h>
+#include <arrow/dataset/plan.h>
+
+//  >> Parquet deps
+#include <parquet/properties.h>
+
+
+// ------------------------------
+// Type aliases
+
+//  >> Acero types
+using arrow::acero::RecordBatchReaderSourceNodeOptions;
+
+//  >> Dataset types
+using arrow::dataset::FileFormat;
+using arrow::dataset::FileSystemDatasetFactory;
+using arrow::dataset::FileSystemFactoryOptions;
+using arrow::dataset::IpcFileFormat;
+using arrow::dataset::ParquetFileFormat;
+using arrow::dataset::ParquetFragmentScanOptions;
+using arrow::dataset::ScannerBuilder;
+
+//  >> Compute types
+using arrow::compute::Expression;
+
+//  >> Arrow filesystem types
+using arrow::fs::FileSystem;
+using arrow::fs::FileSelector;
+
+
+// ------------------------------
+// Classes
+
+namespace mohair::adapters {
+
+  // Default number of files (fragments) of a dataset that are read concurrently
+  constexpr int default_fragment_readahead = 4;
+
+  // Default number of batches that are read ahead of a source (per file)
+  constexpr int default_batch_readahead = 4;
+
+  // Extensions of Arrow IPC (Feather V2) files, in the order they are tried
+  const vector<string> ipc_file_extensions { ".arrow", ".feather", ".ipc" };
+
+  // Extensions of Parquet files, in the order they are tried (after IPC extensions)
+  const vector<string> parquet_file_extensions { ".parquet", ".pq" };
+
+  // Formats of files that serve a named table
+  enum class TableFormat : uint8_t { IPC, Parquet };
+
+  /**
+   * Options for scanning files that serve a named table.
+   *
+   * The batch size bounds the rows per batch produced by a dataset scan (a single IPC
+   * file produces batches as they were written). Fragment readahead is how many files of
+   * a directory are read concurrently and batch readahead is how many batches are read
+   * ahead of the consumer.
+   *
+   * For Parquet, column chunks of each row group are pre-buffered: nearby byte ranges are
+   * coalesced (per `cache_options`) into large reads that are issued concurrently.
+   */
+  struct FileScanOptions {
+    int64_t                  batch_size;
+    int                      fragment_readahead;
+    int                      batch_readahead;
+    bool                     pre_buffer    { true };
+    arrow::io::CacheOptions  cache_options { arrow::io::CacheOptions::Defaults() };
+
+    FileScanOptions(int64_t bsize, int fragments, int batches)
+      : batch_size(bsize), fragment_readahead(fragments), batch_readahead(batches) {}
+
+    FileScanOptions()
+      : FileScanOptions(default_batch_size, default_fragment_readahead, default_batch_readahead) {}
+  };
+
+  /**
+   * The files that serve a named table: a single file, or every file of one format under
+   * a directory (recursively). Paths are relative to `file_system`.
+   */
+  struct FileTable {
+    shared_ptr<FileSystem> file_system;
+    vector<string>         file_paths;
+    TableFormat            file_format;
+    bool                   is_directory;
+
+    bool IsLocal() const { return file_system->type_name() == "local"; }
+  };
+
+} // namespace: mohair::adapters
+
+
+// ------------------------------
+// Functions
+
+namespace mohair::adapters {
+
+  // Functions to resolve named tables to files
+  Result<shared_ptr<FileSystem>> FileSystemForRoot(const string &root_uri, string *root_path);
+  bool                           IsIPCFilePath(const string &file_path);
+  bool                           IsParquetFilePath(const string &file_path);
+
+  Result<FileTable> FileTableFor( const shared_ptr<FileSystem> &file_system
+                                 ,const string                 &root_path
+                                 ,const vector<string>         &tname);
+
+  // Functions to push filters into dataset scans
+  Expression FilterForZonePredicates( const vector<ZonePredicate> &zone_preds
+                                     ,const Schema                &dataset_schema);
+
+  // Functions that produce source Declarations for files
+  Result<Declaration> SourceForIPCFile( const FileTable       &file_table
+                                       ,const string          &tname
+                                       ,const FileScanOptions &scan_opts
+                                       ,const vector<string>  &column_names = {});
+
+  Result<Declaration> SourceForIPCDataset( const FileTable       &file_table
+                                          ,const string          &tname
+                                          ,const FileScanOptions &scan_opts
+                                          ,const vector<string>  &column_names = {});
+
+  Result<Declaration> SourceForParquetDataset( const FileTable             &file_table
+                                              ,const string                &tname
+                                              ,const FileScanOptions       &scan_opts
+                                              ,const vector<string>        &column_names = {}
+                                              ,const vector<ZonePredicate> &zone_preds   = {});
+
+  Result<Declaration> SourceForFileTable( const FileTable             &file_table
+                                         ,const string                &tname
+                                         ,const FileScanOptions       &scan_opts
+                                         ,const vector<string>        &column_names = {}
+                                         ,const vector<ZonePredicate> &zone_preds   = {});
+
+  NamedTableProvider ProviderForDirectory( const string          &root_uri
+                                          ,const FileScanOptions &scan_opts = {});
+
+} // namespace: mohair::adapters
@@ -0,0 +1,354 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "adapter_duckdb.hpp"
+
+
+// ------------------------------
+// Functions (independent of DuckDB)
+
+namespace mohair::adapters {
+
+  /**
+   * Returns the engine expected to execute `plan_msg` fastest. DuckDB's hash aggregation
+   * outperforms Acero's, so plans that group by any expression are given to DuckDB (if
+   * it is enabled) and other plans are given to Acero.
+   */
+  ExecEngine EngineForPlan([[maybe_unused]] Plan &plan_msg) {
+    #if USE_DUCKDB
+      if (mohair::GroupedAggregateCount(plan_msg) > 0) { return ExecEngine::DuckDB; }
+    #endif
+
+    return ExecEngine::Acero;
+  }
+
+} // namespace: mohair::adapters
+
+
+// >> Only define the engine if duckdb is enabled
+#if USE_DUCKDB
+
+  // ------------------------------
+  // Functions
+
+  namespace mohair::adapters {
+
+    // >> Internal functions only
+    namespace {
+
+      /** Converts an exception thrown by DuckDB to a Status. */
+      Status StatusFromDuckError(const std::exception &duck_err) {
+        return Status::ExecutionError("DuckDB error: ", duckdb::ErrorData(duck_err).Message());
+      }
+
+    } // anonymous namespace for internal functions
+
+
+    // >> Callbacks for DuckDB's arrow_scan_dumb
+
+    /**
+     * Returns a stream over the source for a scan. The source declaration is executed for
+     * each scan and batches are exported as the source produces them (no copies). DuckDB
+     * reports errors in callbacks via exceptions.
+     *
+     * Scans don't push projections or filters down (see `duckdb_arrow_scan_fn`); each
+     * source only produces the columns its read needs (see `InputSourcesFor`).
+     */
+    duckdb::unique_ptr<ArrowArrayStreamWrapper>
+    DuckArrowTable::Produce( uintptr_t                              factory_ptr
+                            ,[[maybe_unused]] ArrowStreamParameters &scan_params) {
+      auto arrow_table   = reinterpret_cast<DuckArrowTable*>(factory_ptr);
+      auto source_reader = arrow::acero::DeclarationToReader(
+        arrow_table->source_decl, arrow_table->scan_opts
+      );
+
+      if (not source_reader.ok()) { throw duckdb::IOException(source_reader.status().ToString()); }
+
+      auto stream_wrapper = duckdb::make_uniq<ArrowArrayStreamWrapper>();
+      auto export_status  = arrow::ExportRecordBatchReader(
+         shared_ptr<RecordBatchReader> { std::move(source_reader).ValueOrDie() }
+        ,&(stream_wrapper->arrow_array_stream)
+      );
+
+      if (not export_status.ok()) { throw duckdb::IOException(export_status.ToString()); }
+      return stream_wrapper;
+    }
+
+    /** Exports the schema of the source (DuckDB passes the source pointer as a stream). */
+    void DuckArrowTable::GetSchema(ArrowArrayStream *factory_ptr, ArrowSchema &schema) {
+      auto arrow_table   = reinterpret_cast<DuckArrowTable*>(factory_ptr);
+      auto export_status = arrow::ExportSchema(*(arrow_table->source_schema), &schema);
+
+      if (not export_status.ok()) { throw duckdb::IOException(export_status.ToString()); }
+    }
+
+
+    // >> Engine functions
+
+    /**
+     * Creates an in-memory DuckDB database that uses `thread_count` threads (DuckDB's
+     * default, if not positive) and loads the substrait extension (if it is not built in).
+     */
+    Result<shared_ptr<DuckEngine>> DuckEngine::Make(int thread_count, int64_t batch_size) {
+      duckdb::DBConfig duck_cfg;
+      if (thread_count > 0) { duck_cfg.options.maximum_threads = thread_count; }
+
+      try {
+        auto duck_db = std::make_unique<DuckDB>(nullptr, &duck_cfg);
+
+        Connection duck_conn { *duck_db };
+        auto load_result = duck_conn.Query("LOAD substrait");
+        if (load_result->HasError()) {
+          return Status::Invalid(
+            "Could not load DuckDB substrait extension: ", load_result->GetError()
+          );
+        }
+
+        return std::make_shared<DuckEngine>(std::move(duck_db), batch_size);
+      }
+
+      catch (const std::exception &duck_err) { return StatusFromDuckError(duck_err); }
+    }
+
+    /**
+     * Executes a serialized substrait plan within `query_ctx` and returns a reader over its
+     * result. This blocks until the context admits the plan.
+     *
+     * Each input source is registered (as a temporary view named by its key) on a new
+     * connection. Views scan the sources with "arrow_scan_dumb", so inputs are never
+     * copied into DuckDB. The plan runs as a pending query that allows a streaming result,
+     * so result chunks are produced as the reader pulls them. They are passed back through
+     * an Arrow C stream, so result batches are not copied either.
+     */
+    Result<shared_ptr<DuckResultReader>>
+    DuckEngine::StreamSubstrait( const string         &plan_msg
+                                ,const ArrowSourceMap &input_sources
+                                ,QueryContext         &query_ctx) {
+      query_ctx.Admit();
+
+      // the reader releases the admission if we return early
+      auto result_reader = std::make_shared<DuckResultReader>(&query_ctx, nullptr);
+
+      try {
+        result_reader->duck_conn = std::make_unique<Connection>(*duck_db);
+
+        for (const auto &[tname, source_decl] : input_sources) {
+          ARROW_ASSIGN_OR_RAISE(auto source_schema, arrow::acero::DeclarationToSchema(source_decl));
+
+          auto &arrow_table = result_reader->input_tables.emplace_back(
+            std::make_unique<DuckArrowTable>(
+               source_decl
+              ,std::move(source_schema)
+              ,query_ctx.OptionsForQuery(result_reader->query_pool.get())
+            )
+          );
+
+          duckdb::vector<DuckValue> scan_args {
+             DuckValue::POINTER(reinterpret_cast<uintptr_t>(arrow_table.get()))
+            ,DuckValue::POINTER(reinterpret_cast<uintptr_t>(&DuckArrowTable::Produce))
+            ,DuckValue::POINTER(reinterpret_cast<uintptr_t>(&DuckArrowTable::GetSchema))
+          };
+
+          result_reader->duck_conn->TableFunction(duckdb_arrow_scan_fn, scan_args)
+                                  ->CreateView(tname, true, true);
+        }
+
+        duckdb::vector<DuckValue> plan_args { DuckValue::BLOB_RAW(plan_msg) };
+        auto plan_rel = result_reader->duck_conn->TableFunction(duckdb_substrait_fn, plan_args);
+
+        auto pending_query = result_reader->duck_conn->context->PendingQuery(
+          plan_rel, /*allow_stream_result=*/true
+        );
+
+        if (pending_query->HasError()) {
+          return Status::ExecutionError(
+            "DuckDB could not prepare plan: ", pending_query->GetError()
+          );
+        }
+
+        auto query_result = pending_query->Execute();
+        if (query_result->HasError()) {
+          return Status::ExecutionError(
+            "DuckDB could not execute plan: ", query_result->GetError()
+          );
+        }
+
+        // the wrapper is owned by its C stream, which releases it (and the query result)
+        auto result_stream = new duckdb::ResultArrowArrayStreamWrapper(
+          std::move(query_result), batch_size
+        );
+
+        ARROW_ASSIGN_OR_RAISE(
+           result_reader->result_batches
+          ,arrow::ImportRecordBatchReader(&(result_stream->stream))
+        );
+        result_reader->output_schema = result_reader->result_batches->schema();
+
+        return result_reader;
+      }
+
+      catch (const std::exception &duck_err) { return StatusFromDuckError(duck_err); }
+    }
+
+    /**
+     * Like `StreamSubstrait`, but the result is exported to `out_stream` (an Arrow C
+     * stream), for consumers outside of this library.
+     */
+    Status DuckEngine::ExportSubstrait( const string         &plan_msg
+                                       ,const ArrowSourceMap &input_sources
+                                       ,QueryContext         &query_ctx
+                                       ,ArrowArrayStream     *out_stream) {
+      ARROW_ASSIGN_OR_RAISE(
+        auto result_reader, StreamSubstrait(plan_msg, input_sources, query_ctx)
+      );
+
+      return arrow::ExportRecordBatchReader(std::move(result_reader), out_stream);
+    }
+
+    /** Like `StreamSubstrait`, but the result is materialized as a Table. */
+    Result<shared_ptr<Table>>
+    DuckEngine::ExecuteSubstrait( const string         &plan_msg
+                                 ,const ArrowSourceMap &input_sources
+                                 ,QueryContext         &query_ctx) {
+      ARROW_ASSIGN_OR_RAISE(
+        auto result_reader, StreamSubstrait(plan_msg, input_sources, query_ctx)
+      );
+
+      return arrow::Table::FromRecordBatchReader(result_reader.get());
+    }
+
+
+    /**
+     * Returns a source, made by `provider`, for each named table that `plan_msg` reads.
+     *
+     * DuckDB resolves a named table by its first name only, so each read of `plan_msg` is
+     * rewritten to read a name of a single part (`duckdb_input_prefix` and an index), by
+     * which its source is keyed.
+     *
+     * Like plans that Acero executes (see `PlanCache::TemplateFor`), projections are pushed
+     * into reads first, so `provider` is given each read's projected schema, and filters
+     * on reads are given to `provider` as zone predicates. No source is executed until
+     * DuckDB scans it.
+     */
+    Result<ArrowSourceMap> InputSourcesFor(Plan &plan_msg, const NamedTableProvider &provider) {
+      mohair::PushReadProjections(plan_msg);
+      auto zone_preds = mohair::ZonePredicatesForReads(plan_msg);
+
+      ArrowSourceMap input_sources;
+      ExtensionSet   schema_ext_set;
+      vector<Rel*>   rel_stack;
+
+      for (auto &plan_rel : *(plan_msg.mutable_relations())) {
+        if (plan_rel.has_root()) {
+          rel_stack.push_back(plan_rel.mutable_root()->mutable_input());
+        }
+        else if (plan_rel.has_rel()) { rel_stack.push_back(plan_rel.mutable_rel()); }
+      }
+
+      while (not rel_stack.empty()) {
+        Rel* rel_msg = rel_stack.back();
+        rel_stack.pop_back();
+
+        for (size_t input_ndx = 0; input_ndx < mohair::RelInputCount(*rel_msg); ++input_ndx) {
+          rel_stack.push_back(mohair::RelInputAt(rel_msg, input_ndx));
+        }
+
+        if (not rel_msg->has_read() or not rel_msg->read().has_named_table()) { continue; }
+
+        auto           read_msg   = rel_msg->mutable_read();
+        const auto    &name_parts = read_msg->named_table().names();
+        vector<string> tname { name_parts.begin(), name_parts.end() };
+
+        // the read's (projected) schema, with the zone predicates of its table
+        ARROW_ASSIGN_OR_RAISE(
+           auto read_schema
+          ,arrow::engine::DeserializeSchema(
+             *Buffer::FromString(read_msg->base_schema().SerializeAsString()), schema_ext_set
+           )
+        );
+
+        auto table_preds = zone_preds.find(mohair::JoinStr(tname, "."));
+        if (table_preds != zone_preds.end()) {
+          auto read_meta = (
+              read_schema->metadata() == nullptr
+            ? std::make_shared<arrow::KeyValueMetadata>()
+            : read_schema->metadata()->Copy()
+          );
+
+          read_meta->Append(
+            mohair::zone_predicates_key, mohair::SerializeZonePredicates(table_preds->second)
+          );
+          read_schema = read_schema->WithMetadata(std::move(read_meta));
+        }
+
+        string source_name { duckdb_input_prefix + std::to_string(input_sources.size()) };
+        ARROW_ASSIGN_OR_RAISE(input_sources[source_name], provider(tname, *read_schema));
+
+        read_msg->mutable_named_table()->clear_names();
+        read_msg->mutable_named_table()->add_names(source_name);
+      }
+
+      return input_sources;
+    }
+
+
+    // >> DuckResultReader methods
+
+    DuckResultReader::~DuckResultReader() {
+      auto close_status = Close();
+      if (not close_status.ok()) {
+        mohair::PrintError("Error when closing DuckDB result:", close_status);
+      }
+    }
+
+    shared_ptr<Schema> DuckResultReader::schema() const { return output_schema; }
+
+    /** Emits the next batch of the result, closing the reader after the last one. */
+    Status DuckResultReader::ReadNext(shared_ptr<RecordBatch> *batch) {
+      *batch = nullptr;
+      if (result_batches == nullptr) { return Status::OK(); }
+
+      ARROW_RETURN_NOT_OK(result_batches->ReadNext(batch));
+      if (*batch == nullptr) { return Close(); }
+
+      return Status::OK();
+    }
+
+    /** Releases the result (if it is still open), then releases the plan's admission. */
+    Status DuckResultReader::Close() {
+      Status result_status;
+
+      if (result_batches != nullptr) {
+        result_status  = result_batches->Close();
+        result_batches = nullptr;
+      }
+
+      if (is_admitted) {
+        query_ctx->Release();
+        is_admitted = false;
+      }
+
+      return result_status;
+    }
+
+  } // namespace: mohair::adapters
+
+#endif // USE_DUCKDB
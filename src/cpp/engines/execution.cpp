@@ -9,6 +9,9 @@
 // ------------------------------
 // Dependencies
 
+// >> Configuration-based macros
+#include "../mohair-config.hpp"
+
 // >> Only define this source if faodel is enabled
 #if USE_FAODEL
   #include "adapter_faodel.hpp"
@@ -21,20 +24,6 @@
   
     // >> Convenience functions for interfacing with Acero
   
-    /**
-     * Executes an Acero plan (arrow::engine::PlanInfo) using arrow::acero::DeclarationToTable.
-     *
-     * DeclarationToTable takes a Declaration, then creates and executes an ExecPlan. There
-     * are async versions (with an async suffix) and the "ToTable" suffix indicates that the
-     * results are returned as an arrow::Table.
-     */
-    Result<shared_ptr<Table>> ExecutePlan(PlanInfo &acero_plan) {
-      QueryOptions default_planopts;
-      const Declaration &plan_root = acero_plan.root.declaration;
-  
-      return arrow::acero::DeclarationToTable(plan_root, std::move(default_planopts));
-    }
-  
     FaoStatus FaodelStatusFromArrowStatus(const Status arrow_status) {
       if (arrow_status.ok())              { return kelpie::KELPIE_OK;     }
       else if (arrow_status.IsInvalid())  { return kelpie::KELPIE_EINVAL; }
@@ -48,6 +37,197 @@
   
     // >> Functions for interfacing with execution engines from compute frameworks
   
+    /**
+     * Returns a Declaration for a source node that scans lunasa data objects, in order.
+     *
+     * The data objects are wrapped in a reader over their tables (chunks). Chunks are
+     * extracted lazily and their batches are passed along without copies. If
+     * `column_names` is not empty, only those columns are kept from each chunk, and chunks
+     * that `zone_filter` rules out are never extracted. Chunks are prefetched on `executor`
+     * (see `FadoBatchReader`).
+     */
+    Result<Declaration> SourceForFados( const vector<LunaDO> &ldos
+                                       ,const string         &tname
+                                       ,int64_t               batch_size
+                                       ,const vector<string> &column_names
+                                       ,const ZoneFilter     &zone_filter
+                                       ,Executor             *executor) {
+      ARROW_ASSIGN_OR_RAISE(
+         auto fado_reader
+        ,FadoBatchReader::Make(ldos, batch_size, column_names, zone_filter, executor)
+      );
+  
+      // the Declaration essentially represents the data source for a scan node
+      return Declaration(
+         "record_batch_reader_source"
+        ,RecordBatchReaderSourceNodeOptions { std::move(fado_reader) }
+        ,tname
+      );
+    }
+  
+    /** Returns a Declaration for a source node that scans a single lunasa data object. */
+    Result<Declaration> SourceForFado( const LunaDO         &ldo
+                                      ,const string         &tname
+                                      ,int64_t               batch_size
+                                      ,const vector<string> &column_names
+                                      ,const ZoneFilter     &zone_filter
+                                      ,Executor             *executor) {
+      return SourceForFados(
+        vector<LunaDO> { ldo }, tname, batch_size, column_names, zone_filter, executor
+      );
+    }
+
+    /**
+     * Returns the zone map of `ldo` (nullptr if it has none). A zone map is published as
+     * the last table of its object (see `PublishTable`), so an object and its zone map are
+     * always the same version. Only objects with more than one table can have a zone map.
+     */
+    shared_ptr<Table> ZoneMapForFado(const LunaDO &ldo) {
+      ArrowDO fado { ldo };
+      if (fado.NumberOfTables() < 2) { return nullptr; }
+
+      auto zone_map = fado.ExtractTable(fado.NumberOfTables() - 1);
+      if (not zone_map.ok()) {
+        mohair::PrintError("Unable to extract zone map:", zone_map.status());
+        return nullptr;
+      }
+
+      if (not mohair::IsZoneMap(**zone_map)) { return nullptr; }
+      return *zone_map;
+    }
+
+    /** Returns the number of data tables (chunks) of `fado`, given its zone map (if any). */
+    int ChunkCountForFado(ArrowDO &fado, const shared_ptr<Table> &zone_map) {
+      return fado.NumberOfTables() - (zone_map == nullptr ? 0 : 1);
+    }
+  
+    /**
+     * Returns the key of a slice of a Skytether partition.
+     *
+     * Slices of a partition share a row (K1), so kelpie places them on the same node, and
+     * each slice is its own column (K2) so that it can be retrieved without the others.
+     * The row is the partition's name, as in plans and statistics (see `SourceNameForSky`).
+     */
+    KelpKey SliceKeyFor(const SliceRequest &request, uint32_t slice_id) {
+      return KelpKey { request.PartitionName(), std::to_string(slice_id) };
+    }
+
+    /**
+     * Returns the key of a partition's schema: an empty table, published next to the
+     * slices (see `PublishSlices`), that resolves schema requests without reading slices.
+     */
+    KelpKey PartitionSchemaKeyFor(const SliceRequest &request) {
+      return KelpKey { request.PartitionName(), "schema" };
+    }
+  
+    /**
+     * Returns a key pattern that matches every slice of the requested partition. A plan
+     * computed against this pattern runs where the slices are, and `SourceForSlices`
+     * selects only the requested slices from the objects that are passed to it.
+     */
+    KelpKey PartitionKeyFor(const SliceRequest &request) {
+      return KelpKey { request.PartitionName(), "*" };
+    }
+
+    /**
+     * Returns the key of the object that serves a named table: the parts of the name,
+     * joined with ".", are the row (K1). For example, `["tpch", "lineitem"]` is the key
+     * `{"tpch.lineitem"}`. Tables are published, looked up, and routed to by this key.
+     */
+    KelpKey KeyForTableName(const vector<string> &tname) {
+      return KelpKey { mohair::JoinStr(tname, ".") };
+    }
+
+    /**
+     * Returns the key that a subplan is computed against, so that it runs where its data
+     * is: the partition of its SkyRel reads (see `PartitionKeyFor`) or else the key of its
+     * named table (see `KeyForTableName`). A subplan must read exactly one partition or
+     * exactly one named table.
+     */
+    Result<KelpKey> KeyForSubplan(Plan &plan_msg) {
+      auto sky_rels = mohair::SkyRelsForPlan(plan_msg);
+      if (sky_rels.empty()) {
+        auto table_names = mohair::NamedTablesForPlan(plan_msg);
+        if (table_names.empty()) { return Status::Invalid("Subplan reads no table"); }
+
+        for (const auto &tname : table_names) {
+          if (tname != table_names[0]) {
+            return Status::Invalid("Subplan reads more than one table");
+          }
+        }
+
+        return KeyForTableName(table_names[0]);
+      }
+
+      auto request = SliceRequest::FromSkyRel(sky_rels[0]);
+      for (const auto &sky_rel : sky_rels) {
+        if (SliceRequest::FromSkyRel(sky_rel).PartitionName() != request.PartitionName()) {
+          return Status::Invalid("Subplan reads more than one partition");
+        }
+      }
+
+      return PartitionKeyFor(request);
+    }
+
+    /**
+     * Returns the key that each branch of a split set operation is computed against (see
+     * `KeyForSubplan`), given the serialized subplan of each branch.
+     */
+    Result<vector<KelpKey>> KeysForBranches(const vector<string> &subplan_msgs) {
+      vector<KelpKey> branch_keys;
+      branch_keys.reserve(subplan_msgs.size());
+
+      for (const auto &subplan_msg : subplan_msgs) {
+        Plan branch_plan;
+        if (not branch_plan.ParseFromString(subplan_msg)) {
+          return Status::Invalid("Unable to parse branch subplan");
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto branch_key, KeyForSubplan(branch_plan));
+        branch_keys.push_back(std::move(branch_key));
+      }
+
+      return branch_keys;
+    }
+
+    /** Returns a source that only has the schema of a partition (from its schema object). */
+    Result<Declaration> SourceForPartitionSchema(const LunaDO &ldo) {
+      ArrowDO fado { ldo };
+      ARROW_ASSIGN_OR_RAISE(auto schema_table, fado.ExtractTable(0));
+
+      return Declaration {
+        "table_source", TableSourceNodeOptions { std::move(schema_table) }
+      };
+    }
+  
+    /** Returns a source for exactly the requested slices, each looked up in `fado_map`. */
+    Result<Declaration> SourceForSlices( const vector<string> &tname
+                                        ,map<KelpKey, LunaDO> &fado_map
+                                        ,int64_t               batch_size
+                                        ,const vector<string> &column_names
+                                        ,Executor             *executor) {
+      ARROW_ASSIGN_OR_RAISE(auto request, SliceRequest::FromNames(tname));
+  
+      vector<LunaDO> slice_ldos;
+      slice_ldos.reserve(request.slice_ids.size());
+  
+      for (const auto slice_id : request.slice_ids) {
+        auto slice_entry = fado_map.find(SliceKeyFor(request, slice_id));
+        if (slice_entry == fado_map.end()) {
+          return arrow::Status::KeyError(
+             "Fado table provider could not find slice [", slice_id, "] of: "
+            ,request.PartitionName()
+          );
+        }
+  
+        slice_ldos.push_back(slice_entry->second);
+      }
+  
+      return SourceForFados(
+        slice_ldos, request.PartitionName(), batch_size, column_names, {}, executor
+      );
+    }
+  
     /**
      * Convenience higher-order function that returns a `NamedTableProvider`.
      *
@@ -58,88 +238,289 @@
      *  - a decomposed table name (vector<string> that represents a single table)
      *  - a table schema
      *
-     * The resulting Declaration describes a Source Node for a query plan.
+     * The resulting Declaration describes a Source Node for a query plan. The source node
+     * emits batches of at most `batch_size` rows, containing only the columns in the table
+     * schema (all columns, if the schema is empty). Reads with a projection are given a
+     * narrowed schema (see `PushReadProjections`), and filtered reads are given zone
+     * predicates in the schema's metadata (see `ZonePredicatesForReads`).
+     *
+     * A table name is looked up as a key in `fado_map`. A shard of a table (e.g. a key
+     * of a scatter, `{"expression", "3"}`) is only used for a table name that matches the
+     * row (K1) of `shard_key`, or that names the shard itself (see `TableNameForKey`).
+     * `shard_key` is the key that a compute function was called on.
+     *
+     * Source nodes prefetch chunks on `executor`, which should be the executor of the query
+     * context that runs the plan (see `QueryContext::QueryExecutor`).
      */
-    NamedTableProvider ProviderForFadoMap(map<KelpKey, LunaDO> &fado_map) {
+    NamedTableProvider ProviderForFadoMap( map<KelpKey, LunaDO> &fado_map
+                                          ,int64_t               batch_size
+                                          ,const KelpKey        &shard_key
+                                          ,Executor             *executor) {
       /**
        * A lambda that captures the given fado_map by reference and takes two parameters:
        *  - tname  : a vector of strings that collectively make up a single table name
-       *  - tschema: an expected schema of the table, only used with early binding
+       *  - tschema: an expected schema of the table, whose fields are the columns to read
        */
-      return [&fado_map]( const vector<string> &tname
-                         ,const Schema         &) -> Result<Declaration> {
+      return [&fado_map, batch_size, shard_key, executor]( const vector<string> &tname
+                                                          ,const Schema         &tschema)
+                                                          -> Result<Declaration> {
+        auto column_names = tschema.field_names();
+  
+        // a SkyRel read names exactly the slices it needs
+        if (SliceRequest::IsSliceRequest(tname)) {
+          return SourceForSlices(tname, fado_map, batch_size, column_names, executor);
+        }
+
+        // a SkyRel's schema is resolved from its partition's schema object
+        if (SliceRequest::IsSchemaRequest(tname)) {
+          ARROW_ASSIGN_OR_RAISE(auto request, SliceRequest::FromNames(tname));
+
+          auto schema_entry = fado_map.find(PartitionSchemaKeyFor(request));
+          if (schema_entry == fado_map.end()) {
+            return arrow::Status::KeyError(
+              "Fado table provider could not find schema of: ", request.PartitionName()
+            );
+          }
+
+          return SourceForPartitionSchema(schema_entry->second);
+        }
   
         // gather the parts of the table name
         auto requested_tname = mohair::JoinStr(tname, ".");
   
-        // lookup the name in the fado_map, store entry into a structured binding
-        if (fado_map.count(requested_tname) == 0) {
-          return arrow::Status::KeyError(
-             "Fado table provider could not find table: [", requested_tname, "]"
+        // chunks are skipped using the zone map published with an object (if any)
+        ZoneFilter zone_filter { {}, ZonePredicatesForSchema(tschema) };
+
+        // lookup the name in the fado_map
+        auto requested_key = KeyForTableName(tname);
+        if (fado_map.count(requested_key) > 0) {
+          return SourceForFado(
+             fado_map[requested_key], requested_tname, batch_size, column_names, zone_filter
+            ,executor
+          );
+        }
+
+        // a compute call against one shard of a table reads the shard as the table (or
+        // as the shard's own name, see `TableNameForKey`)
+        bool is_shard    = (
+             shard_key.K1()             == requested_tname
+          or TableNameForKey(shard_key) == requested_tname
+        );
+
+        auto shard_entry = fado_map.find(shard_key);
+        if (shard_entry != fado_map.end() and is_shard) {
+          return SourceForFado(
+             shard_entry->second, requested_tname, batch_size, column_names, zone_filter
+            ,executor
           );
         }
   
-        // wrap the requested lunasa data object in a faodel arrow data object
-        const auto& ldo = fado_map[requested_tname];
-        ArrowDO fado { ldo };
+        return arrow::Status::KeyError(
+           "Fado table provider could not find table: [", requested_tname, "]"
+        );
+      };
+    }
+  
+    /**
+     * Like `ProviderForFadoMap`, but each requested table is retrieved from `kpool`.
+     *
+     * The object is retrieved by the key of the table name (see `KeyForTableName`).
+     */
+    NamedTableProvider
+    ProviderForKelpPool(KelpPool &kpool, int64_t batch_size, Executor *executor) {
+      return [&kpool, batch_size, executor]( const vector<string> &tname
+                                            ,const Schema         &tschema)
+                                            -> Result<Declaration> {
+        auto column_names = tschema.field_names();
   
-        vector<shared_ptr<Table>> fado_chunks;
-        fado_chunks.reserve(fado.NumberOfTables());
+        // a SkyRel read retrieves only the slices it names (blocks until available)
+        if (SliceRequest::IsSliceRequest(tname)) {
+          ARROW_ASSIGN_OR_RAISE(auto request, SliceRequest::FromNames(tname));
   
-        // extract each table from the data object (also called chunks)
-        for (int table_ndx = 0; table_ndx < fado.NumberOfTables(); ++table_ndx) {
-          ARROW_ASSIGN_OR_RAISE(auto fado_chunk, fado.ExtractTable(table_ndx));
-          fado_chunks.push_back(fado_chunk);
+          vector<LunaDO> slice_ldos(request.slice_ids.size());
+          for (size_t slice_ndx = 0; slice_ndx < request.slice_ids.size(); ++slice_ndx) {
+            auto slice_key   = SliceKeyFor(request, request.slice_ids[slice_ndx]);
+            auto need_status = kpool.Need(slice_key, &slice_ldos[slice_ndx]);
+            if (need_status != kelpie::KELPIE_OK) {
+              return arrow::Status::KeyError(
+                "Kelpie table provider could not find slice: [", slice_key.str(), "]"
+              );
+            }
+          }
+  
+          return SourceForFados(
+            slice_ldos, request.PartitionName(), batch_size, column_names, {}, executor
+          );
+        }
+
+        // a SkyRel's schema retrieves only its partition's (empty) schema object
+        if (SliceRequest::IsSchemaRequest(tname)) {
+          ARROW_ASSIGN_OR_RAISE(auto request, SliceRequest::FromNames(tname));
+
+          LunaDO schema_ldo;
+          auto   schema_key = PartitionSchemaKeyFor(request);
+          if (kpool.Need(schema_key, &schema_ldo) != kelpie::KELPIE_OK) {
+            return arrow::Status::KeyError(
+              "Kelpie table provider could not find schema: [", schema_key.str(), "]"
+            );
+          }
+
+          return SourceForPartitionSchema(schema_ldo);
         }
   
-        // concatenate into a single table which we wrap in a Declaration
-        // the Declaration essentially represents the data source for a scan node
-        ARROW_ASSIGN_OR_RAISE(auto fado_as_table, arrow::ConcatenateTables(fado_chunks));
-        auto options = arrow::acero::TableSourceNodeOptions(std::move(fado_as_table));
+        // gather the parts of the table name
+        auto requested_tname = mohair::JoinStr(tname, ".");
   
-        return Declaration(
-           "table_source"
-          ,TableSourceNodeOptions { std::move(fado_as_table) }
-          ,requested_tname
+        // retrieve the object from the pool (blocks until it is available)
+        LunaDO  ldo;
+        KelpKey requested_key { KeyForTableName(tname) };
+        auto    need_status = kpool.Need(requested_key, &ldo);
+        if (need_status != kelpie::KELPIE_OK) {
+          return arrow::Status::KeyError(
+             "Kelpie table provider could not find table: [", requested_tname, "]"
+          );
+        }
+
+        ZoneFilter zone_filter { {}, ZonePredicatesForSchema(tschema) };
+
+        return SourceForFado(
+          ldo, requested_tname, batch_size, column_names, zone_filter, executor
         );
       };
     }
   
   
+    /**
+     * Statistics for a fado. If it has a zone map, rows are summed from the zone map and
+     * the row width is the object's stored bytes per row (what a transfer sends), so no
+     * chunk is decoded. Otherwise, statistics are summed over each of its tables (chunks).
+     */
+    Result<TableStats> StatsForFado(const LunaDO &ldo) {
+      ArrowDO    fado { ldo };
+      TableStats fado_stats;
+
+      auto zone_map = ZoneMapForFado(ldo);
+      if (zone_map != nullptr) {
+        ARROW_ASSIGN_OR_RAISE(
+           auto row_sum
+          ,arrow::compute::Sum(zone_map->GetColumnByName("row_count"))
+        );
+
+        fado_stats.row_count = row_sum.scalar_as<arrow::Int64Scalar>().value;
+        if (fado_stats.row_count > 0) {
+          fado_stats.row_width = static_cast<int64_t>(ldo.GetDataSize()) / fado_stats.row_count;
+        }
+
+        return fado_stats;
+      }
+
+      int64_t byte_count  = 0;
+      int     chunk_count = ChunkCountForFado(fado, zone_map);
+      for (int chunk_ndx = 0; chunk_ndx < chunk_count; ++chunk_ndx) {
+        ARROW_ASSIGN_OR_RAISE(auto chunk_table, fado.ExtractTable(chunk_ndx));
+
+        auto chunk_stats       = mohair::StatsForTable(*chunk_table);
+        fado_stats.row_count  += chunk_stats.row_count;
+        byte_count            += chunk_stats.row_count * chunk_stats.row_width;
+      }
+
+      if (fado_stats.row_count > 0) { fado_stats.row_width = byte_count / fado_stats.row_count; }
+      return fado_stats;
+    }
+
+    /**
+     * Returns the name that plans use for the table at `kkey`: the row, joined with the
+     * column if the key has one. For a key without a column, this is the inverse of
+     * `KeyForTableName`.
+     */
+    string TableNameForKey(const KelpKey &kkey) {
+      if (kkey.K2().empty()) { return kkey.K1(); }
+
+      return kkey.K1() + "." + kkey.K2();
+    }
+
+    /**
+     * Statistics for each table in `fado_map`, keyed by the names that plans use (see
+     * `SourceNameForRead` and `SourceNameForSky`). Objects that share a row (e.g. the
+     * slices of a partition) are summed under the row (K1), and an object with a column
+     * (e.g. a shard) is also keyed by its own name (see `TableNameForKey`).
+     */
+    StatsMap StatsForFadoMap(map<KelpKey, LunaDO> &fado_map) {
+      StatsMap             table_stats;
+      map<string, int64_t> table_bytes;
+
+      auto add_stats = [&table_stats, &table_bytes](const string &tname, TableStats fstats) {
+        table_stats[tname].row_count += fstats.row_count;
+        table_bytes[tname]           += fstats.row_count * fstats.row_width;
+      };
+
+      for (auto &[kkey, ldo] : fado_map) {
+        auto fado_stats = StatsForFado(ldo);
+        if (not fado_stats.ok()) {
+          mohair::PrintError("Unable to gather statistics for fado", fado_stats.status());
+          continue;
+        }
+
+        add_stats(kkey.K1(), *fado_stats);
+        if (not kkey.K2().empty()) { add_stats(TableNameForKey(kkey), *fado_stats); }
+      }
+
+      for (auto &[tname, tstats] : table_stats) {
+        if (tstats.row_count > 0) { tstats.row_width = table_bytes[tname] / tstats.row_count; }
+      }
+
+      return table_stats;
+    }
+
+
+    /**
+     * Translates a serialized substrait plan into an Acero plan whose named tables are
+     * resolved from `fado_map` (a table may be a shard at `shard_key`, see above).
+     *
+     * Translated plans are shared across compute function calls via a PlanCache, so
+     * repeated plans only resolve their named tables.
+     */
+    Result<PlanInfo> AceroPlanForFadoMap( const string               &plan_msg
+                                         ,map<KelpKey, LunaDO>       &fado_map
+                                         ,int64_t                     batch_size
+                                         ,const KelpKey              &shard_key
+                                         ,Executor                   *executor) {
+      static PlanCache compute_plan_cache;
+  
+      // Create a buffer that references `plan_msg` (protobuf serialized to a binary string)
+      Buffer serialized_plan { plan_msg };
+  
+      return compute_plan_cache.PlanFor(
+         serialized_plan
+        ,mohair::adapters::ProviderForFadoMap(fado_map, batch_size, shard_key, executor)
+      );
+    }
+  
+  
     /**
      * A function that takes a serialized substrait plan as a binary string, executes it, then
      * puts the results in `ext_ldo`.
      *
-     * NOTE: based on an example, FaoBucket and KelpKey are unused, so we will figure that
-     * out later.
-     */
-    FaoStatus ExecuteSubstrait(        FaoBucket    /* b */
-                                ,const KelpKey      /* k */
-                                ,const string         &args
-                                ,map<KelpKey, LunaDO>  fado_map
-                                ,LunaDO               *ext_ldo) {
-      // ConversionOptions controls translation of a plan between Substrait and Acero.
-      // The only one we're interested in for now is to customize handling of named tables.
-      ConversionOptions conv_opts;
-      conv_opts.named_table_provider = mohair::adapters::ProviderForFadoMap(fado_map);
-  
-      // Create a buffer using a copy of `args` (protobuf serialized to a binary string)
-      auto         serialized_plan  = Buffer::FromString(string { args });
-      auto         default_registry = arrow::engine::default_extension_id_registry();
-  
-      // Parse substrait plan into a Result<PlanInfo> and stash the constructed ExtensionSet
-      ExtensionSet acero_ext_set;
-      auto result_plan = arrow::engine::DeserializePlan(
-        *serialized_plan, default_registry, &acero_ext_set, conv_opts
+     * The KelpKey is the key the function was called on, which may be a shard of a table
+     * (see `ProviderForFadoMap`). Based on an example, FaoBucket is unused, so we will
+     * figure that out later.
+     */
+    FaoStatus ExecuteSubstrait(        QueryContext         &query_ctx
+                                ,      FaoBucket             /* b */
+                                ,const KelpKey               k
+                                ,const string               &args
+                                ,map<KelpKey, LunaDO>        fado_map
+                                ,LunaDO                     *ext_ldo) {
+      auto result_plan = AceroPlanForFadoMap(
+        args, fado_map, default_batch_size, k, query_ctx.QueryExecutor()
       );
-  
       if (not result_plan.ok()) {
         mohair::PrintError("Error when translating substrait to acero:", result_plan.status());
         return FaodelStatusFromArrowStatus(result_plan.status());
       }
   
       // Get the root Declaration of the Result<PlanInfo> for Acero execution
-      auto query_results = ExecutePlan(*result_plan);
+      auto query_results = ExecutePlan(*result_plan, query_ctx);
       if (not query_results.ok()) {
         mohair::PrintError("Error when executing acero plan:", query_results.status());
         return FaodelStatusFromArrowStatus(query_results.status());
@@ -153,6 +534,392 @@
       return kelpie::KELPIE_OK;
     }
   
+    /** Returns the key of chunk `chunk_ndx` of a result streamed under `stream_row`. */
+    KelpKey StreamChunkKeyFor(const string &stream_row, int64_t chunk_ndx) {
+      return KelpKey { stream_row, std::to_string(chunk_ndx) };
+    }
+
+    /** True if `chunk_table` is the last chunk of a streamed result (see `PublishStream`). */
+    bool IsLastStreamChunk(const Table &chunk_table) {
+      const auto &schema_meta = chunk_table.schema()->metadata();
+      if (schema_meta == nullptr) { return false; }
+
+      return schema_meta->Contains(stream_end_key);
+    }
+
+    /**
+     * Publishes the batches of `reader`, grouped into chunks of at most `chunk_size` rows,
+     * under keys from `StreamChunkKeyFor` as each chunk is complete. Returns the number
+     * of chunks.
+     *
+     * The next chunk is read before a chunk is published, so that the last chunk can be
+     * marked (see `IsLastStreamChunk`). An empty result is a single, empty chunk.
+     */
+    Result<int64_t> PublishStream( KelpPool          &kpool
+                                  ,const string      &stream_row
+                                  ,RecordBatchReader *reader
+                                  ,int64_t            chunk_size) {
+      ARROW_ASSIGN_OR_RAISE(auto next_chunk, NextChunk(reader, chunk_size));
+      if (next_chunk == nullptr) {
+        ARROW_ASSIGN_OR_RAISE(next_chunk, Table::MakeEmpty(reader->schema()));
+      }
+
+      int64_t chunk_count = 0;
+      while (next_chunk != nullptr) {
+        auto stream_chunk = std::move(next_chunk);
+        ARROW_ASSIGN_OR_RAISE(next_chunk, NextChunk(reader, chunk_size));
+
+        if (next_chunk == nullptr) {
+          const auto &chunk_meta = stream_chunk->schema()->metadata();
+          auto        end_meta   = (
+              chunk_meta == nullptr
+            ? std::make_shared<arrow::KeyValueMetadata>()
+            : chunk_meta->Copy()
+          );
+
+          end_meta->Append(stream_end_key, "true");
+          stream_chunk = stream_chunk->ReplaceSchemaMetadata(end_meta);
+        }
+
+        ArrowDO chunk_fado { stream_chunk };
+        auto    chunk_key = StreamChunkKeyFor(stream_row, chunk_count++);
+        if (kpool.Publish(chunk_key, chunk_fado.ExportDataObject()) != kelpie::KELPIE_OK) {
+          return Status::IOError("Unable to publish stream chunk: ", chunk_key.str());
+        }
+      }
+
+      return chunk_count;
+    }
+
+    /**
+     * A streaming variant of `ExecuteSubstrait`.
+     *
+     * `args` is the row (K1) to stream the result under, a newline, then the serialized
+     * plan. Instead of materializing the query result, batches are pulled from the running
+     * plan and grouped into chunks of at most `stream_opts.chunk_size` rows, and each chunk
+     * is published as soon as it is complete (see `PublishStream`). So, a consumer can
+     * read (and release) each chunk while the plan is still running.
+     *
+     * The result in `ext_ldo` is a manifest: a table with the number of chunks streamed.
+     */
+    FaoStatus ExecuteSubstraitStream(       QueryContext         &query_ctx
+                                     ,const StreamOptions        &stream_opts
+                                     ,      KelpPool             &kpool
+                                     ,      FaoBucket             /* b */
+                                     ,const KelpKey               k
+                                     ,const string               &args
+                                     ,map<KelpKey, LunaDO>        fado_map
+                                     ,LunaDO                     *ext_ldo) {
+      auto row_end = args.find('\n');
+      if (row_end == string::npos) {
+        mohair::PrintError("Error when streaming:", Status::Invalid("No row to stream to"));
+        return kelpie::KELPIE_EINVAL;
+      }
+
+      string stream_row { args.substr(0, row_end) };
+      string plan_msg   { args.substr(row_end + 1) };
+
+      auto result_plan = AceroPlanForFadoMap(
+        plan_msg, fado_map, stream_opts.batch_size, k, query_ctx.QueryExecutor()
+      );
+      if (not result_plan.ok()) {
+        mohair::PrintError("Error when translating substrait to acero:", result_plan.status());
+        return FaodelStatusFromArrowStatus(result_plan.status());
+      }
+  
+      // Start executing the plan; results are consumed as they are produced
+      auto result_reader = StreamPlan(*result_plan, query_ctx);
+      if (not result_reader.ok()) {
+        mohair::PrintError("Error when executing acero plan:", result_reader.status());
+        return FaodelStatusFromArrowStatus(result_reader.status());
+      }
+  
+      auto chunk_count = PublishStream(
+        kpool, stream_row, result_reader->get(), stream_opts.chunk_size
+      );
+
+      if (not chunk_count.ok()) {
+        mohair::PrintError("Error when streaming acero results:", chunk_count.status());
+        return FaodelStatusFromArrowStatus(chunk_count.status());
+      }
+
+      // Wrap the manifest in a fado, then export to the output argument
+      auto count_array = arrow::MakeArrayFromScalar(arrow::Int64Scalar(*chunk_count), 1);
+      if (not count_array.ok()) {
+        mohair::PrintError("Error when building stream manifest:", count_array.status());
+        return FaodelStatusFromArrowStatus(count_array.status());
+      }
+
+      auto manifest = Table::Make(
+        arrow::schema({ arrow::field("chunk_count", arrow::int64()) }), { *count_array }
+      );
+
+      ArrowDO fado { manifest };
+      fado.SetObjectStatus(kelpie::KELPIE_OK);
+      *ext_ldo = fado.ExportDataObject();
+
+      return kelpie::KELPIE_OK;
+    }
+  
+  } // namespace: mohair::adapters
+  
+  
+  // ------------------------------
+  // Classes and Methods
+  
+  namespace mohair::adapters {
+  
+    //  >> ZoneFilter
+
+    /**
+     * True unless the zone map of the fado at `fado_ndx` rules out chunk `chunk_ndx`. A
+     * zone map is ignored if it doesn't describe every chunk of its fado (`chunk_count`).
+     * The zone maps are filled in by the reader, from the fados it reads.
+     */
+    bool ZoneFilter::ChunkMayMatch(size_t fado_ndx, int chunk_ndx, int chunk_count) const {
+      if (zone_preds.empty() or fado_ndx >= zone_maps.size()) { return true; }
+
+      const auto &zone_map = zone_maps[fado_ndx];
+      if (zone_map == nullptr or zone_map->num_rows() != chunk_count) { return true; }
+
+      return mohair::ChunkMayMatch(*zone_map, chunk_ndx, zone_preds);
+    }
+
+
+    //  >> FadoBatchReader
+
+    /**
+     * Reads table (chunk) `table_ndx` of `fado`, keeping only `column_names` (in that
+     * order) unless it is empty. The chunk is an IPC stream, so the projection is applied
+     * via `IpcReadOptions::included_fields` and the other columns are never decoded (or
+     * decompressed). Included fields are read in stored order, so the columns are then
+     * reordered if the projection's order differs.
+     */
+    Result<shared_ptr<Table>>
+    ReadFadoChunk(ArrowDO &fado, int table_ndx, const vector<string> &column_names) {
+      if (column_names.empty()) { return fado.ExtractTable(table_ndx); }
+
+      ARROW_ASSIGN_OR_RAISE(auto chunk_buffer, fado.GetTableBuffer(table_ndx));
+
+      // the stream's schema message precedes its batches, so opening decodes no columns
+      ARROW_ASSIGN_OR_RAISE(
+         auto schema_reader
+        ,RecordBatchStreamReader::Open(std::make_shared<BufferReader>(chunk_buffer))
+      );
+
+      auto stored_schema = schema_reader->schema();
+      auto read_opts     = IpcReadOptions::Defaults();
+      read_opts.included_fields.reserve(column_names.size());
+
+      for (const auto &column_name : column_names) {
+        int field_ndx = stored_schema->GetFieldIndex(column_name);
+        if (field_ndx < 0) {
+          return Status::KeyError("Fado table does not contain column: ", column_name);
+        }
+
+        read_opts.included_fields.push_back(field_ndx);
+      }
+
+      ARROW_ASSIGN_OR_RAISE(
+         auto chunk_reader
+        ,RecordBatchStreamReader::Open(
+           std::make_shared<BufferReader>(chunk_buffer), read_opts
+         )
+      );
+
+      ARROW_ASSIGN_OR_RAISE(auto chunk_table, chunk_reader->ToTable());
+
+      // included fields arrive in stored order; reorder (zero-copy) to the projection's
+      bool in_order = std::is_sorted(
+        read_opts.included_fields.begin(), read_opts.included_fields.end()
+      );
+      if (in_order) { return chunk_table; }
+
+      vector<int> column_ndxs;
+      column_ndxs.reserve(column_names.size());
+      for (const auto &column_name : column_names) {
+        column_ndxs.push_back(chunk_table->schema()->GetFieldIndex(column_name));
+      }
+
+      return chunk_table->SelectColumns(column_ndxs);
+    }
+  
+    FadoBatchReader::FadoBatchReader( const vector<LunaDO> &ldos
+                                     ,int64_t               bsize
+                                     ,const vector<string> &cnames
+                                     ,const ZoneFilter     &zfilter
+                                     ,Executor             *exec)
+      :  fados(ldos.begin(), ldos.end())
+        ,fado_ndx(0)
+        ,chunk_count(0)
+        ,chunk_ndx(0)
+        ,batch_size(bsize)
+        ,column_names(cnames)
+        ,zone_filter(zfilter)
+        ,prefetch_count(default_chunk_prefetch)
+        ,executor(exec != nullptr ? exec : arrow::internal::GetCpuThreadPool())
+    {
+      zone_filter.zone_maps.clear();
+      zone_filter.zone_maps.reserve(ldos.size());
+      for (const auto &ldo : ldos) { zone_filter.zone_maps.push_back(ZoneMapForFado(ldo)); }
+
+      if (not fados.empty()) { chunk_count = ChunkCountFor(0); }
+    }
+  
+    FadoBatchReader::FadoBatchReader(const LunaDO &ldo, int64_t bsize)
+      : FadoBatchReader(vector<LunaDO> { ldo }, bsize, {}) {}
+  
+    /**
+     * Creates a reader and opens the first chunk, which determines the reader's schema. If
+     * every chunk is skipped, the first chunk is opened for its schema and then released,
+     * so the reader emits no batches.
+     */
+    Result<shared_ptr<FadoBatchReader>>
+    FadoBatchReader::Make( const vector<LunaDO> &ldos
+                          ,int64_t               batch_size
+                          ,const vector<string> &column_names
+                          ,const ZoneFilter     &zone_filter
+                          ,Executor             *executor) {
+      auto fado_reader = std::make_shared<FadoBatchReader>(
+        ldos, batch_size, column_names, zone_filter, executor
+      );
+
+      bool has_chunk = fado_reader->HasNextChunk();
+      if (not has_chunk) {
+        fado_reader->fado_ndx    = 0;
+        fado_reader->chunk_ndx   = 0;
+        fado_reader->chunk_count = ldos.empty() ? 0 : fado_reader->ChunkCountFor(0);
+
+        if (fado_reader->chunk_count < 1) {
+          return Status::Invalid("Fado contains no tables to read");
+        }
+      }
+  
+      ARROW_RETURN_NOT_OK(fado_reader->OpenNextChunk());
+      fado_reader->chunk_schema = fado_reader->chunk_table->schema();
+
+      if (not has_chunk) {
+        fado_reader->chunk_reader.reset();
+        fado_reader->chunk_table.reset();
+        fado_reader->fado_ndx = fado_reader->fados.size();
+      }
+  
+      return fado_reader;
+    }
+  
+    Result<shared_ptr<FadoBatchReader>>
+    FadoBatchReader::Make(const LunaDO &ldo, int64_t batch_size) {
+      return Make(vector<LunaDO> { ldo }, batch_size, {});
+    }
+  
+    /**
+     * True if a chunk remains in the current fado or in any fado after it. Chunks that the
+     * zone filter rules out are skipped along the way.
+     */
+    bool FadoBatchReader::HasNextChunk() {
+      while (fado_ndx < fados.size()) {
+        while (
+              chunk_ndx < chunk_count
+          and not zone_filter.ChunkMayMatch(fado_ndx, chunk_ndx, chunk_count)
+        ) {
+          ++chunk_ndx;
+        }
+
+        if (chunk_ndx < chunk_count) { return true; }
+  
+        // current fado is exhausted; move to the next one
+        if (++fado_ndx < fados.size()) {
+          chunk_count = ChunkCountFor(fado_ndx);
+          chunk_ndx   = 0;
+        }
+      }
+  
+      return false;
+    }
+  
+    /** The number of data tables (chunks) of the fado at `fado_pos` (see `ZoneMapForFado`). */
+    int FadoBatchReader::ChunkCountFor(size_t fado_pos) {
+      return ChunkCountForFado(fados[fado_pos], zone_filter.zone_maps[fado_pos]);
+    }
+
+    /**
+     * Starts extracting the chunks after the current position (on `executor`) until
+     * `prefetch_count` chunks are pending. Chunks are decompressed as they are extracted,
+     * so this overlaps decompression of later chunks with reads of the current one.
+     */
+    void FadoBatchReader::PrefetchChunks() {
+      while (prefetched_chunks.size() < prefetch_count and HasNextChunk()) {
+        // each task extracts from its own copy of the fado
+        auto extract_chunk = executor->Submit(
+          [fado = fados[fado_ndx], table_ndx = chunk_ndx, cnames = column_names]() mutable {
+            return ReadFadoChunk(fado, table_ndx, cnames);
+          }
+        );
+
+        ++chunk_ndx;
+        if (not extract_chunk.ok()) {
+          prefetched_chunks.push_back(ChunkFuture::MakeFinished(extract_chunk.status()));
+        }
+        else { prefetched_chunks.push_back(std::move(extract_chunk).ValueOrDie()); }
+      }
+    }
+
+    /** True if a chunk is pending (see `PrefetchChunks`) or remains to be read. */
+    bool FadoBatchReader::HasPendingChunk() {
+      return not prefetched_chunks.empty() or HasNextChunk();
+    }
+
+    /**
+     * Reads the next table (chunk) and prepares to read its batches. If the reader has a
+     * projection, only the projected columns of the chunk are decoded (see `ReadFadoChunk`).
+     *
+     * The next chunk is the oldest prefetched chunk, if any. Otherwise, it is read here.
+     * Either way, the chunks after it are then prefetched.
+     */
+    Status FadoBatchReader::OpenNextChunk() {
+      if (prefetched_chunks.empty()) {
+        ARROW_ASSIGN_OR_RAISE(
+           chunk_table
+          ,ReadFadoChunk(fados[fado_ndx], chunk_ndx++, column_names)
+        );
+      }
+
+      else {
+        auto next_chunk = std::move(prefetched_chunks.front());
+        prefetched_chunks.pop_front();
+
+        ARROW_ASSIGN_OR_RAISE(chunk_table, next_chunk.result());
+      }
+
+      PrefetchChunks();
+  
+      chunk_reader = std::make_unique<TableBatchReader>(chunk_table);
+      chunk_reader->set_chunksize(batch_size);
+  
+      return Status::OK();
+    }
+  
+    shared_ptr<Schema> FadoBatchReader::schema() const { return chunk_schema; }
+  
+    /** Emits the next batch of the current chunk, moving to the next chunk as needed. */
+    Status FadoBatchReader::ReadNext(shared_ptr<RecordBatch> *batch) {
+      *batch = nullptr;
+  
+      while (chunk_reader != nullptr) {
+        ARROW_RETURN_NOT_OK(chunk_reader->ReadNext(batch));
+        if (*batch != nullptr) { return Status::OK(); }
+  
+        // current chunk is exhausted; release it before opening the next one
+        chunk_reader.reset();
+        chunk_table.reset();
+  
+        if (HasPendingChunk()) { ARROW_RETURN_NOT_OK(OpenNextChunk()); }
+      }
+  
+      // a null batch signals the end of the stream
+      return Status::OK();
+    }
+  
   } // namespace: mohair::adapters
 
 #endif
@@ -11,6 +11,9 @@
 
 #include "adapter_faodel.hpp"
 
+#include <arrow/util/byte_size.h>
+#include <arrow/util/compression.h>
+
 
 // ------------------------------
 // Type Aliases
@@ -39,11 +42,38 @@ namespace mohair::adapters {
               // << "bootstrap.debug true"                                      << endl
               // << "dirman.debug    true"                                      << endl
               << "kelpie.debug    true"                                      << endl
+
+              << "# Threads (0 for one per core) and concurrent plans for queries" << endl
+              << query_threads_key << " 0"                                   << endl
+              << query_limit_key   << " " << default_max_queries             << endl
     ;
 
     return config_ss.str();
   }
 
+  /**
+   * Creates the query context that compute functions execute within, bounded by the
+   * thread count and query limit in `faodel_config` (or defaults, if a key is not set).
+   * If a thread pool cannot be created, plans execute on Arrow's CPU pool.
+   */
+  shared_ptr<QueryContext> QueryContextForConfig(const string &faodel_config) {
+    faodel::Configuration config_obj { faodel_config };
+
+    int64_t thread_count;
+    int64_t query_limit;
+    config_obj.GetInt(&thread_count, query_threads_key, "0");
+    config_obj.GetInt(&query_limit , query_limit_key  , std::to_string(default_max_queries));
+
+    auto ctx_result = QueryContext::Make(
+      static_cast<int>(thread_count), static_cast<size_t>(query_limit)
+    );
+
+    if (ctx_result.ok()) { return std::move(ctx_result).ValueOrDie(); }
+
+    mohair::PrintError("Unable to create query context", ctx_result.status());
+    return std::make_shared<QueryContext>();
+  }
+
 } // namespace: mohair::adapters
 
 
@@ -51,10 +81,442 @@ namespace mohair::adapters {
 // Classes and Methods
 
 namespace mohair::adapters {
+  //  >> PublishStats
+
+  /** Raw bytes per stored byte (1 for an empty table). */
+  double PublishStats::CompressionRatio() const {
+    if (stored_bytes <= 0) { return 1.0; }
+
+    return static_cast<double>(raw_bytes) / stored_bytes;
+  }
+
+  //  >> CachedResult
+
+  /** Returns the key of each chunk of the cached result. */
+  vector<KelpKey> CachedResult::ChunkKeys() const {
+    vector<KelpKey> chunk_keys;
+    chunk_keys.reserve(chunk_count);
+
+    for (int64_t chunk_ndx = 0; chunk_ndx < chunk_count; ++chunk_ndx) {
+      chunk_keys.push_back(StreamChunkKeyFor(chunk_row, chunk_ndx));
+    }
+
+    return chunk_keys;
+  }
+
+  //  >> ResultChunkReader
+  ResultChunkReader::ResultChunkReader( const KelpPool &pool
+                                       ,const string   &row
+                                       ,int64_t         count
+                                       ,int64_t         bsize
+                                       ,CloseFn         close_fn)
+    :  kpool(pool)
+      ,chunk_row(row)
+      ,chunk_count(count)
+      ,chunk_ndx(0)
+      ,table_ndx(0)
+      ,batch_size(bsize)
+      ,is_complete(false)
+      ,is_closed(false)
+      ,on_close(std::move(close_fn))
+  {
+  }
+
+  ResultChunkReader::~ResultChunkReader() { ARROW_UNUSED(Close()); }
+
+  /**
+   * Returns the next chunk of the result: a held chunk, if any remain, or the chunk with
+   * the next index in the pool.
+   *
+   * A chunk of a streamed result is waited for: the reader wants the chunk (a callback
+   * signals when it is published) and sleeps until it is published or the compute
+   * function returns. Otherwise, the chunk is expected to be in the pool already, which
+   * is checked without blocking before it is read.
+   */
+  Result<LunaDO> ResultChunkReader::NextChunk() {
+    if (not held_chunks.empty()) {
+      LunaDO held_chunk { held_chunks.front() };
+      held_chunks.pop_front();
+
+      return held_chunk;
+    }
+
+    int64_t chunk_pos = chunk_ndx;
+    KelpKey chunk_key = StreamChunkKeyFor(chunk_row, chunk_pos);
+
+    if (stream_signal != nullptr) {
+      auto wanted_signal = stream_signal;
+      kpool.Want(
+         chunk_key
+        ,[wanted_signal, chunk_pos]( bool                          is_found
+                                    ,KelpKey                       /* key */
+                                    ,LunaDO                        chunk_ldo
+                                    ,const kelpie::object_info_t & /* info */) {
+           std::lock_guard<std::mutex> signal_lock { wanted_signal->signal_mutex };
+           if (is_found) { wanted_signal->ready_chunks[chunk_pos] = chunk_ldo; }
+
+           wanted_signal->signal.notify_all();
+         }
+      );
+
+      std::unique_lock<std::mutex> signal_lock { stream_signal->signal_mutex };
+      stream_signal->signal.wait(
+         signal_lock
+        ,[this, chunk_pos]() {
+           return (
+                 stream_signal->is_computed
+              or stream_signal->ready_chunks.count(chunk_pos) > 0
+           );
+         }
+      );
+
+      auto ready_entry = stream_signal->ready_chunks.find(chunk_pos);
+      if (ready_entry != stream_signal->ready_chunks.end()) {
+        LunaDO ready_chunk { ready_entry->second };
+        stream_signal->ready_chunks.erase(ready_entry);
+
+        return ready_chunk;
+      }
+
+      // the compute function returned first; the chunk may have been published just
+      // before it returned (then, it is read below), otherwise the stream is incomplete
+      if (stream_signal->compute_status != kelpie::KELPIE_OK) {
+        return Status::ExecutionError("Compute function failed for stream: ", chunk_row);
+      }
+    }
+
+    kelpie::object_info_t chunk_info;
+    if (kpool.Info(chunk_key, &chunk_info) != kelpie::KELPIE_OK) {
+      return Status::KeyError("Result chunk unavailable: ", chunk_key.str());
+    }
+
+    LunaDO chunk_ldo;
+    if (kpool.Need(chunk_key, &chunk_ldo) != kelpie::KELPIE_OK) {
+      return Status::KeyError("Result chunk unavailable: ", chunk_key.str());
+    }
+
+    return chunk_ldo;
+  }
+
+  /**
+   * Extracts the next table of the result, reading the next chunk if the current one is
+   * exhausted, and prepares to read its batches. Returns false if no table remains. The
+   * end marker of a streamed result is removed from the table's schema.
+   */
+  Result<bool> ResultChunkReader::OpenNextTable() {
+    while (chunk_fado == nullptr or table_ndx >= chunk_fado->NumberOfTables()) {
+      chunk_fado.reset();
+      if (is_complete) { return false; }
+
+      ARROW_ASSIGN_OR_RAISE(auto chunk_ldo, NextChunk());
+      chunk_fado = std::make_unique<ArrowDO>(chunk_ldo);
+      table_ndx  = 0;
+
+      // unless something may keep a streamed result, each chunk is dropped once it's read
+      if (stream_signal != nullptr and on_close == nullptr) {
+        kpool.Drop(StreamChunkKeyFor(chunk_row, chunk_ndx));
+      }
+
+      if (++chunk_ndx == chunk_count) { is_complete = true; }
+    }
+
+    ARROW_ASSIGN_OR_RAISE(chunk_table, chunk_fado->ExtractTable(table_ndx++));
+    if (IsLastStreamChunk(*chunk_table)) {
+      auto end_meta = chunk_table->schema()->metadata()->Copy();
+      ARROW_RETURN_NOT_OK(end_meta->Delete(stream_end_key));
+
+      chunk_table = chunk_table->ReplaceSchemaMetadata(end_meta);
+      is_complete = true;
+    }
+
+    if (result_schema == nullptr) { result_schema = chunk_table->schema(); }
+
+    table_reader = std::make_unique<TableBatchReader>(chunk_table);
+    table_reader->set_chunksize(batch_size);
+
+    return true;
+  }
+
+  /**
+   * Opens the first table of the result, which determines the reader's schema. If it
+   * can't be opened, the reader is closed.
+   */
+  Status ResultChunkReader::Open() {
+    auto open_result = OpenNextTable();
+    if (open_result.ok() and not *open_result) {
+      open_result = Status::Invalid("Result contains no tables to read");
+    }
+
+    if (not open_result.ok()) {
+      ARROW_UNUSED(Close());
+      return open_result.status();
+    }
+
+    return Status::OK();
+  }
+
+  shared_ptr<Schema> ResultChunkReader::schema() const { return result_schema; }
+
+  /**
+   * Emits the next batch of the current table, moving to the next table (and chunk) as
+   * needed. The reader is closed once the result is exhausted or fails.
+   */
+  Status ResultChunkReader::ReadNext(shared_ptr<RecordBatch> *batch) {
+    *batch = nullptr;
+
+    while (table_reader != nullptr) {
+      ARROW_RETURN_NOT_OK(table_reader->ReadNext(batch));
+      if (*batch != nullptr) { return Status::OK(); }
+
+      // current table is exhausted; release it before opening the next one
+      table_reader.reset();
+      chunk_table.reset();
+
+      auto open_result = OpenNextTable();
+      if (not open_result.ok()) {
+        ARROW_UNUSED(Close());
+        return open_result.status();
+      }
+    }
+
+    // a null batch signals the end of the stream
+    return Close();
+  }
+
+  /**
+   * Releases the current chunk, waits for the compute function (if any), then gives the
+   * chunks to `on_close`. If it doesn't keep them, every chunk of a streamed result that
+   * is still in the pool is dropped.
+   */
+  Status ResultChunkReader::Close() {
+    if (is_closed) { return Status::OK(); }
+    is_closed = true;
+
+    table_reader.reset();
+    chunk_table.reset();
+    chunk_fado.reset();
+    held_chunks.clear();
+
+    if (compute_thread.joinable()) { compute_thread.join(); }
+
+    bool is_kept = (on_close != nullptr) and on_close(*this);
+    if (stream_signal == nullptr or is_kept) { return Status::OK(); }
+
+    kelpie::ObjectCapacities stream_listing;
+    if (kpool.List(KelpKey { chunk_row, "*" }, &stream_listing) == kelpie::KELPIE_OK) {
+      for (const auto &chunk_key : stream_listing.keys) { kpool.Drop(chunk_key); }
+    }
+
+    return Status::OK();
+  }
+
+  //  >> ScatterBatchReader
+  ScatterBatchReader::ScatterBatchReader( Faodel                           *adapter
+                                         ,const KelpPool                   &pool
+                                         ,const vector<KelpKey>            &keys
+                                         ,const vector<shared_ptr<Buffer>> &plans
+                                         ,size_t                            queue_limit)
+    :  faodel_if(adapter)
+      ,kpool(pool)
+      ,kkeys(keys)
+      ,plan_msgs(plans)
+      ,next_key_ndx(0)
+      ,max_queued(std::max<size_t>(queue_limit, 1))
+      ,finished_workers(0)
+      ,is_cancelled(false)
+      ,is_closed(false)
+  {
+  }
+
+  ScatterBatchReader::~ScatterBatchReader() { ARROW_UNUSED(Close()); }
+
+  /**
+   * Creates a reader and starts `worker_count` workers, then waits until the first partial
+   * result can be read, which determines the reader's schema. If an execution fails first,
+   * the reader is closed and the error is returned.
+   */
+  Result<shared_ptr<ScatterBatchReader>>
+  ScatterBatchReader::Make( Faodel                           *adapter
+                           ,const KelpPool                   &pool
+                           ,const vector<KelpKey>            &keys
+                           ,const vector<shared_ptr<Buffer>> &plans
+                           ,size_t                            worker_count
+                           ,size_t                            queue_limit) {
+    auto scatter_reader = std::make_shared<ScatterBatchReader>(
+      adapter, pool, keys, plans, queue_limit
+    );
+
+    worker_count = std::max<size_t>(worker_count, 1);
+    scatter_reader->workers.reserve(worker_count);
+    for (size_t worker_ndx = 0; worker_ndx < worker_count; ++worker_ndx) {
+      scatter_reader->workers.emplace_back(
+        [worker_reader = scatter_reader.get()]() { worker_reader->ExecuteKeys(); }
+      );
+    }
+
+    Status open_status;
+    {
+      std::unique_lock<std::mutex> queue_lock { scatter_reader->queue_mutex };
+      scatter_reader->queue_signal.wait(
+         queue_lock
+        ,[&scatter_reader, worker_count]() {
+           return (
+                 scatter_reader->result_schema != nullptr
+              or not scatter_reader->scatter_status.ok()
+              or scatter_reader->finished_workers == worker_count
+           );
+         }
+      );
+
+      open_status = scatter_reader->scatter_status;
+      if (open_status.ok() and scatter_reader->result_schema == nullptr) {
+        open_status = Status::Invalid("Scatter produced no results to read");
+      }
+    }
+
+    if (not open_status.ok()) {
+      ARROW_UNUSED(scatter_reader->Close());
+      return open_status;
+    }
+
+    return scatter_reader;
+  }
+
+  /**
+   * Runs on each worker: executes the next unexecuted key and queues the batches of its
+   * result, until no key remains, the reader is closed, or an execution fails.
+   */
+  void ScatterBatchReader::ExecuteKeys() {
+    Status worker_status;
+
+    for (
+      size_t key_ndx = next_key_ndx++;
+      key_ndx < kkeys.size() and worker_status.ok() and not is_cancelled;
+      key_ndx = next_key_ndx++
+    ) {
+      KelpKey worker_key     { kkeys[key_ndx] };
+      auto    partial_reader = faodel_if->ExecuteEngineAcero(
+        kpool, worker_key, plan_msgs[key_ndx]
+      );
+
+      if (not partial_reader.ok()) {
+        worker_status = partial_reader.status();
+        break;
+      }
+
+      {
+        std::lock_guard<std::mutex> queue_lock { queue_mutex };
+        if (result_schema == nullptr) {
+          result_schema = (*partial_reader)->schema();
+          queue_signal.notify_all();
+        }
+      }
+
+      shared_ptr<RecordBatch> partial_batch;
+      while (true) {
+        worker_status = (*partial_reader)->ReadNext(&partial_batch);
+        if (not worker_status.ok() or partial_batch == nullptr) { break; }
+        if (not QueueBatch(std::move(partial_batch)))           { break; }
+      }
+
+      worker_status &= (*partial_reader)->Close();
+    }
+
+    std::lock_guard<std::mutex> queue_lock { queue_mutex };
+    scatter_status &= worker_status;
+    ++finished_workers;
+    queue_signal.notify_all();
+  }
+
+  /**
+   * Queues a batch for the reader, waiting while `max_queued` batches are queued. Returns
+   * false if the reader was closed instead.
+   */
+  bool ScatterBatchReader::QueueBatch(shared_ptr<RecordBatch> batch) {
+    std::unique_lock<std::mutex> queue_lock { queue_mutex };
+    queue_signal.wait(
+      queue_lock, [this]() { return is_cancelled or batch_queue.size() < max_queued; }
+    );
+
+    if (is_cancelled) { return false; }
+
+    batch_queue.push_back(std::move(batch));
+    queue_signal.notify_all();
+
+    return true;
+  }
+
+  shared_ptr<Schema> ScatterBatchReader::schema() const { return result_schema; }
+
+  /**
+   * Emits the next queued batch, waiting for a worker to queue one. Once every worker has
+   * finished and the queue is drained (or an execution failed), the reader is closed.
+   */
+  Status ScatterBatchReader::ReadNext(shared_ptr<RecordBatch> *batch) {
+    *batch = nullptr;
+    if (is_closed) { return Status::OK(); }
+
+    Status read_status;
+    {
+      std::unique_lock<std::mutex> queue_lock { queue_mutex };
+      queue_signal.wait(
+         queue_lock
+        ,[this]() {
+           return (
+                 not batch_queue.empty()
+              or not scatter_status.ok()
+              or finished_workers == workers.size()
+           );
+         }
+      );
+
+      read_status = scatter_status;
+      if (read_status.ok() and not batch_queue.empty()) {
+        *batch = std::move(batch_queue.front());
+        batch_queue.pop_front();
+        queue_signal.notify_all();
+
+        return Status::OK();
+      }
+    }
+
+    // every worker finished, or one failed
+    ARROW_RETURN_NOT_OK(Close());
+    return read_status;
+  }
+
+  /** Stops the workers (each finishes the key it is executing) and waits for them. */
+  Status ScatterBatchReader::Close() {
+    if (is_closed) { return Status::OK(); }
+    is_closed = true;
+
+    {
+      std::lock_guard<std::mutex> queue_lock { queue_mutex };
+      is_cancelled = true;
+      batch_queue.clear();
+    }
+
+    queue_signal.notify_all();
+    for (auto &worker : workers) {
+      if (worker.joinable()) { worker.join(); }
+    }
+
+    return Status::OK();
+  }
+
   //  >> Faodel adapter
   Faodel::Faodel(const string &kpool_name, const string &service_config)
     :  config_str(service_config)
       ,pool_name(kpool_name)
+      ,publish_chunk_rows(default_chunk_size)
+      ,publish_codec(arrow::Compression::UNCOMPRESSED)
+      ,scatter_threads(default_scatter_threads)
+      ,use_streaming(true)
+      ,stream_opts()
+      ,query_ctx(QueryContextForConfig(service_config))
+      ,stream_count(0)
+      ,use_result_cache(true)
+      ,max_cached_results(default_result_cache_limit)
       ,initialized(false)
       ,provided(0)
       ,mpi_rank(0)
@@ -65,10 +527,45 @@ namespace mohair::adapters {
   Faodel::Faodel(): Faodel(default_pool_name, DefaultFaodelConfig(default_pool_name)) {}
 
   //  >> Convenience methods that interface with Faodel libraries
-  /** Simple wrapper that registers a function. */
+  /**
+   * Simple wrapper that registers compute functions for Acero.
+   *
+   * The compute functions share this adapter's `query_ctx` and the streaming variant is
+   * bound to a copy of this adapter's `stream_opts`, so changes to either must be made
+   * before registration. The streaming variant publishes chunks to this adapter's pool.
+   */
   void Faodel::RegisterEngineAcero() {
     std::cout << "Registering Execution Engine: Acero" << std::endl;
-    kelpie::RegisterComputeFunction("ExecuteEngineAcero", mohair::adapters::ExecuteSubstrait);
+
+    shared_ptr<QueryContext> registered_ctx { query_ctx };
+    kelpie::RegisterComputeFunction(
+       "ExecuteEngineAcero"
+      ,[registered_ctx]( FaoBucket             b
+                        ,const KelpKey        &k
+                        ,const string         &args
+                        ,map<KelpKey, LunaDO>  fado_map
+                        ,LunaDO               *ext_ldo) {
+         return mohair::adapters::ExecuteSubstrait(
+           *registered_ctx, b, k, args, fado_map, ext_ldo
+         );
+       }
+    );
+
+    StreamOptions registered_opts { stream_opts };
+    string        registered_pool { pool_name };
+    kelpie::RegisterComputeFunction(
+       "ExecuteEngineAceroStream"
+      ,[registered_ctx, registered_opts, registered_pool]( FaoBucket             b
+                                                          ,const KelpKey        &k
+                                                          ,const string         &args
+                                                          ,map<KelpKey, LunaDO>  fado_map
+                                                          ,LunaDO               *ext_ldo) {
+         KelpPool stream_pool = kelpie::Connect(registered_pool);
+         return mohair::adapters::ExecuteSubstraitStream(
+           *registered_ctx, registered_opts, stream_pool, b, k, args, fado_map, ext_ldo
+         );
+       }
+    );
   }
 
   /** Simple wrapper that connects to a kelpie pool. */
@@ -79,38 +576,575 @@ namespace mohair::adapters {
     return lunasa::AllocateStringObject(str_obj);
   }
 
-  void Faodel::PublishTable(const shared_ptr<Table> &data, KelpPool &kpool, KelpKey &kkey) {
-    // NOTE: arrow::Compression is in arrow/util/type_fwd which is transitively imported
-    // by arrow/ipc/api.h. For now, just store the Table uncompressed (this tells faodel
-    // how to store it, not how to access it)
-    ArrowDO fado { data, arrow::Compression::UNCOMPRESSED };
+  /**
+   * Returns the codec for tables published under `kkey`: the override for its row (K1), if
+   * there is one, otherwise the pool's default (`publish_codec`). A codec that this build
+   * of Arrow doesn't support falls back to storing tables uncompressed.
+   */
+  arrow::Compression::type Faodel::CodecFor(const KelpKey &kkey) {
+    auto codec_entry = table_codecs.find(kkey.K1());
+    auto table_codec = (
+      codec_entry == table_codecs.end() ? publish_codec : codec_entry->second
+    );
+
+    if (not arrow::util::Codec::IsAvailable(table_codec)) {
+      mohair::PrintError(
+         "Codec unavailable, publishing uncompressed:"
+        ,Status::NotImplemented(arrow::util::Codec::GetCodecAsString(table_codec))
+      );
+
+      return arrow::Compression::UNCOMPRESSED;
+    }
+
+    return table_codec;
+  }
+
+  /**
+   * Returns the codec, raw bytes, and stored bytes of each table published by this
+   * adapter, keyed by the table's key (see `PublishTable`).
+   */
+  map<string, PublishStats> Faodel::PublishedStats() {
+    std::lock_guard<std::mutex> publish_lock { publish_mutex };
 
-    kpool.Publish(kkey, fado.ExportDataObject());
+    return publish_stats;
   }
 
-  Result<shared_ptr<Table>>
+  /**
+   * Publishes `data` as chunks (tables) of at most `publish_chunk_rows` rows, followed by a
+   * zone map of per-chunk statistics (see `ZoneMapForChunks`) as the object's last table.
+   *
+   * Chunks are compressed with the codec from `CodecFor`, and the raw and stored bytes of
+   * the table are recorded in `publish_stats`. The zone map is part of the object it
+   * describes, so a reader never pairs an object with another version's zone map. If a
+   * zone map can't be built, the object is published without one.
+   *
+   * If the object can't be published, an error is returned and cached results computed
+   * from `kkey` are kept, since the published version of `kkey` is unchanged.
+   */
+  Status Faodel::PublishTable(const shared_ptr<Table> &data, KelpPool &kpool, KelpKey &kkey) {
+    vector<shared_ptr<Table>> data_chunks;
+
+    int64_t chunk_rows = std::max<int64_t>(publish_chunk_rows, 1);
+    for (int64_t row_offset = 0; row_offset < data->num_rows(); row_offset += chunk_rows) {
+      data_chunks.push_back(data->Slice(row_offset, chunk_rows));
+    }
+
+    // an empty table is still published (as a single, empty chunk)
+    if (data_chunks.empty()) { data_chunks.push_back(data); }
+
+    // NOTE: each chunk is stored as a table of the fado. The codec tells faodel how to
+    // store it, not how to access it (tables are decompressed when they are extracted)
+    vector<shared_ptr<Table>> fado_tables { data_chunks };
+
+    auto zone_map = ZoneMapForChunks(data_chunks);
+    if (zone_map.ok()) { fado_tables.push_back(*zone_map); }
+    else               { mohair::PrintError("Unable to build zone map:", zone_map.status()); }
+
+    auto    table_codec = CodecFor(kkey);
+    ArrowDO fado { fado_tables, table_codec };
+    LunaDO  fado_ldo    { fado.ExportDataObject() };
+
+    // record raw (referenced by `data`) versus stored bytes, for tuning the codec policy
+    auto raw_bytes = arrow::util::ReferencedBufferSize(*data);
+    {
+      std::lock_guard<std::mutex> publish_lock { publish_mutex };
+      publish_stats[kkey.str()] = PublishStats {
+         table_codec
+        ,raw_bytes.ok() ? *raw_bytes : 0
+        ,static_cast<int64_t>(fado_ldo.GetDataSize())
+      };
+    }
+
+    // results computed from a previous version of this key are no longer valid. The
+    // version is bumped once the new version is published (see `CacheResult`)
+    if (kpool.Publish(kkey, fado_ldo) != kelpie::KELPIE_OK) {
+      return Status::IOError("Unable to publish table: ", kkey.str());
+    }
+
+    InvalidateResults(kpool, kkey);
+    return Status::OK();
+  }
+
+  /**
+   * Publishes `data` as the table that plans read by the name `tname`, at the key that
+   * the table providers look it up by (see `KeyForTableName`).
+   */
+  Status Faodel::PublishTable( const shared_ptr<Table> &data
+                              ,KelpPool                &kpool
+                              ,const vector<string>    &tname) {
+    KelpKey table_key { KeyForTableName(tname) };
+    return PublishTable(data, kpool, table_key);
+  }
+
+  /**
+   * Publishes `data` as slices of a Skytether partition, each of at most `slice_rows`
+   * rows (see `SliceKeyFor`), and returns the number of slices. A SkyRel that names some
+   * of these slices reads only those slices. The partition's schema is published first,
+   * as an empty table, so plans can be translated without reading slices.
+   *
+   * Publishing stops at the first slice that can't be published, and its error is returned.
+   */
+  Result<uint32_t>
+  Faodel::PublishSlices( const shared_ptr<Table> &data
+                        ,KelpPool                &kpool
+                        ,const string            &domain
+                        ,const string            &partition
+                        ,int64_t                  slice_rows) {
+    if (slice_rows < 1) { return Status::Invalid("Slices must contain at least 1 row"); }
+
+    SliceRequest partition_slices { domain, partition, {} };
+    uint32_t     slice_count = 0;
+
+    ARROW_ASSIGN_OR_RAISE(auto schema_table, Table::MakeEmpty(data->schema()));
+    ArrowDO schema_fado { schema_table };
+    KelpKey schema_key = PartitionSchemaKeyFor(partition_slices);
+    if (kpool.Publish(schema_key, schema_fado.ExportDataObject()) != kelpie::KELPIE_OK) {
+      return Status::IOError("Unable to publish partition schema: ", schema_key.str());
+    }
+
+    for (int64_t row_offset = 0; row_offset < data->num_rows(); row_offset += slice_rows) {
+      KelpKey slice_key = SliceKeyFor(partition_slices, slice_count++);
+      ARROW_RETURN_NOT_OK(PublishTable(data->Slice(row_offset, slice_rows), kpool, slice_key));
+    }
+
+    return slice_count;
+  }
+
+  /** Returns a row (K1) unique to this adapter to publish a result's chunks under. */
+  string Faodel::NextStreamRow() {
+    return (
+        "mohair.streams." + std::to_string(mpi_rank)
+      + "."               + std::to_string(stream_count++)
+    );
+  }
+
+  /**
+   * Executes `plan_msg` against `kkey` with the streaming compute function and returns a
+   * reader of the result (see `ExecuteSubstraitStream`), once its first chunk is read.
+   *
+   * Chunks are published under a row unique to this call. The reader waits on each chunk
+   * (see `ResultChunkReader`) while the plan is still running, and drops each chunk once
+   * it is read, unless `on_close` keeps them. If the compute function fails, chunks that
+   * were not read are dropped.
+   */
+  Result<shared_ptr<RecordBatchReader>>
+  Faodel::StreamEngineAcero( KelpPool                   &kpool
+                            ,KelpKey                    &kkey
+                            ,const shared_ptr<Buffer>   &plan_msg
+                            ,ResultChunkReader::CloseFn  on_close) {
+    string stream_row { NextStreamRow() };
+    auto   stream_reader = std::make_shared<ResultChunkReader>(
+      kpool, stream_row, -1, stream_opts.batch_size, std::move(on_close)
+    );
+
+    auto stream_signal = std::make_shared<StreamSignal>();
+    stream_reader->stream_signal  = stream_signal;
+    stream_reader->compute_thread = std::thread(
+      [ compute_pool = kpool, compute_key = kkey, stream_signal
+       ,stream_args  = stream_row + '\n' + plan_msg->ToString()]() mutable {
+        LunaDO ldo_manifest;
+        auto   compute_status = compute_pool.Compute(
+          compute_key, "ExecuteEngineAceroStream", stream_args, &ldo_manifest
+        );
+
+        std::lock_guard<std::mutex> signal_lock { stream_signal->signal_mutex };
+        stream_signal->is_computed    = true;
+        stream_signal->compute_status = compute_status;
+        stream_signal->signal.notify_all();
+      }
+    );
+
+    ARROW_RETURN_NOT_OK(stream_reader->Open());
+    return stream_reader;
+  }
+
+  /**
+   * Executes a subplan where its data is: against the key derived from its reads (see
+   * `KeyForSubplan`), so a SkyRel subplan is computed against its partition's slices.
+   */
+  Result<shared_ptr<RecordBatchReader>>
+  Faodel::ExecuteSubplan(KelpPool &kpool, const shared_ptr<Buffer> &plan_msg) {
+    auto  parse_arena    = mohair::NewPlanArena();
+    Plan& substrait_plan = *(Arena::Create<Plan>(parse_arena.get()));
+    if (not substrait_plan.ParseFromArray(plan_msg->data(), plan_msg->size())) {
+      return Status::Invalid("Unable to parse substrait plan");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto subplan_key, KeyForSubplan(substrait_plan));
+    return ExecuteEngineAcero(kpool, subplan_key, plan_msg);
+  }
+
+  /**
+   * Executes `plan_msg` against `kkey` and returns a reader of the result, which is served
+   * from (and added to) the result cache if `use_result_cache` is true. If `use_streaming`
+   * is true, the result is read as it is produced (see `StreamEngineAcero`).
+   *
+   * A result is cached as the chunks it was read from, so caching never copies it. A
+   * streamed result is only cached once it has been read in full. A reader of a result
+   * that may be cached must not outlive this adapter.
+   */
+  Result<shared_ptr<RecordBatchReader>>
   Faodel::ExecuteEngineAcero(KelpPool &kpool, KelpKey &kkey, const shared_ptr<Buffer> &plan_msg) {
-    // Execute the compute function and put the result in `ldo_result`
+    string   canonical_plan;
+    uint64_t table_version = 0;
+    KelpKey  result_key;
+
+    // Serve a previously computed result, if there is one
+    if (use_result_cache) {
+      ARROW_ASSIGN_OR_RAISE(canonical_plan, CanonicalPlanFor(*plan_msg));
+      table_version = TableVersionFor(kkey);
+      result_key    = ResultKeyFor(kkey, canonical_plan, table_version);
+
+      auto cached_reader = ReadCachedResult(kpool, kkey, result_key, canonical_plan);
+      if (cached_reader.ok()) { return cached_reader; }
+    }
+
+    // Otherwise, stream the result (caching its chunks once every chunk is read)
+    if (use_streaming) {
+      ResultChunkReader::CloseFn cache_chunks;
+      if (use_result_cache) {
+        cache_chunks = [this, kpool, kkey, result_key, canonical_plan, table_version](
+          const ResultChunkReader &closed_reader
+        ) mutable {
+          if (not closed_reader.is_complete) { return false; }
+
+          return CacheResult(
+             kpool, kkey, result_key, canonical_plan, table_version
+            ,closed_reader.chunk_row, closed_reader.chunk_ndx
+          );
+        };
+      }
+
+      return StreamEngineAcero(kpool, kkey, plan_msg, std::move(cache_chunks));
+    }
+
+    // Or, execute the compute function and put the result in `ldo_result`
     LunaDO ldo_result;
-    kpool.Compute(kkey, "ExecuteEngineAcero", plan_msg->ToString(), &ldo_result);
+    auto   compute_status = kpool.Compute(
+      kkey, "ExecuteEngineAcero", plan_msg->ToString(), &ldo_result
+    );
 
-    // Wrap the faodel result in an arrow data object (faodel-lunasa -> faodel-arrow)
-    ArrowDO fado_result { ldo_result };
-    const auto table_count = fado_result.NumberOfTables();
+    if (compute_status != kelpie::KELPIE_OK) {
+      return Status::ExecutionError("Compute function failed for key: ", kkey.str());
+    }
 
-    // Prepare a vector to store each table result
-    std::vector<shared_ptr<Table>> table_list;
-    table_list.reserve(table_count);
+    // The result is a single chunk; cache it, unless it is stale
+    string result_row { NextStreamRow() };
+    if (use_result_cache) {
+      KelpKey chunk_key = StreamChunkKeyFor(result_row, 0);
+      if (kpool.Publish(chunk_key, ldo_result) == kelpie::KELPIE_OK) {
+        bool is_cached = CacheResult(
+          kpool, kkey, result_key, canonical_plan, table_version, result_row, 1
+        );
 
-    // Walk each table in the faodel object and extract each into the vector
-    for (int table_ndx = 0; table_ndx < table_count; ++table_ndx) {
-      ARROW_ASSIGN_OR_RAISE(auto fado_subtable, fado_result.ExtractTable(table_ndx));
-      table_list.emplace_back(fado_subtable);
+        if (not is_cached) { kpool.Drop(chunk_key); }
+      }
     }
 
-    return arrow::ConcatenateTables(table_list);
+    // Read the tables of the faodel result as they are extracted
+    auto result_reader = std::make_shared<ResultChunkReader>(
+      kpool, result_row, 1, stream_opts.batch_size
+    );
+
+    result_reader->held_chunks.push_back(ldo_result);
+    ARROW_RETURN_NOT_OK(result_reader->Open());
+
+    return result_reader;
   }
 
+  //  >> Methods for executing a plan against many keys (scatter/gather)
+
+  /**
+   * Returns each key in the pool that matches `key_pattern`, which may have a wildcard
+   * suffix (e.g. `{"expression", "*"}`).
+   */
+  Result<vector<KelpKey>> Faodel::KeysForPattern(KelpPool &kpool, const KelpKey &key_pattern) {
+    kelpie::ObjectCapacities key_listing;
+
+    auto list_status = kpool.List(key_pattern, &key_listing);
+    if (list_status != kelpie::KELPIE_OK) {
+      return Status::KeyError("Unable to list keys for: ", key_pattern.str());
+    }
+
+    return key_listing.keys;
+  }
+
+  /**
+   * Executes `plan_msgs[i]` against `kkeys[i]` concurrently and returns a reader of the
+   * merged results. This is how each branch of a split set operation (see `SetBranches`)
+   * is pushed to the key holding its partition.
+   *
+   * Keys are executed (see `ExecuteEngineAcero`) by at most `scatter_threads` workers,
+   * and batches of each partial result are read as they are produced (see
+   * `ScatterBatchReader`). The reader is returned once the first partial result can be
+   * read (its schema is the reader's schema), or with the error of any execution that
+   * fails first.
+   */
+  Result<shared_ptr<RecordBatchReader>>
+  Faodel::ScatterEngineAcero( KelpPool                         &kpool
+                             ,const vector<KelpKey>            &kkeys
+                             ,const vector<shared_ptr<Buffer>> &plan_msgs) {
+    if (kkeys.empty()) { return Status::Invalid("No keys to execute plan against"); }
+    if (kkeys.size() != plan_msgs.size()) {
+      return Status::Invalid("Expected a plan for each key");
+    }
+
+    size_t worker_count = std::min(kkeys.size(), std::max<size_t>(scatter_threads, 1));
+    ARROW_ASSIGN_OR_RAISE(
+       auto scatter_reader
+      ,ScatterBatchReader::Make(this, kpool, kkeys, plan_msgs, worker_count)
+    );
+
+    return scatter_reader;
+  }
+
+  /** Executes the same `plan_msg` against each key in `kkeys` (see above). */
+  Result<shared_ptr<RecordBatchReader>>
+  Faodel::ScatterEngineAcero( KelpPool                 &kpool
+                             ,const vector<KelpKey>    &kkeys
+                             ,const shared_ptr<Buffer> &plan_msg) {
+    vector<shared_ptr<Buffer>> plan_msgs(kkeys.size(), plan_msg);
+    return ScatterEngineAcero(kpool, kkeys, plan_msgs);
+  }
+
+  /** Convenience overload that executes `plan_msg` against each key matching a pattern. */
+  Result<shared_ptr<RecordBatchReader>>
+  Faodel::ScatterEngineAcero( KelpPool                 &kpool
+                             ,const KelpKey            &key_pattern
+                             ,const shared_ptr<Buffer> &plan_msg) {
+    ARROW_ASSIGN_OR_RAISE(auto kkeys, KeysForPattern(kpool, key_pattern));
+    return ScatterEngineAcero(kpool, kkeys, plan_msg);
+  }
+
+
+  //  >> Methods for caching subplan results
+
+  /** Returns the canonical form of a serialized subplan (see `CanonicalPlanString`). */
+  Result<string> Faodel::CanonicalPlanFor(const Buffer &plan_msg) {
+    Plan substrait_plan;
+    if (not substrait_plan.ParseFromArray(plan_msg.data(), plan_msg.size())) {
+      return Status::Invalid("Unable to parse substrait plan");
+    }
+
+    return mohair::CanonicalPlanString(substrait_plan);
+  }
+
+  /** Returns the version of `kkey`, which is bumped whenever it is published. */
+  uint64_t Faodel::TableVersionFor(const KelpKey &kkey) {
+    std::lock_guard<std::mutex> result_lock { result_mutex };
+
+    auto version_entry = table_versions.find(kkey);
+    return version_entry == table_versions.end() ? 0 : version_entry->second;
+  }
+
+  /**
+   * Derives the key that a subplan's result is cached under (its chunks are published
+   * under their own row, see `CachedResult`).
+   *
+   * The key combines the source key, the version of the source key (see `PublishTable`)
+   * and a hash of the canonical form of the subplan. Hashes may collide, so a cached
+   * result is only served for the exact canonical plan it was computed for (see
+   * `AcquireCachedResult`).
+   */
+  KelpKey Faodel::ResultKeyFor( const KelpKey &kkey
+                               ,const string  &canonical_plan
+                               ,uint64_t       table_version) {
+    size_t plan_hash = std::hash<string>{}(canonical_plan);
+
+    return KelpKey {
+       "mohair.results." + kkey.K1() + "." + kkey.K2()
+      ,std::to_string(plan_hash) + ".v" + std::to_string(table_version)
+    };
+  }
+
+  /**
+   * Acquires the cached result under `result_key`, if it was cached by `CacheResult` for
+   * `canonical_plan` and its chunks are still in the pool (checked without blocking). An
+   * acquired result is not dropped until it is released (see `ReleaseCachedResult`), so
+   * its chunks can be read with `Need`. Returns an error if the result must be computed.
+   */
+  Result<CachedResult> Faodel::AcquireCachedResult( KelpPool      &kpool
+                                                   ,const KelpKey &kkey
+                                                   ,const KelpKey &result_key
+                                                   ,const string  &canonical_plan) {
+    std::lock_guard<std::mutex> result_lock { result_mutex };
+
+    auto result_entry = cached_results.find(result_key);
+    if (result_entry == cached_results.end()) {
+      return Status::KeyError("No cached result for: ", result_key.str());
+    }
+
+    auto &cached_result = result_entry->second;
+    if (
+           cached_result.is_stale
+        or cached_result.source_key     != kkey
+        or cached_result.canonical_plan != canonical_plan
+    ) {
+      return Status::KeyError("No cached result for: ", result_key.str());
+    }
+
+    // chunks may have been dropped from the pool by someone else (then, the result is only
+    // forgotten, since what is left of it can't be served)
+    for (const auto &chunk_key : cached_result.ChunkKeys()) {
+      kelpie::object_info_t chunk_info;
+      if (kpool.Info(chunk_key, &chunk_info) == kelpie::KELPIE_OK) { continue; }
+
+      vector<KelpKey> gone_keys;
+      RetireResult(result_key, &gone_keys);
+      return Status::KeyError("Cached result chunk unavailable: ", chunk_key.str());
+    }
+
+    ++cached_result.reader_count;
+    return cached_result;
+  }
+
+  /** Releases a result acquired by `AcquireCachedResult`, dropping it if it is stale. */
+  void Faodel::ReleaseCachedResult(KelpPool &kpool, const KelpKey &result_key) {
+    vector<KelpKey> drop_keys;
+    {
+      std::lock_guard<std::mutex> result_lock { result_mutex };
+
+      auto result_entry = cached_results.find(result_key);
+      if (result_entry == cached_results.end()) { return; }
+
+      auto &cached_result = result_entry->second;
+      if (--cached_result.reader_count == 0 and cached_result.is_stale) {
+        drop_keys = cached_result.ChunkKeys();
+        cached_results.erase(result_entry);
+      }
+    }
+
+    for (const auto &drop_key : drop_keys) { kpool.Drop(drop_key); }
+  }
+
+  /**
+   * Returns a reader of the cached result under `result_key` (see `AcquireCachedResult`),
+   * which holds the result until it is closed. Returns an error if the result must be
+   * computed instead.
+   */
+  Result<shared_ptr<RecordBatchReader>>
+  Faodel::ReadCachedResult( KelpPool      &kpool
+                           ,const KelpKey &kkey
+                           ,const KelpKey &result_key
+                           ,const string  &canonical_plan) {
+    ARROW_ASSIGN_OR_RAISE(
+      auto cached_result, AcquireCachedResult(kpool, kkey, result_key, canonical_plan)
+    );
+
+    auto cached_reader = std::make_shared<ResultChunkReader>(
+       kpool
+      ,cached_result.chunk_row
+      ,cached_result.chunk_count
+      ,stream_opts.batch_size
+      ,[this, kpool, result_key](const ResultChunkReader &) mutable {
+         ReleaseCachedResult(kpool, result_key);
+         return true;
+       }
+    );
+
+    ARROW_RETURN_NOT_OK(cached_reader->Open());
+    return cached_reader;
+  }
+
+  /**
+   * Marks a cached result as stale, so it is no longer served, and removes it from the
+   * eviction order. If no reader holds it, it is forgotten and the keys of its chunks are
+   * appended to `drop_keys`; otherwise, its last reader drops it. Must be called with
+   * `result_mutex`.
+   */
+  void Faodel::RetireResult(const KelpKey &result_key, vector<KelpKey> *drop_keys) {
+    auto result_entry = cached_results.find(result_key);
+    if (result_entry == cached_results.end()) { return; }
+
+    result_order.erase(
+      std::remove(result_order.begin(), result_order.end(), result_key), result_order.end()
+    );
+
+    auto &cached_result = result_entry->second;
+    if (cached_result.reader_count > 0) {
+      cached_result.is_stale = true;
+      return;
+    }
+
+    for (const auto &chunk_key : cached_result.ChunkKeys()) { drop_keys->push_back(chunk_key); }
+    cached_results.erase(result_entry);
+  }
+
+  /**
+   * Caches a subplan result for `kkey`, already published as `chunk_count` chunks under
+   * `chunk_row`, so that it can be served for later requests. Returns true if the cache
+   * now owns the chunks; otherwise, the caller must drop them.
+   *
+   * `table_version` is the version of `kkey` when the result's computation started. If
+   * `kkey` was published since then, the result may be stale, so it is not cached. The
+   * version is checked and the result indexed under `result_mutex`, so a concurrent
+   * `InvalidateResults` either drops the result or it is never cached.
+   *
+   * If more than `max_cached_results` results are cached, the oldest are evicted.
+   */
+  bool Faodel::CacheResult( KelpPool      &kpool
+                           ,const KelpKey &kkey
+                           ,const KelpKey &result_key
+                           ,const string  &canonical_plan
+                           ,uint64_t       table_version
+                           ,const string  &chunk_row
+                           ,int64_t        chunk_count) {
+    vector<KelpKey> drop_keys;
+    {
+      std::lock_guard<std::mutex> result_lock { result_mutex };
+
+      if (table_versions[kkey] != table_version) { return false; }
+      if (cached_results.count(result_key))      { return false; }
+      if (max_cached_results == 0)               { return false; }
+
+      cached_results.emplace(
+         result_key
+        ,CachedResult { kkey, canonical_plan, chunk_row, chunk_count, 0, false }
+      );
+      result_order.push_back(result_key);
+
+      while (result_order.size() > max_cached_results) {
+        RetireResult(result_order.front(), &drop_keys);
+      }
+    }
+
+    for (const auto &drop_key : drop_keys) { kpool.Drop(drop_key); }
+    return true;
+  }
+
+  /**
+   * Drops every cached result computed from `kkey` and bumps the version of `kkey`. This
+   * is called after a new version of `kkey` is published, so that a computation that
+   * started before the bump is never cached under the new version. Results computed from
+   * every column of `kkey`'s row (e.g. a partition, see `PartitionKeyFor`) are dropped, too.
+   * A result that is being served is dropped once it is released.
+   *
+   * NOTE: versions and cached results are tracked by this adapter, so only tables that
+   * are published through this adapter invalidate its cached results.
+   */
+  void Faodel::InvalidateResults(KelpPool &kpool, const KelpKey &kkey) {
+    KelpKey         row_pattern { kkey.K1(), "*" };
+    vector<KelpKey> drop_keys;
+    {
+      std::lock_guard<std::mutex> result_lock { result_mutex };
+
+      ++table_versions[kkey];
+      ++table_versions[row_pattern];
+
+      vector<KelpKey> stale_keys;
+      for (const auto &[result_key, cached_result] : cached_results) {
+        if (cached_result.source_key == kkey or cached_result.source_key == row_pattern) {
+          stale_keys.push_back(result_key);
+        }
+      }
+
+      for (const auto &stale_key : stale_keys) { RetireResult(stale_key, &drop_keys); }
+    }
+
+    for (const auto &drop_key : drop_keys) { kpool.Drop(drop_key); }
+  }
+
+
   //  >> Convenience methods that interface with MPI
   /** Simple wrapper that uses mpisyncstart to setup dirman. */
   void Faodel::Bootstrap(int argc, char **argv) {
@@ -166,7 +1200,9 @@ namespace mohair::adapters {
    * approach is for transitional purposes.
    */
   NamedTableProvider Faodel::FadoTableProvider() {
-    return mohair::adapters::ProviderForFadoMap(this->fado_map);
+    return mohair::adapters::ProviderForFadoMap(
+      this->fado_map, default_batch_size, KelpKey {}, query_ctx->QueryExecutor()
+    );
   }
 
   // end of Faodel class functions
@@ -0,0 +1,465 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "adapter_files.hpp"
+
+#include <algorithm>
+
+
+// ------------------------------
+// Functions
+
+namespace mohair::adapters {
+
+  // >> Internal functions only
+  namespace {
+
+    /** True if `file_path` ends with one of `file_exts`. */
+    bool HasFileExtension(const string &file_path, const vector<string> &file_exts) {
+      for (const auto &file_ext : file_exts) {
+        bool has_ext = (
+              file_path.size() > file_ext.size()
+          and file_path.compare(
+                file_path.size() - file_ext.size(), file_ext.size(), file_ext
+              ) == 0
+        );
+
+        if (has_ext) { return true; }
+      }
+
+      return false;
+    }
+
+    /** Returns the format of a file with a known extension (false otherwise). */
+    bool FormatForFilePath(const string &file_path, TableFormat *file_format) {
+      if (IsIPCFilePath(file_path)) {
+        *file_format = TableFormat::IPC;
+        return true;
+      }
+
+      if (IsParquetFilePath(file_path)) {
+        *file_format = TableFormat::Parquet;
+        return true;
+      }
+
+      return false;
+    }
+
+    /**
+     * Returns a ScannerBuilder over `file_table` (a fragment per file) that reads only the
+     * fields in `column_names` (in that order) and reads up to `fragment_readahead` files
+     * concurrently on Arrow's CPU pool.
+     */
+    Result<shared_ptr<ScannerBuilder>>
+    ScanBuilderForFiles( const FileTable        &file_table
+                        ,shared_ptr<FileFormat>  file_format
+                        ,const FileScanOptions  &scan_opts
+                        ,const vector<string>   &column_names) {
+      ARROW_ASSIGN_OR_RAISE(
+         auto dataset_factory
+        ,FileSystemDatasetFactory::Make(
+            file_table.file_system
+           ,file_table.file_paths
+           ,std::move(file_format)
+           ,FileSystemFactoryOptions {}
+         )
+      );
+
+      ARROW_ASSIGN_OR_RAISE(auto dataset     , dataset_factory->Finish());
+      ARROW_ASSIGN_OR_RAISE(auto scan_builder, dataset->NewScan());
+
+      if (not column_names.empty()) { ARROW_RETURN_NOT_OK(scan_builder->Project(column_names)); }
+      ARROW_RETURN_NOT_OK(scan_builder->UseThreads(true));
+      ARROW_RETURN_NOT_OK(scan_builder->BatchSize(scan_opts.batch_size));
+      ARROW_RETURN_NOT_OK(scan_builder->FragmentReadahead(scan_opts.fragment_readahead));
+      ARROW_RETURN_NOT_OK(scan_builder->BatchReadahead(scan_opts.batch_readahead));
+
+      return scan_builder;
+    }
+
+    /** Returns a Declaration for a source node over the batches of a dataset scan. */
+    Result<Declaration> SourceForScan(ScannerBuilder &scan_builder, const string &tname) {
+      ARROW_ASSIGN_OR_RAISE(auto scanner    , scan_builder.Finish());
+      ARROW_ASSIGN_OR_RAISE(auto scan_reader, scanner->ToRecordBatchReader());
+
+      return Declaration(
+         "record_batch_reader_source"
+        ,RecordBatchReaderSourceNodeOptions { std::move(scan_reader) }
+        ,tname
+      );
+    }
+
+  } // anonymous namespace for internal functions
+
+
+  // >> Functions to resolve named tables to files
+
+  /**
+   * Returns the FileSystem for a root directory given as a URI or an absolute path, and
+   * sets `root_path` to the directory's path within it. A local root is accessed with
+   * memory-mapping, so that batches reference the page cache rather than copies.
+   */
+  Result<shared_ptr<FileSystem>> FileSystemForRoot(const string &root_uri, string *root_path) {
+    ARROW_ASSIGN_OR_RAISE(
+       auto root_fs
+      ,arrow::fs::FileSystemFromUriOrPath(root_uri, root_path)
+    );
+
+    while (root_path->size() > 1 and root_path->back() == '/') { root_path->pop_back(); }
+
+    if (root_fs->type_name() == "local") {
+      auto local_opts     = arrow::fs::LocalFileSystemOptions::Defaults();
+      local_opts.use_mmap = true;
+
+      return std::make_shared<arrow::fs::LocalFileSystem>(local_opts);
+    }
+
+    return root_fs;
+  }
+
+  /** True if `file_path` has one of the `ipc_file_extensions`. */
+  bool IsIPCFilePath(const string &file_path) {
+    return HasFileExtension(file_path, ipc_file_extensions);
+  }
+
+  /** True if `file_path` has one of the `parquet_file_extensions`. */
+  bool IsParquetFilePath(const string &file_path) {
+    return HasFileExtension(file_path, parquet_file_extensions);
+  }
+
+  /**
+   * Resolves a table name to the files under `root_path` that serve it. The parts of the
+   * name are path components, so ["tpch", "lineitem"] is served by the first of:
+   *  - <root>/tpch/lineitem, if it is an IPC or Parquet file
+   *  - <root>/tpch/lineitem.<ext>, for each IPC then Parquet extension
+   *  - every IPC or Parquet file under the directory <root>/tpch/lineitem (as a dataset);
+   *    a directory that has files of both formats is invalid
+   */
+  Result<FileTable> FileTableFor( const shared_ptr<FileSystem> &file_system
+                                 ,const string                 &root_path
+                                 ,const vector<string>         &tname) {
+    auto requested_tname = mohair::JoinStr(tname, ".");
+
+    // names are paths under the root, so a name may not leave it
+    for (const auto &name_part : tname) {
+      bool is_invalid = (
+           name_part.empty() or name_part == "." or name_part == ".."
+        or name_part.find('/') != string::npos
+      );
+
+      if (is_invalid) {
+        return Status::Invalid("Invalid table name: [", requested_tname, "]");
+      }
+    }
+
+    string    table_path { root_path + "/" + mohair::JoinStr(tname, "/") };
+    FileTable file_table { file_system, {}, TableFormat::IPC, false };
+
+    // a single file, named with or without its extension
+    ARROW_ASSIGN_OR_RAISE(auto table_info, file_system->GetFileInfo(table_path));
+    if (table_info.IsFile() and FormatForFilePath(table_path, &file_table.file_format)) {
+      file_table.file_paths.push_back(table_path);
+      return file_table;
+    }
+
+    vector<string> file_exts { ipc_file_extensions };
+    file_exts.insert(
+      file_exts.end(), parquet_file_extensions.begin(), parquet_file_extensions.end()
+    );
+
+    for (const auto &file_ext : file_exts) {
+      ARROW_ASSIGN_OR_RAISE(auto file_info, file_system->GetFileInfo(table_path + file_ext));
+      if (file_info.IsFile()) {
+        FormatForFilePath(file_info.path(), &file_table.file_format);
+        file_table.file_paths.push_back(file_info.path());
+        return file_table;
+      }
+    }
+
+    // a directory of files, where each file is a fragment of the dataset
+    if (table_info.IsDirectory()) {
+      FileSelector dir_selector;
+      dir_selector.base_dir  = table_path;
+      dir_selector.recursive = true;
+
+      vector<string> ipc_paths;
+      vector<string> parquet_paths;
+
+      ARROW_ASSIGN_OR_RAISE(auto file_infos, file_system->GetFileInfo(dir_selector));
+      for (const auto &file_info : file_infos) {
+        if      (not file_info.IsFile())              { continue; }
+        else if (IsIPCFilePath(file_info.path()))     { ipc_paths.push_back(file_info.path()); }
+        else if (IsParquetFilePath(file_info.path())) { parquet_paths.push_back(file_info.path()); }
+      }
+
+      if (not ipc_paths.empty() and not parquet_paths.empty()) {
+        return Status::Invalid(
+          "Table [", requested_tname, "] has both IPC and Parquet files"
+        );
+      }
+
+      if (parquet_paths.empty()) { file_table.file_paths = std::move(ipc_paths); }
+      else {
+        file_table.file_paths  = std::move(parquet_paths);
+        file_table.file_format = TableFormat::Parquet;
+      }
+
+      // fragments are scanned in a stable order
+      std::sort(file_table.file_paths.begin(), file_table.file_paths.end());
+      file_table.is_directory = true;
+
+      if (not file_table.file_paths.empty()) { return file_table; }
+    }
+
+    return Status::KeyError("File table provider could not find table: [", requested_tname, "]");
+  }
+
+
+  // >> Functions to push filters into dataset scans
+
+  /**
+   * Returns a filter expression that is the conjunction of `zone_preds`, where each
+   * literal is converted to the type of its column in `dataset_schema` (see
+   * `LiteralForType`). A predicate on a column that is not in the dataset, or whose literal
+   * does not convert exactly, is left out (the plan's own filter still applies), so the
+   * filter may keep rows that the plan drops but never drops rows that the plan keeps.
+   */
+  Expression FilterForZonePredicates( const vector<ZonePredicate> &zone_preds
+                                     ,const Schema                &dataset_schema) {
+    vector<Expression> pred_exprs;
+
+    for (const auto &zone_pred : zone_preds) {
+      auto pred_field = dataset_schema.GetFieldByName(zone_pred.column_name);
+      if (pred_field == nullptr) { continue; }
+
+      auto column_ref = arrow::compute::field_ref(zone_pred.column_name);
+      if (zone_pred.op == ZoneOp::IsNull) {
+        pred_exprs.push_back(arrow::compute::is_null(column_ref));
+        continue;
+      }
+
+      if (zone_pred.op == ZoneOp::IsNotNull) {
+        pred_exprs.push_back(arrow::compute::is_valid(column_ref));
+        continue;
+      }
+
+      // a literal that doesn't convert exactly to the column's type is not pushed down
+      auto literal = LiteralForType(zone_pred, pred_field->type());
+      if (not literal.ok()) { continue; }
+
+      auto literal_expr = arrow::compute::literal(*literal);
+      switch (zone_pred.op) {
+        case ZoneOp::Equal: {
+          pred_exprs.push_back(arrow::compute::equal(column_ref, literal_expr));
+          break;
+        }
+
+        case ZoneOp::Less: {
+          pred_exprs.push_back(arrow::compute::less(column_ref, literal_expr));
+          break;
+        }
+
+        case ZoneOp::LessEqual: {
+          pred_exprs.push_back(arrow::compute::less_equal(column_ref, literal_expr));
+          break;
+        }
+
+        case ZoneOp::Greater: {
+          pred_exprs.push_back(arrow::compute::greater(column_ref, literal_expr));
+          break;
+        }
+
+        case ZoneOp::GreaterEqual: {
+          pred_exprs.push_back(arrow::compute::greater_equal(column_ref, literal_expr));
+          break;
+        }
+
+        default: { break; }
+      }
+    }
+
+    return arrow::compute::and_(pred_exprs);
+  }
+
+
+  // >> Functions that produce source Declarations for files
+
+  /**
+   * Returns a Declaration for a source node that reads a single IPC file (see
+   * `IPCFileBatchReader`). The file is opened once, through the table's file system, only
+   * the fields in `column_names` are decoded, and up to `batch_readahead` batches are read
+   * ahead of the source node.
+   *
+   * Included fields are always read in file order, so a projection that reorders fields
+   * is left to a dataset scan (see `SourceForIPCDataset`).
+   */
+  Result<Declaration> SourceForIPCFile( const FileTable       &file_table
+                                       ,const string          &tname
+                                       ,const FileScanOptions &scan_opts
+                                       ,const vector<string>  &column_names) {
+    const string &file_path = file_table.file_paths.front();
+
+    // the file is opened once, through the table's file system. Opening a reader only
+    // reads the file's footer (which has the schema)
+    ARROW_ASSIGN_OR_RAISE(auto file_handle, file_table.file_system->OpenInputFile(file_path));
+    ARROW_ASSIGN_OR_RAISE(
+       auto schema_reader
+      ,arrow::ipc::RecordBatchFileReader::Open(file_handle)
+    );
+
+    auto file_schema = schema_reader->schema();
+
+    IPCSelection selection;
+    selection.prefetch_count = scan_opts.batch_readahead;
+    for (const auto &column_name : column_names) {
+      int field_ndx = file_schema->GetFieldIndex(column_name);
+      if (field_ndx < 0) {
+        return Status::KeyError(
+          "Column [", column_name, "] not found in file: [", file_path, "]"
+        );
+      }
+
+      selection.field_ndxs.push_back(field_ndx);
+    }
+
+    if (not std::is_sorted(selection.field_ndxs.begin(), selection.field_ndxs.end())) {
+      return SourceForIPCDataset(file_table, tname, scan_opts, column_names);
+    }
+
+    // readers of the selected fields share the handle
+    ARROW_ASSIGN_OR_RAISE(auto batch_reader, mohair::OpenIPCFile(file_handle, selection));
+
+    return Declaration(
+       "record_batch_reader_source"
+      ,RecordBatchReaderSourceNodeOptions { std::move(batch_reader) }
+      ,tname
+    );
+  }
+
+  /**
+   * Returns a Declaration for a source node that scans IPC files as an Arrow dataset,
+   * where each file is a fragment. Up to `fragment_readahead` files are read concurrently
+   * on Arrow's CPU pool, only the fields in `column_names` are read (in that order), and
+   * batches are produced in fragment order.
+   */
+  Result<Declaration> SourceForIPCDataset( const FileTable       &file_table
+                                          ,const string          &tname
+                                          ,const FileScanOptions &scan_opts
+                                          ,const vector<string>  &column_names) {
+    ARROW_ASSIGN_OR_RAISE(
+       auto scan_builder
+      ,ScanBuilderForFiles(
+         file_table, std::make_shared<IpcFileFormat>(), scan_opts, column_names
+       )
+    );
+
+    return SourceForScan(*scan_builder, tname);
+  }
+
+  /**
+   * Like `SourceForIPCDataset`, but for Parquet files. The conjunction of `zone_preds` is
+   * the scan's filter, so row groups whose statistics (min, max and null count) rule out
+   * the filter are never read. Only the column chunks of projected fields are read and,
+   * if `pre_buffer` is set, the chunks of a row group are fetched with coalesced range
+   * reads that are issued together rather than one column at a time.
+   */
+  Result<Declaration> SourceForParquetDataset( const FileTable             &file_table
+                                              ,const string                &tname
+                                              ,const FileScanOptions       &scan_opts
+                                              ,const vector<string>        &column_names
+                                              ,const vector<ZonePredicate> &zone_preds) {
+    auto parquet_opts = std::make_shared<ParquetFragmentScanOptions>();
+    parquet_opts->arrow_reader_properties->set_pre_buffer(scan_opts.pre_buffer);
+    parquet_opts->arrow_reader_properties->set_cache_options(scan_opts.cache_options);
+
+    auto parquet_format = std::make_shared<ParquetFileFormat>();
+    parquet_format->default_fragment_scan_options = parquet_opts;
+
+    ARROW_ASSIGN_OR_RAISE(
+       auto scan_builder
+      ,ScanBuilderForFiles(file_table, parquet_format, scan_opts, column_names)
+    );
+
+    if (not zone_preds.empty()) {
+      ARROW_RETURN_NOT_OK(scan_builder->Filter(
+        FilterForZonePredicates(zone_preds, *(scan_builder->schema()))
+      ));
+    }
+
+    return SourceForScan(*scan_builder, tname);
+  }
+
+  /**
+   * Returns a Declaration for a source node that reads the files of `file_table`. Parquet
+   * files are always scanned as a dataset (see `SourceForParquetDataset`). A local IPC
+   * file is read directly and anything else (directories or remote files) is scanned as
+   * a dataset.
+   */
+  Result<Declaration> SourceForFileTable( const FileTable             &file_table
+                                         ,const string                &tname
+                                         ,const FileScanOptions       &scan_opts
+                                         ,const vector<string>        &column_names
+                                         ,const vector<ZonePredicate> &zone_preds) {
+    if (file_table.file_format == TableFormat::Parquet) {
+      return SourceForParquetDataset(file_table, tname, scan_opts, column_names, zone_preds);
+    }
+
+    if (file_table.is_directory or not file_table.IsLocal()) {
+      return SourceForIPCDataset(file_table, tname, scan_opts, column_names);
+    }
+
+    return SourceForIPCFile(file_table, tname, scan_opts, column_names);
+  }
+
+  /**
+   * Convenience higher-order function that returns a `NamedTableProvider` for IPC
+   * (Feather V2) and Parquet files under `root_uri` (see `FileTableFor`).
+   *
+   * Like `ProviderForFadoMap`, each source reads only the columns in the table schema
+   * (all columns, if the schema is empty). The zone predicates in the schema's metadata
+   * are used to skip Parquet row groups; IPC files have no per-batch statistics, so they
+   * are not used for IPC files.
+   */
+  NamedTableProvider ProviderForDirectory( const string          &root_uri
+                                          ,const FileScanOptions &scan_opts) {
+    // registers the dataset "scan" node, which dataset scanners execute with
+    arrow::dataset::internal::Initialize();
+
+    string root_path;
+    auto   root_fs = FileSystemForRoot(root_uri, &root_path);
+
+    return [root_fs, root_path, scan_opts]( const vector<string> &tname
+                                           ,const Schema         &tschema) -> Result<Declaration> {
+      if (not root_fs.ok()) { return root_fs.status(); }
+
+      ARROW_ASSIGN_OR_RAISE(auto file_table, FileTableFor(*root_fs, root_path, tname));
+
+      return SourceForFileTable(
+         file_table
+        ,mohair::JoinStr(tname, ".")
+        ,scan_opts
+        ,tschema.field_names()
+        ,ZonePredicatesForSchema(tschema)
+      );
+    };
+  }
+
+} // namespace: mohair::adapters
@@ -33,12 +33,15 @@
 #include <fstream>
 
 #include <vector>
+#include <deque>
+#include <unordered_map>
 
 // >> Third-party libs
 //  |> Arrow
 #include <arrow/api.h>
 #include <arrow/ipc/api.h>
 #include <arrow/filesystem/api.h>
+#include <arrow/util/future.h>
 
 
 // ------------------------------
@@ -84,11 +87,142 @@ namespace mohair {
   fstream OutputStreamForFile(const char *out_fpath);
   bool    FileToString(const char *in_fpath, string &file_data);
 
+  /**
+   * How an Arrow IPC file is accessed: by reads through a FileSystem (which copy file data
+   * into buffers) or by mapping the file into memory (buffers reference the mapped pages).
+   */
+  enum class IPCAccess : uint8_t { Buffered, MemoryMapped };
+
+  /**
+   * A selection of an Arrow IPC file: top-level fields (by index) and a range of batches,
+   * [batch_begin, batch_end). An empty `field_ndxs` selects every field and a negative
+   * `batch_end` selects through the last batch. Unselected fields are never decoded.
+   *
+   * If `prefetch_count` is positive, up to that many batches are read (and decoded) ahead
+   * of the reader, concurrently, on Arrow's CPU pool.
+   */
+  struct IPCSelection {
+    vector<int> field_ndxs;
+    int         batch_begin    { 0 };
+    int         batch_end      { -1 };
+    int         prefetch_count { 0 };
+  };
+
+  /**
+   * A RecordBatchReader over a range of batches of an Arrow IPC file, each read (by index
+   * in the file's footer) only when it is requested. For a memory-mapped file, batches
+   * reference the mapped pages, so opening the reader only reads the file's footer and
+   * batches are never copied.
+   *
+   * Each prefetch reader is a separate file reader over the same file handle, and batch
+   * `i` is always read by `prefetch_readers[i % prefetch_readers.size()]`. At most one
+   * read per prefetch reader is pending, since a batch is only prefetched once the batch
+   * `prefetch_readers.size()` before it has been consumed.
+   */
+  struct IPCFileBatchReader : public arrow::RecordBatchReader {
+    using FileReader  = arrow::ipc::RecordBatchFileReader;
+    using BatchFuture = arrow::Future<shared_ptr<arrow::RecordBatch>>;
+
+    shared_ptr<FileReader>         file_reader;
+    vector<shared_ptr<FileReader>> prefetch_readers;
+    std::deque<BatchFuture>        prefetched_batches;
+    int                            batch_ndx;
+    int                            batch_end;
+
+    IPCFileBatchReader(shared_ptr<FileReader> reader, int begin_ndx, int end_ndx)
+      : file_reader(std::move(reader)), batch_ndx(begin_ndx), batch_end(end_ndx) {}
+
+    void               PrefetchBatches();
+    shared_ptr<Schema> schema() const override;
+    Status             ReadNext(shared_ptr<arrow::RecordBatch> *batch) override;
+  };
+
+  Result<shared_ptr<Table>>
+  ReadIPCFile(const string &path_to_file, IPCAccess file_access = IPCAccess::Buffered);
+
   Result<shared_ptr<Table>>
-  ReadIPCFile(const string &path_to_file);
+  ReadIPCFile( const string       &path_to_file
+              ,const IPCSelection &selection
+              ,IPCAccess           file_access = IPCAccess::MemoryMapped);
 
   Result<shared_ptr<Table>>
-  ReadIPCStream(const string &path_to_file);
+  ReadIPCStream(const string &path_to_file, IPCAccess file_access = IPCAccess::Buffered);
+
+  Result<shared_ptr<IPCFileBatchReader>>
+  OpenIPCFile(const string &path_to_file, IPCAccess file_access = IPCAccess::MemoryMapped);
+
+  Result<shared_ptr<IPCFileBatchReader>>
+  OpenIPCFile( const string       &path_to_file
+              ,const IPCSelection &selection
+              ,IPCAccess           file_access = IPCAccess::MemoryMapped);
+
+  Result<shared_ptr<IPCFileBatchReader>>
+  OpenIPCFile( const shared_ptr<arrow::io::RandomAccessFile> &file_handle
+              ,const IPCSelection                            &selection);
+
+  //  >> Statistics for estimating plan costs
+
+  // Bytes per value assumed for variable-width types (e.g. strings)
+  constexpr int64_t default_varwidth_bytes = 32;
+
+  /** Row count and (estimated) bytes per row of a source table. */
+  struct TableStats {
+    int64_t row_count { 0 };
+    int64_t row_width { 0 };
+  };
+
+  using StatsMap = std::unordered_map<string, TableStats>;
+
+  int64_t            EstimateRowWidth(const Schema &table_schema);
+  TableStats         StatsForTable(const Table &table_data);
+  Result<TableStats> StatsForIPCFile(const string &path_to_file);
+
+  //  >> Zone maps (per-chunk statistics for skipping chunks)
+
+  // Key of the schema metadata that carries the zone predicates of a read
+  const string zone_predicates_key { "mohair.zone_predicates" };
+
+  // Key of the schema metadata that marks a table as a zone map (see `ZoneMapForChunks`)
+  const string zone_map_key { "mohair.zone_map" };
+
+  // Comparisons that can be decided from a chunk's min, max and null count
+  enum class ZoneOp : uint8_t {
+     Equal
+    ,Less
+    ,LessEqual
+    ,Greater
+    ,GreaterEqual
+    ,IsNull
+    ,IsNotNull
+  };
+
+  /**
+   * A comparison of a column to a literal (unused for null checks), as a string. The
+   * literal's own type is kept (if known) so that a literal is never rounded to the type of
+   * the column it is compared to (see `LiteralForType`).
+   */
+  struct ZonePredicate {
+    string                      column_name;
+    ZoneOp                      op;
+    string                      literal;
+    shared_ptr<arrow::DataType> literal_type;
+  };
+
+  string                SerializeZonePredicates(const vector<ZonePredicate> &zone_preds);
+  vector<ZonePredicate> ParseZonePredicates(const string &serialized_preds);
+  vector<ZonePredicate> ZonePredicatesForSchema(const Schema &table_schema);
+
+  Result<shared_ptr<arrow::Scalar>> ExactCast( const shared_ptr<arrow::Scalar>   &scalar
+                                              ,const shared_ptr<arrow::DataType> &to_type);
+
+  Result<shared_ptr<arrow::Scalar>> LiteralForType( const ZonePredicate               &zone_pred
+                                                   ,const shared_ptr<arrow::DataType> &to_type);
+
+  Result<shared_ptr<Table>> ZoneMapForChunks(const vector<shared_ptr<Table>> &chunks);
+  bool                      IsZoneMap(const Table &table_data);
+  bool ChunkMayMatch( const Table                 &zone_map
+                     ,int64_t                      chunk_ndx
+                     ,const vector<ZonePredicate> &zone_preds);
 
   //  >> Convenience Functions
   void PrintTable(shared_ptr<Table> table_data, int64_t offset, int64_t length);
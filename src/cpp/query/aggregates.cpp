@@ -0,0 +1,937 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "plans.hpp"
+
+
+// ------------------------------
+// Type Aliases
+
+//  >> Substrait types
+using substrait::AggregateRel;
+using substrait::AggregateFunction;
+using substrait::Expression;
+using substrait::JoinRel;
+using substrait::NamedStruct;
+using substrait::RelCommon;
+using substrait::Type;
+
+using substrait::extensions::SimpleExtensionURI;
+using substrait::extensions::SimpleExtensionDeclaration;
+
+using AggrMeasure = substrait::AggregateRel_Measure;
+
+
+// ------------------------------
+// Functions
+
+namespace mohair {
+
+  // >> Functions for extension declarations
+
+  /** Returns the name of the function declared with `fn_anchor` (without signature). */
+  string FunctionName(const Plan &plan_msg, uint32_t fn_anchor) {
+    for (const auto &ext_decl : plan_msg.extensions()) {
+      if (not ext_decl.has_extension_function()) { continue; }
+
+      const auto &ext_fn = ext_decl.extension_function();
+      if (ext_fn.function_anchor() != fn_anchor) { continue; }
+
+      // compound names include a signature (e.g. "sum:i64")
+      return ext_fn.name().substr(0, ext_fn.name().find(':'));
+    }
+
+    return "";
+  }
+
+
+  // >> Internal functions only
+  namespace {
+
+    // URIs of the extensions that declare functions we may introduce
+    const string uri_arithmetic {
+      "https://github.com/substrait-io/substrait/blob/main/extensions/functions_arithmetic.yaml"
+    };
+
+    const string uri_aggr_generic {
+      "https://github.com/substrait-io/substrait/blob/main/extensions/functions_aggregate_generic.yaml"
+    };
+
+    const string uri_comparison {
+      "https://github.com/substrait-io/substrait/blob/main/extensions/functions_comparison.yaml"
+    };
+
+    // Aggregate functions that we know how to compute in two phases
+    enum class AggrKind { Unsupported, Sum, Count, Min, Max, Avg, VarPop };
+
+    // Indices of the columns that hold a measure's state (-1 if unused)
+    struct MeasureState {
+      int value_ndx   { -1 };
+      int sum_ndx     { -1 };
+      int count_ndx   { -1 };
+      int m2_ndx      { -1 };
+      int mean_sq_ndx { -1 };
+    };
+
+
+    // >> Functions for extension declarations
+
+    /**
+     * Returns the anchor of the function with compound name `fn_name` (e.g. "sum:fp64") in
+     * extension `fn_uri`. A declaration only matches if both its URI and its full compound
+     * name match, since overloads of a name may differ in types and behavior. If `plan_msg`
+     * doesn't declare one, then a declaration (and `fn_uri`, if necessary) is added.
+     */
+    uint32_t AnchorForFunction(Plan &plan_msg, const string &fn_name, const string &fn_uri) {
+      // find (or add) the extension URI
+      bool     has_uri        = false;
+      uint32_t uri_anchor     = 0;
+      uint32_t max_uri_anchor = 0;
+      for (const auto &ext_uri : plan_msg.extension_uris()) {
+        if (ext_uri.uri() == fn_uri) {
+          has_uri    = true;
+          uri_anchor = ext_uri.extension_uri_anchor();
+        }
+
+        max_uri_anchor = std::max(max_uri_anchor, ext_uri.extension_uri_anchor());
+      }
+
+      uint32_t max_fn_anchor = 0;
+      for (const auto &ext_decl : plan_msg.extensions()) {
+        if (not ext_decl.has_extension_function()) { continue; }
+
+        const auto &ext_fn = ext_decl.extension_function();
+        if (
+              has_uri
+          and ext_fn.extension_uri_reference() == uri_anchor
+          and ext_fn.name()                    == fn_name
+        ) {
+          return ext_fn.function_anchor();
+        }
+
+        max_fn_anchor = std::max(max_fn_anchor, ext_fn.function_anchor());
+      }
+
+      if (not has_uri) {
+        uri_anchor = max_uri_anchor + 1;
+
+        SimpleExtensionURI *ext_uri = plan_msg.add_extension_uris();
+        ext_uri->set_extension_uri_anchor(uri_anchor);
+        ext_uri->set_uri(fn_uri);
+      }
+
+      // add the function declaration
+      auto ext_fn = plan_msg.add_extensions()->mutable_extension_function();
+      ext_fn->set_extension_uri_reference(uri_anchor);
+      ext_fn->set_function_anchor(max_fn_anchor + 1);
+      ext_fn->set_name(fn_name);
+
+      return ext_fn->function_anchor();
+    }
+
+
+    // >> Functions for classifying aggregates
+
+    bool IsPopulationVariance(const AggregateFunction &aggr_fn) {
+      for (const auto &fn_opt : aggr_fn.options()) {
+        if (fn_opt.name() != "distribution") { continue; }
+
+        return fn_opt.preference_size() > 0 and fn_opt.preference(0) == "POPULATION";
+      }
+
+      return false;
+    }
+
+    AggrKind KindForMeasure(const Plan &plan_msg, const AggrMeasure &measure) {
+      const AggregateFunction &aggr_fn = measure.measure();
+
+      // filtered and distinct aggregates are not split
+      if (measure.has_filter()) { return AggrKind::Unsupported; }
+      if (aggr_fn.invocation() == AggregateFunction::AGGREGATION_INVOCATION_DISTINCT) {
+        return AggrKind::Unsupported;
+      }
+
+      string fn_name { FunctionName(plan_msg, aggr_fn.function_reference()) };
+      if      (fn_name == "sum")     { return AggrKind::Sum;    }
+      else if (fn_name == "count")   { return AggrKind::Count;  }
+      else if (fn_name == "min")     { return AggrKind::Min;    }
+      else if (fn_name == "max")     { return AggrKind::Max;    }
+      else if (fn_name == "avg")     { return AggrKind::Avg;    }
+      else if (fn_name == "var_pop") { return AggrKind::VarPop; }
+      else if (fn_name == "variance" and IsPopulationVariance(aggr_fn)) {
+        return AggrKind::VarPop;
+      }
+
+      return AggrKind::Unsupported;
+    }
+
+
+    // >> Functions for deriving the types of a relation's output
+
+    Type Fp64Type() {
+      Type fp64_type;
+      fp64_type.mutable_fp64()->set_nullability(Type::NULLABILITY_NULLABLE);
+
+      return fp64_type;
+    }
+
+    Type CountType() {
+      Type count_type;
+      count_type.mutable_i64()->set_nullability(Type::NULLABILITY_REQUIRED);
+
+      return count_type;
+    }
+
+    /** The short name of `arg_type` in a compound function name (e.g. "i64" in "sum:i64"). */
+    string SignatureForType(const Type &arg_type) {
+      switch (arg_type.kind_case()) {
+        case Type::kI8:      { return "i8";   }
+        case Type::kI16:     { return "i16";  }
+        case Type::kI32:     { return "i32";  }
+        case Type::kI64:     { return "i64";  }
+        case Type::kFp32:    { return "fp32"; }
+        case Type::kFp64:    { return "fp64"; }
+        case Type::kDecimal: { return "dec";  }
+        default:             { return "any";  }
+      }
+    }
+
+    bool TypeForLiteral(const Expression::Literal &literal_msg, Type *literal_type) {
+      auto nullability = (
+          literal_msg.nullable()
+        ? Type::NULLABILITY_NULLABLE
+        : Type::NULLABILITY_REQUIRED
+      );
+
+      switch (literal_msg.literal_type_case()) {
+        case Expression::Literal::kBoolean: {
+          literal_type->mutable_bool_()->set_nullability(nullability);
+          break;
+        }
+        case Expression::Literal::kI8:     { literal_type->mutable_i8()->set_nullability(nullability);     break; }
+        case Expression::Literal::kI16:    { literal_type->mutable_i16()->set_nullability(nullability);    break; }
+        case Expression::Literal::kI32:    { literal_type->mutable_i32()->set_nullability(nullability);    break; }
+        case Expression::Literal::kI64:    { literal_type->mutable_i64()->set_nullability(nullability);    break; }
+        case Expression::Literal::kFp32:   { literal_type->mutable_fp32()->set_nullability(nullability);   break; }
+        case Expression::Literal::kFp64:   { literal_type->mutable_fp64()->set_nullability(nullability);   break; }
+        case Expression::Literal::kString: { literal_type->mutable_string()->set_nullability(nullability); break; }
+        default: { return false; }
+      }
+
+      return true;
+    }
+
+    /**
+     * Sets `expr_type` to the type of `expr_msg`, whose field references are to columns
+     * of `input_types`. Returns false for expressions whose type we don't derive.
+     */
+    bool TypeForExpr( const Expression   &expr_msg
+                     ,const vector<Type> &input_types
+                     ,Type               *expr_type) {
+      switch (expr_msg.rex_type_case()) {
+        case Expression::kSelection: {
+          const auto &field_ref = expr_msg.selection();
+          if (not field_ref.has_direct_reference() or not field_ref.has_root_reference()) {
+            return false;
+          }
+
+          const auto &ref_segment = field_ref.direct_reference();
+          if (not ref_segment.has_struct_field() or ref_segment.struct_field().has_child()) {
+            return false;
+          }
+
+          int field_ndx = ref_segment.struct_field().field();
+          if (field_ndx < 0 or field_ndx >= static_cast<int>(input_types.size())) {
+            return false;
+          }
+
+          *expr_type = input_types[field_ndx];
+          return true;
+        }
+
+        case Expression::kScalarFunction: {
+          *expr_type = expr_msg.scalar_function().output_type();
+          break;
+        }
+
+        case Expression::kCast: {
+          *expr_type = expr_msg.cast().type();
+          break;
+        }
+
+        case Expression::kLiteral: { return TypeForLiteral(expr_msg.literal(), expr_type); }
+        default:                   { return false; }
+      }
+
+      return expr_type->kind_case() != Type::KIND_NOT_SET;
+    }
+
+    /** Applies the emit of `rel_common` (if it has one) to `rel_types`. */
+    bool EmitTypes(const RelCommon &rel_common, vector<Type> *rel_types) {
+      if (not rel_common.has_emit()) { return true; }
+
+      vector<Type> emit_types;
+      emit_types.reserve(rel_common.emit().output_mapping_size());
+
+      for (const auto field_ndx : rel_common.emit().output_mapping()) {
+        if (field_ndx < 0 or field_ndx >= static_cast<int>(rel_types->size())) {
+          return false;
+        }
+
+        emit_types.push_back((*rel_types)[field_ndx]);
+      }
+
+      *rel_types = std::move(emit_types);
+      return true;
+    }
+
+    /**
+     * Sets `rel_types` to the types of the columns that `rel_msg` produces. Returns false
+     * for relations whose output types we don't derive, such as extension relations
+     * (including SkyRel reads), whose schemas are only resolved at execution.
+     */
+    bool TypesForRel(const Rel &rel_msg, vector<Type> *rel_types) {
+      rel_types->clear();
+
+      switch (rel_msg.rel_type_case()) {
+        case Rel::kRead: {
+          const auto &read_msg   = rel_msg.read();
+          const auto &base_types = read_msg.base_schema().struct_().types();
+
+          if (not read_msg.has_projection()) {
+            rel_types->assign(base_types.begin(), base_types.end());
+            return EmitTypes(read_msg.common(), rel_types);
+          }
+
+          for (const auto &struct_item : read_msg.projection().select().struct_items()) {
+            int field_ndx = struct_item.field();
+            if (struct_item.has_child() or field_ndx < 0 or field_ndx >= base_types.size()) {
+              return false;
+            }
+
+            rel_types->push_back(base_types[field_ndx]);
+          }
+
+          return EmitTypes(read_msg.common(), rel_types);
+        }
+
+        case Rel::kFilter: {
+          if (not TypesForRel(rel_msg.filter().input(), rel_types)) { return false; }
+          return EmitTypes(rel_msg.filter().common(), rel_types);
+        }
+
+        case Rel::kFetch: {
+          if (not TypesForRel(rel_msg.fetch().input(), rel_types)) { return false; }
+          return EmitTypes(rel_msg.fetch().common(), rel_types);
+        }
+
+        case Rel::kSort: {
+          if (not TypesForRel(rel_msg.sort().input(), rel_types)) { return false; }
+          return EmitTypes(rel_msg.sort().common(), rel_types);
+        }
+
+        case Rel::kProject: {
+          const auto &proj_msg = rel_msg.project();
+          if (not TypesForRel(proj_msg.input(), rel_types)) { return false; }
+
+          // expressions refer to the input's columns and are appended to them
+          const vector<Type> input_types { *rel_types };
+          for (const auto &proj_expr : proj_msg.expressions()) {
+            Type expr_type;
+            if (not TypeForExpr(proj_expr, input_types, &expr_type)) { return false; }
+
+            rel_types->push_back(std::move(expr_type));
+          }
+
+          return EmitTypes(proj_msg.common(), rel_types);
+        }
+
+        case Rel::kAggregate: {
+          const auto &aggr_msg = rel_msg.aggregate();
+          if (aggr_msg.groupings_size() > 1) { return false; }
+
+          vector<Type> input_types;
+          if (not TypesForRel(aggr_msg.input(), &input_types)) { return false; }
+
+          if (aggr_msg.groupings_size() == 1) {
+            for (const auto &group_expr : aggr_msg.groupings(0).grouping_expressions()) {
+              Type group_type;
+              if (not TypeForExpr(group_expr, input_types, &group_type)) { return false; }
+
+              rel_types->push_back(std::move(group_type));
+            }
+          }
+
+          for (const auto &measure : aggr_msg.measures()) {
+            const auto &output_type = measure.measure().output_type();
+            if (output_type.kind_case() == Type::KIND_NOT_SET) { return false; }
+
+            rel_types->push_back(output_type);
+          }
+
+          return EmitTypes(aggr_msg.common(), rel_types);
+        }
+
+        case Rel::kJoin: {
+          const auto &join_msg = rel_msg.join();
+          if (join_msg.type() != JoinRel::JOIN_TYPE_INNER) { return false; }
+
+          vector<Type> right_types;
+          if (not TypesForRel(join_msg.left() , rel_types   )) { return false; }
+          if (not TypesForRel(join_msg.right(), &right_types)) { return false; }
+
+          rel_types->insert(rel_types->end(), right_types.begin(), right_types.end());
+          return EmitTypes(join_msg.common(), rel_types);
+        }
+
+        case Rel::kCross: {
+          const auto &cross_msg = rel_msg.cross();
+
+          vector<Type> right_types;
+          if (not TypesForRel(cross_msg.left() , rel_types   )) { return false; }
+          if (not TypesForRel(cross_msg.right(), &right_types)) { return false; }
+
+          rel_types->insert(rel_types->end(), right_types.begin(), right_types.end());
+          return EmitTypes(cross_msg.common(), rel_types);
+        }
+
+        case Rel::kSet: {
+          const auto &set_msg = rel_msg.set();
+          if (set_msg.inputs_size() == 0)                      { return false; }
+          if (not TypesForRel(set_msg.inputs(0), rel_types)) { return false; }
+
+          return EmitTypes(set_msg.common(), rel_types);
+        }
+
+        default: { return false; }
+      }
+    }
+
+
+    // >> Functions for constructing expressions
+
+    Expression FieldRefExpr(int field_ndx) {
+      Expression field_expr;
+
+      auto field_ref = field_expr.mutable_selection();
+      field_ref->mutable_direct_reference()->mutable_struct_field()->set_field(field_ndx);
+      field_ref->mutable_root_reference();
+
+      return field_expr;
+    }
+
+    Expression CastToFp64(Expression input_expr) {
+      Expression cast_expr;
+
+      auto cast_msg = cast_expr.mutable_cast();
+      *(cast_msg->mutable_type())  = Fp64Type();
+      *(cast_msg->mutable_input()) = std::move(input_expr);
+
+      return cast_expr;
+    }
+
+    /** A call to a binary, double-precision arithmetic function. */
+    Expression ArithmeticExpr(uint32_t fn_anchor, Expression lhs, Expression rhs) {
+      Expression call_expr;
+
+      auto call_msg = call_expr.mutable_scalar_function();
+      call_msg->set_function_reference(fn_anchor);
+      *(call_msg->add_arguments()->mutable_value()) = std::move(lhs);
+      *(call_msg->add_arguments()->mutable_value()) = std::move(rhs);
+      *(call_msg->mutable_output_type())            = Fp64Type();
+
+      return call_expr;
+    }
+
+    Expression Fp64FieldExpr(int field_ndx) { return CastToFp64(FieldRefExpr(field_ndx)); }
+
+    /**
+     * A count (as a double) that is NULL instead of 0, for use as a divisor: a group whose
+     * values are all NULL has a count of 0, and its average (or variance) is then NULL.
+     */
+    Expression NullIfZeroExpr(uint32_t fn_equal, int count_ndx) {
+      Expression zero_expr;
+      zero_expr.mutable_literal()->set_fp64(0.0);
+
+      Expression is_zero_expr;
+      auto equal_msg = is_zero_expr.mutable_scalar_function();
+      equal_msg->set_function_reference(fn_equal);
+      *(equal_msg->add_arguments()->mutable_value()) = Fp64FieldExpr(count_ndx);
+      *(equal_msg->add_arguments()->mutable_value()) = std::move(zero_expr);
+      equal_msg->mutable_output_type()->mutable_bool_()->set_nullability(
+        Type::NULLABILITY_NULLABLE
+      );
+
+      Expression divisor_expr;
+      auto if_msg     = divisor_expr.mutable_if_then();
+      auto if_clause  = if_msg->add_ifs();
+      *(if_clause->mutable_if_()) = std::move(is_zero_expr);
+      *(if_clause->mutable_then()->mutable_literal()->mutable_null()) = Fp64Type();
+      *(if_msg->mutable_else_()) = Fp64FieldExpr(count_ndx);
+
+      return divisor_expr;
+    }
+
+
+    // >> Functions for constructing measures
+
+    /** A measure over the original input, using `fn_anchor` instead of the original function. */
+    AggrMeasure PartialMeasure(const AggrMeasure &orig_measure, uint32_t fn_anchor) {
+      AggrMeasure partial_measure { orig_measure };
+
+      auto aggr_fn = partial_measure.mutable_measure();
+      if (aggr_fn->function_reference() != fn_anchor) {
+        aggr_fn->set_function_reference(fn_anchor);
+        aggr_fn->clear_output_type();
+        aggr_fn->clear_options();
+      }
+
+      return partial_measure;
+    }
+
+    /** A partial count of the values of the original measure's argument. */
+    AggrMeasure PartialCount(const AggrMeasure &orig_measure, uint32_t fn_count) {
+      AggrMeasure partial_measure { PartialMeasure(orig_measure, fn_count) };
+      *(partial_measure.mutable_measure()->mutable_output_type()) = CountType();
+
+      return partial_measure;
+    }
+
+    /** A partial sum of the original measure's argument, as a double. */
+    AggrMeasure PartialFp64Sum(const AggrMeasure &orig_measure, uint32_t fn_sum) {
+      AggrMeasure partial_measure { PartialMeasure(orig_measure, fn_sum) };
+
+      auto aggr_fn = partial_measure.mutable_measure();
+      for (auto &fn_arg : *(aggr_fn->mutable_arguments())) {
+        if (fn_arg.has_value()) { *(fn_arg.mutable_value()) = CastToFp64(fn_arg.value()); }
+      }
+      *(aggr_fn->mutable_output_type()) = Fp64Type();
+
+      return partial_measure;
+    }
+
+    /**
+     * A measure that combines the partial state in column `field_ndx`, whose type is
+     * `state_type`. Combining a state keeps its type.
+     */
+    AggrMeasure CombineMeasure( const AggrMeasure &orig_measure
+                               ,uint32_t           fn_anchor
+                               ,int                field_ndx
+                               ,const Type        &state_type) {
+      AggrMeasure combine_measure;
+
+      auto aggr_fn = combine_measure.mutable_measure();
+      aggr_fn->set_function_reference(fn_anchor);
+      aggr_fn->set_phase(orig_measure.measure().phase());
+      aggr_fn->set_invocation(AggregateFunction::AGGREGATION_INVOCATION_ALL);
+      *(aggr_fn->add_arguments()->mutable_value()) = FieldRefExpr(field_ndx);
+      *(aggr_fn->mutable_output_type())            = state_type;
+
+      return combine_measure;
+    }
+
+  } // anonymous namespace for internal functions
+
+
+  // >> Functions for splitting aggregates
+
+  /** The table name that a super-plan reads the results of sub-plan `subplan_ndx` from. */
+  vector<string> SubplanResultsName(size_t subplan_ndx) {
+    return vector<string> { subplan_results_marker, std::to_string(subplan_ndx) };
+  }
+
+  /**
+   * Splits an aggregate into a partial aggregate and a final aggregate.
+   *
+   * The partial aggregate has the same input and groupings as `aggr_msg`, but each
+   * measure is replaced by the state needed to combine it: sum and count for averages;
+   * count, sum and M2 (the sum of squared deviations from the partition's mean) for
+   * variances. For variances, M2 and `sum^2 / count` are computed by a projection over
+   * the partial aggregate, which is then the root of the sub-plan.
+   *
+   * The final phase reads partial results from a placeholder read of the named table
+   * `SubplanResultsName(0)`, whose base schema is the partial state. It re-groups partial
+   * results by the grouping columns, sums each state, then projects the original measures.
+   * Variances are combined with Chan's parallel formula, `M2 = sum(M2_i) + sum(n_i *
+   * mean_i^2) - N * mean^2`: squared deviations within each partition are never
+   * recomputed from sums of squares, only the deviations between partition means are.
+   *
+   * Averages and variances divide by a count that is NULL instead of 0, so a group whose
+   * values are all NULL has a NULL result (as in the original aggregate).
+   *
+   * Functions that the split needs are declared in `plan_msg` once the split is known to
+   * succeed. If `aggr_msg` has more than one grouping set, a measure we cannot split, a
+   * column whose type we can't derive, or an emit that references a column it doesn't
+   * have, nullptr is returned and `plan_msg` is unchanged.
+   */
+  unique_ptr<AggrPhases> SplitAggregate(Plan &plan_msg, const AggregateRel &aggr_msg) {
+    if (aggr_msg.groupings_size() > 1) { return nullptr; }
+
+    vector<AggrKind> measure_kinds;
+    bool             has_average  = false;
+    bool             has_variance = false;
+
+    measure_kinds.reserve(aggr_msg.measures_size());
+    for (const auto &measure : aggr_msg.measures()) {
+      AggrKind measure_kind = KindForMeasure(plan_msg, measure);
+      if (measure_kind == AggrKind::Unsupported) { return nullptr; }
+
+      // partial results of these measures keep the type of the original measure
+      bool keeps_type = (
+            measure_kind != AggrKind::Avg
+        and measure_kind != AggrKind::VarPop
+      );
+
+      if (keeps_type and measure.measure().output_type().kind_case() == Type::KIND_NOT_SET) {
+        return nullptr;
+      }
+
+      has_average  |= (measure_kind == AggrKind::Avg   );
+      has_variance |= (measure_kind == AggrKind::VarPop);
+      measure_kinds.push_back(measure_kind);
+    }
+
+    // types of the grouping columns (the placeholder read of partial results needs them)
+    vector<Type> group_types;
+    if (aggr_msg.groupings_size() == 1) {
+      vector<Type> input_types;
+      if (not TypesForRel(aggr_msg.input(), &input_types)) { return nullptr; }
+
+      for (const auto &group_expr : aggr_msg.groupings(0).grouping_expressions()) {
+        Type group_type;
+        if (not TypeForExpr(group_expr, input_types, &group_type)) { return nullptr; }
+
+        // the names of nested fields are unknown
+        if (NestedNameCount(group_type) > 0) { return nullptr; }
+
+        group_types.push_back(std::move(group_type));
+      }
+    }
+
+    int group_count  = static_cast<int>(group_types.size());
+    int output_count = group_count + static_cast<int>(measure_kinds.size());
+
+    // the original emit must only reference the aggregate's output columns
+    if (aggr_msg.has_common() and aggr_msg.common().has_emit()) {
+      for (const auto orig_ndx : aggr_msg.common().emit().output_mapping()) {
+        if (orig_ndx < 0 or orig_ndx >= output_count) { return nullptr; }
+      }
+    }
+
+    // >> The split succeeds; declare the functions it introduces (only those it uses)
+    uint32_t fn_count    = 0;
+    uint32_t fn_sum_i64  = 0;
+    uint32_t fn_sum_fp64 = 0;
+    uint32_t fn_divide   = 0;
+    uint32_t fn_equal    = 0;
+    if (has_average or has_variance) {
+      fn_count    = AnchorForFunction(plan_msg, "count:any"       , uri_aggr_generic);
+      fn_sum_i64  = AnchorForFunction(plan_msg, "sum:i64"         , uri_arithmetic  );
+      fn_sum_fp64 = AnchorForFunction(plan_msg, "sum:fp64"        , uri_arithmetic  );
+      fn_divide   = AnchorForFunction(plan_msg, "divide:fp64_fp64", uri_arithmetic  );
+      fn_equal    = AnchorForFunction(plan_msg, "equal:any_any"   , uri_comparison  );
+    }
+
+    uint32_t fn_add      = 0;
+    uint32_t fn_subtract = 0;
+    uint32_t fn_multiply = 0;
+    if (has_variance) {
+      fn_add      = AnchorForFunction(plan_msg, "add:fp64_fp64"     , uri_arithmetic);
+      fn_subtract = AnchorForFunction(plan_msg, "subtract:fp64_fp64", uri_arithmetic);
+      fn_multiply = AnchorForFunction(plan_msg, "multiply:fp64_fp64", uri_arithmetic);
+    }
+
+    // >> Partial aggregate: same input and groupings, measures replaced by their state
+    auto phases         = std::make_unique<AggrPhases>();
+    phases->partial_rel = std::make_unique<Rel>();
+
+    // with variances, the sub-plan root is a projection of the partial aggregate
+    substrait::ProjectRel *state_proj       = nullptr;
+    Rel                   *partial_aggr_rel = phases->partial_rel.get();
+    if (has_variance) {
+      state_proj       = phases->partial_rel->mutable_project();
+      partial_aggr_rel = state_proj->mutable_input();
+    }
+
+    auto partial_aggr = partial_aggr_rel->mutable_aggregate();
+    *(partial_aggr->mutable_input())     = aggr_msg.input();
+    *(partial_aggr->mutable_groupings()) = aggr_msg.groupings();
+
+    vector<MeasureState> measure_states(measure_kinds.size());
+    int                  partial_width  = group_count;
+
+    auto add_partial = [&partial_aggr, &partial_width](AggrMeasure partial_measure) {
+      *(partial_aggr->add_measures()) = std::move(partial_measure);
+      return partial_width++;
+    };
+
+    for (size_t measure_ndx = 0; measure_ndx < measure_kinds.size(); ++measure_ndx) {
+      const AggrMeasure &measure   = aggr_msg.measures(measure_ndx);
+      const uint32_t     fn_anchor = measure.measure().function_reference();
+      MeasureState      &state     = measure_states[measure_ndx];
+
+      switch (measure_kinds[measure_ndx]) {
+        case AggrKind::Avg: {
+          state.sum_ndx   = add_partial(PartialFp64Sum(measure, fn_sum_fp64));
+          state.count_ndx = add_partial(PartialCount(measure, fn_count));
+          break;
+        }
+        case AggrKind::VarPop: {
+          state.count_ndx = add_partial(PartialCount(measure, fn_count));
+          state.sum_ndx   = add_partial(PartialFp64Sum(measure, fn_sum_fp64));
+          state.value_ndx = add_partial(PartialMeasure(measure, fn_anchor));
+          break;
+        }
+        default: {
+          state.value_ndx = add_partial(PartialMeasure(measure, fn_anchor));
+          break;
+        }
+      }
+    }
+
+    // >> State projection: M2 and `sum^2 / count` of each variance (after every column)
+    if (state_proj != nullptr) {
+      int proj_width = partial_width;
+
+      for (size_t measure_ndx = 0; measure_ndx < measure_kinds.size(); ++measure_ndx) {
+        if (measure_kinds[measure_ndx] != AggrKind::VarPop) { continue; }
+        MeasureState &state = measure_states[measure_ndx];
+
+        // count * var
+        *(state_proj->add_expressions()) = ArithmeticExpr(
+          fn_multiply, Fp64FieldExpr(state.count_ndx), Fp64FieldExpr(state.value_ndx)
+        );
+        state.m2_ndx = proj_width++;
+
+        // sum * sum / count (count * mean^2)
+        *(state_proj->add_expressions()) = ArithmeticExpr(
+           fn_divide
+          ,ArithmeticExpr(fn_multiply, FieldRefExpr(state.sum_ndx), FieldRefExpr(state.sum_ndx))
+          ,NullIfZeroExpr(fn_equal, state.count_ndx)
+        );
+        state.mean_sq_ndx = proj_width++;
+      }
+    }
+
+    // >> Partial results: the columns that the super-plan reads, in order
+    vector<int>          result_ndxs;   // column of the sub-plan root, per result column
+    vector<Type>         result_types;
+    vector<MeasureState> result_states(measure_kinds.size());
+
+    auto add_result = [&result_ndxs, &result_types](int partial_ndx, Type result_type) {
+      result_ndxs.push_back(partial_ndx);
+      result_types.push_back(std::move(result_type));
+
+      return static_cast<int>(result_ndxs.size()) - 1;
+    };
+
+    for (int group_ndx = 0; group_ndx < group_count; ++group_ndx) {
+      add_result(group_ndx, group_types[group_ndx]);
+    }
+
+    for (size_t measure_ndx = 0; measure_ndx < measure_kinds.size(); ++measure_ndx) {
+      const AggrMeasure  &measure = aggr_msg.measures(measure_ndx);
+      const MeasureState &state   = measure_states[measure_ndx];
+      MeasureState       &result  = result_states[measure_ndx];
+
+      switch (measure_kinds[measure_ndx]) {
+        case AggrKind::Avg: {
+          result.sum_ndx   = add_result(state.sum_ndx  , Fp64Type() );
+          result.count_ndx = add_result(state.count_ndx, CountType());
+          break;
+        }
+        case AggrKind::VarPop: {
+          result.count_ndx   = add_result(state.count_ndx  , CountType());
+          result.sum_ndx     = add_result(state.sum_ndx    , Fp64Type() );
+          result.m2_ndx      = add_result(state.m2_ndx     , Fp64Type() );
+          result.mean_sq_ndx = add_result(state.mean_sq_ndx, Fp64Type() );
+          break;
+        }
+        default: {
+          result.value_ndx = add_result(state.value_ndx, measure.measure().output_type());
+          break;
+        }
+      }
+    }
+
+    // the projection keeps only the state (not the variance of each partition)
+    if (state_proj != nullptr) {
+      auto state_emit = state_proj->mutable_common()->mutable_emit();
+      for (const auto result_ndx : result_ndxs) { state_emit->add_output_mapping(result_ndx); }
+    }
+
+    // >> Placeholder read of partial results
+    auto results_rel  = std::make_unique<Rel>();
+    auto results_read = results_rel->mutable_read();
+    for (const auto &name_part : SubplanResultsName(0)) {
+      results_read->mutable_named_table()->add_names(name_part);
+    }
+
+    NamedStruct *results_schema = results_read->mutable_base_schema();
+    results_schema->mutable_struct_()->set_nullability(Type::NULLABILITY_REQUIRED);
+    for (size_t result_ndx = 0; result_ndx < result_types.size(); ++result_ndx) {
+      results_schema->add_names("partial_" + std::to_string(result_ndx));
+      *(results_schema->mutable_struct_()->add_types()) = result_types[result_ndx];
+    }
+
+    // >> Combine aggregate: group by the grouping columns and combine each state
+    auto combine_rel  = std::make_unique<Rel>();
+    auto combine_aggr = combine_rel->mutable_aggregate();
+    combine_aggr->set_allocated_input(results_rel.release());
+
+    if (aggr_msg.groupings_size() == 1) {
+      auto combine_grouping = combine_aggr->add_groupings();
+      for (int group_ndx = 0; group_ndx < group_count; ++group_ndx) {
+        *(combine_grouping->add_grouping_expressions()) = FieldRefExpr(group_ndx);
+      }
+    }
+
+    int  combine_width = group_count;
+    auto add_combine   = [&combine_aggr, &combine_width, &result_types](
+       const AggrMeasure &measure
+      ,uint32_t           fn_anchor
+      ,int                field_ndx
+    ) {
+      *(combine_aggr->add_measures()) = CombineMeasure(
+        measure, fn_anchor, field_ndx, result_types[field_ndx]
+      );
+
+      return combine_width++;
+    };
+
+    // combined state, indexed by the original measure
+    vector<MeasureState> combined_states(measure_kinds.size());
+    for (size_t measure_ndx = 0; measure_ndx < measure_kinds.size(); ++measure_ndx) {
+      const AggrMeasure  &measure   = aggr_msg.measures(measure_ndx);
+      const uint32_t      fn_anchor = measure.measure().function_reference();
+      const MeasureState &result    = result_states[measure_ndx];
+      MeasureState       &combined  = combined_states[measure_ndx];
+
+      switch (measure_kinds[measure_ndx]) {
+        case AggrKind::Sum:
+        case AggrKind::Count: {
+          // partial sums (and counts) are summed with the overload for their type
+          uint32_t fn_sum = AnchorForFunction(
+             plan_msg
+            ,"sum:" + SignatureForType(result_types[result.value_ndx])
+            ,uri_arithmetic
+          );
+
+          combined.value_ndx = add_combine(measure, fn_sum, result.value_ndx);
+          break;
+        }
+        case AggrKind::Min:
+        case AggrKind::Max: {
+          combined.value_ndx = add_combine(measure, fn_anchor, result.value_ndx);
+          break;
+        }
+        case AggrKind::Avg: {
+          combined.sum_ndx   = add_combine(measure, fn_sum_fp64, result.sum_ndx  );
+          combined.count_ndx = add_combine(measure, fn_sum_i64 , result.count_ndx);
+          break;
+        }
+        case AggrKind::VarPop: {
+          combined.count_ndx   = add_combine(measure, fn_sum_i64 , result.count_ndx  );
+          combined.sum_ndx     = add_combine(measure, fn_sum_fp64, result.sum_ndx    );
+          combined.m2_ndx      = add_combine(measure, fn_sum_fp64, result.m2_ndx     );
+          combined.mean_sq_ndx = add_combine(measure, fn_sum_fp64, result.mean_sq_ndx);
+          break;
+        }
+        default: { break; }
+      }
+    }
+
+    // >> Final projection: compute each original measure from its combined state
+    phases->final_rel = std::make_unique<Rel>();
+    auto final_proj   = phases->final_rel->mutable_project();
+    final_proj->set_allocated_input(combine_rel.release());
+
+    // index of each original output column in the projection's output
+    vector<int> output_ndxs;
+    output_ndxs.reserve(group_count + measure_kinds.size());
+    for (int group_ndx = 0; group_ndx < group_count; ++group_ndx) {
+      output_ndxs.push_back(group_ndx);
+    }
+
+    int final_width = combine_width;
+    for (size_t measure_ndx = 0; measure_ndx < measure_kinds.size(); ++measure_ndx) {
+      const MeasureState &combined = combined_states[measure_ndx];
+
+      switch (measure_kinds[measure_ndx]) {
+        case AggrKind::Avg: {
+          *(final_proj->add_expressions()) = ArithmeticExpr(
+             fn_divide
+            ,Fp64FieldExpr(combined.sum_ndx)
+            ,NullIfZeroExpr(fn_equal, combined.count_ndx)
+          );
+
+          output_ndxs.push_back(final_width++);
+          break;
+        }
+        case AggrKind::VarPop: {
+          // sum * sum / N (N * mean^2)
+          auto total_mean_sq = ArithmeticExpr(
+             fn_divide
+            ,ArithmeticExpr(
+               fn_multiply, FieldRefExpr(combined.sum_ndx), FieldRefExpr(combined.sum_ndx)
+             )
+            ,NullIfZeroExpr(fn_equal, combined.count_ndx)
+          );
+
+          // (sum(M2_i) + sum(n_i * mean_i^2) - N * mean^2) / N
+          *(final_proj->add_expressions()) = ArithmeticExpr(
+             fn_divide
+            ,ArithmeticExpr(
+               fn_add
+              ,FieldRefExpr(combined.m2_ndx)
+              ,ArithmeticExpr(
+                 fn_subtract, FieldRefExpr(combined.mean_sq_ndx), std::move(total_mean_sq)
+               )
+             )
+            ,NullIfZeroExpr(fn_equal, combined.count_ndx)
+          );
+
+          output_ndxs.push_back(final_width++);
+          break;
+        }
+        default: {
+          output_ndxs.push_back(combined.value_ndx);
+          break;
+        }
+      }
+    }
+
+    // emit the original output columns (respecting the original emit, validated above)
+    auto final_emit = final_proj->mutable_common()->mutable_emit();
+    if (aggr_msg.has_common() and aggr_msg.common().has_emit()) {
+      for (const auto orig_ndx : aggr_msg.common().emit().output_mapping()) {
+        final_emit->add_output_mapping(output_ndxs[orig_ndx]);
+      }
+    }
+
+    else {
+      for (const auto output_ndx : output_ndxs) { final_emit->add_output_mapping(output_ndx); }
+    }
+
+    return phases;
+  }
+
+} // namespace: mohair
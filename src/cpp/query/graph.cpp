@@ -0,0 +1,618 @@
+// ------------------------------
+// License
+//
+// Copyright 2023 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+// type aliases (e.g. for substrait) included in this header
+#include "operators.hpp"
+
+//  >> Standard libs
+#include <algorithm>
+
+
+// ------------------------------
+// Functions
+
+namespace mohair {
+
+  // >> Helper functions
+
+  OpKind OpKindForRel(const Rel& rel_msg) {
+    switch (rel_msg.rel_type_case()) {
+      case Rel::RelTypeCase::kRead:           { return OpKind::Read;           }
+      case Rel::RelTypeCase::kProject:        { return OpKind::Project;        }
+      case Rel::RelTypeCase::kFilter:         { return OpKind::Filter;         }
+      case Rel::RelTypeCase::kFetch:          { return OpKind::Fetch;          }
+      case Rel::RelTypeCase::kSort:           { return OpKind::Sort;           }
+      case Rel::RelTypeCase::kAggregate:      { return OpKind::Aggregate;      }
+      case Rel::RelTypeCase::kCross:          { return OpKind::CrossJoin;      }
+      case Rel::RelTypeCase::kJoin:           { return OpKind::Join;           }
+      case Rel::RelTypeCase::kHashJoin:       { return OpKind::HashJoin;       }
+      case Rel::RelTypeCase::kMergeJoin:      { return OpKind::MergeJoin;      }
+
+      case Rel::RelTypeCase::kSet:            { return OpKind::Set;            }
+      case Rel::RelTypeCase::kExtensionMulti: { return OpKind::ExtensionMulti; }
+      case Rel::RelTypeCase::kExtensionLeaf: {
+        SkyRel sky_rel;
+        return SkyRelFromLeaf(rel_msg, &sky_rel) ? OpKind::SkyRead : OpKind::Error;
+      }
+
+      default: { return OpKind::Error; }
+    }
+  }
+
+  /** Matches the `IsBreaker()` of the QueryOp that `MohairFrom` creates for each kind. */
+  bool IsBreakerKind(OpKind op_kind) {
+    switch (op_kind) {
+      case OpKind::Sort:
+      case OpKind::Aggregate:
+      case OpKind::CrossJoin:
+      case OpKind::Join:
+      case OpKind::HashJoin:
+      case OpKind::MergeJoin:
+      case OpKind::Set:
+      case OpKind::ExtensionMulti: { return true; }
+
+      default: { return false; }
+    }
+  }
+
+  /**
+   * Orders node indices by descending pipeline length. The sort is stable, so nodes with
+   * equal pipeline lengths stay in the order they were discovered.
+   */
+  void SortGraphNodes(const PlanGraph& plan, vector<uint32_t>& node_ndxs) {
+    std::stable_sort(
+       node_ndxs.begin(), node_ndxs.end()
+      ,[&plan](uint32_t lhs, uint32_t rhs) {
+         return plan.nodes[lhs].attrs.pipe_len > plan.nodes[rhs].attrs.pipe_len;
+       }
+    );
+  }
+
+
+  // >> PlanGraph construction
+
+  /**
+   * State for a relation during graph construction: the next input to visit and attributes
+   * accumulated from the inputs that have been visited.
+   */
+  struct GraphFrame {
+    Rel    *rel_msg;
+    size_t  input_ndx;
+    size_t  input_count;
+    int     pipe_len;
+    int     plan_width;
+    int     plan_height;
+    int     break_height;
+
+    GraphFrame(Rel *rel)
+      :  rel_msg(rel)
+        ,input_ndx(0)
+        ,input_count(RelInputCount(*rel))
+        ,pipe_len(0)
+        ,plan_width(0)
+        ,plan_height(0)
+        ,break_height(0)
+    {}
+
+    /** Attributes of this relation, once each of its inputs has been visited. */
+    PlanAttrs ToAttrs(bool is_breaker) {
+      // a leaf has default attributes
+      if (input_count == 0) { return PlanAttrs {}; }
+
+      int op_bheight = is_breaker ? break_height + 1 : break_height;
+      return PlanAttrs { pipe_len + 1, plan_width, plan_height + 1, op_bheight };
+    }
+  };
+
+  /**
+   * Returns the index of the table name for a node. A read names its source, a unary
+   * relation shares the name of its input, and a join joins the names of its inputs.
+   */
+  uint32_t NameIndexForNode( PlanGraph&      plan
+                            ,Rel*            rel_msg
+                            ,const uint32_t* input_ndxs
+                            ,size_t          input_count) {
+    if (input_count == 1) { return plan.nodes[input_ndxs[0]].name_ndx; }
+
+    if (input_count == 0) {
+      SkyRel sky_rel;
+      if (rel_msg->has_read()) {
+        plan.table_names.push_back(SourceNameForRead(rel_msg->mutable_read()));
+      }
+      else if (SkyRelFromLeaf(*rel_msg, &sky_rel)) {
+        plan.table_names.push_back(SourceNameForSky(sky_rel));
+      }
+      else { plan.table_names.push_back(""); }
+    }
+
+    else {
+      string op_tname { plan.TableName(input_ndxs[0]) };
+      for (size_t input_ndx = 1; input_ndx < input_count; ++input_ndx) {
+        op_tname += "." + plan.TableName(input_ndxs[input_ndx]);
+      }
+
+      plan.table_names.push_back(std::move(op_tname));
+    }
+
+    return static_cast<uint32_t>(plan.table_names.size() - 1);
+  }
+
+  /**
+   * Builds a PlanGraph in a single, iterative post-order walk of the relations rooted at
+   * `root_rel`. Each node is appended after its inputs, so the indices of a node's inputs
+   * are contiguous at the top of `pending_ndxs` when the node is appended.
+   */
+  unique_ptr<PlanGraph> PlanGraphFrom(Rel *root_rel) {
+    auto plan_graph = std::make_unique<PlanGraph>();
+    PlanGraph& plan = *plan_graph;
+
+    vector<GraphFrame> rel_stack;
+    vector<uint32_t>   pending_ndxs;
+    rel_stack.emplace_back(root_rel);
+
+    while (not rel_stack.empty()) {
+      // Descend into the next input of the relation on top of the stack
+      GraphFrame &top_frame = rel_stack.back();
+      if (top_frame.input_ndx < top_frame.input_count) {
+        Rel *input_rel = RelInputAt(top_frame.rel_msg, top_frame.input_ndx++);
+        rel_stack.emplace_back(input_rel);
+        continue;
+      }
+
+      // Each input has been visited, so append a node for this relation
+      OpKind   node_kind  = OpKindForRel(*(top_frame.rel_msg));
+      bool     is_breaker = IsBreakerKind(node_kind);
+      uint32_t node_ndx   = static_cast<uint32_t>(plan.nodes.size());
+      uint32_t input_cnt  = static_cast<uint32_t>(top_frame.input_count);
+      uint32_t input_beg  = static_cast<uint32_t>(plan.input_ndxs.size());
+
+      plan.input_ndxs.insert(
+         plan.input_ndxs.end()
+        ,pending_ndxs.end() - input_cnt
+        ,pending_ndxs.end()
+      );
+      pending_ndxs.resize(pending_ndxs.size() - input_cnt);
+
+      uint32_t name_ndx = NameIndexForNode(
+        plan, top_frame.rel_msg, plan.input_ndxs.data() + input_beg, input_cnt
+      );
+
+      plan.nodes.push_back(PlanNode {
+         node_kind
+        ,is_breaker
+        ,input_beg
+        ,input_cnt
+        ,name_ndx
+        ,top_frame.rel_msg
+        ,top_frame.ToAttrs(is_breaker)
+      });
+
+      pending_ndxs.push_back(node_ndx);
+      rel_stack.pop_back();
+      if (rel_stack.empty()) { break; }
+
+      // Update the parent's accumulated attributes
+      const PlanAttrs &child_attrs  = plan.nodes.back().attrs;
+      GraphFrame      &parent_frame = rel_stack.back();
+      parent_frame.break_height  = std::max(parent_frame.break_height, child_attrs.break_height);
+      parent_frame.plan_height   = std::max(parent_frame.plan_height , child_attrs.plan_height );
+      parent_frame.plan_width   += child_attrs.plan_width;
+
+      if (not is_breaker) {
+        parent_frame.pipe_len = std::max(parent_frame.pipe_len, child_attrs.pipe_len);
+      }
+
+      // Update indices to breakers
+      else if (child_attrs.break_height == 1) { plan.bleaf_ndxs.push_back(node_ndx); }
+      else                                    { plan.break_ndxs.push_back(node_ndx); }
+    }
+
+    SortGraphNodes(plan, plan.bleaf_ndxs);
+    SortGraphNodes(plan, plan.break_ndxs);
+
+    return plan_graph;
+  }
+
+  /** Returns nullptr if the plan wasn't parsed or doesn't have exactly one root. */
+  unique_ptr<PlanGraph> PlanGraphFrom(PlanMessage& plan_msg) {
+    if (plan_msg.payload == nullptr) { return nullptr; }
+
+    // set the plan root if not already set (there should only be one)
+    if (plan_msg.root_relndx < 0) {
+      int root_ndx = FindPlanRoot(*(plan_msg.payload));
+      if (root_ndx < 0) { return nullptr; }
+
+      plan_msg.root_relndx   = root_ndx;
+      plan_msg.root_relation = plan_msg.payload->mutable_relations(root_ndx);
+    }
+
+    return PlanGraphFrom(plan_msg.root_relation->mutable_root()->mutable_input());
+  }
+
+
+  // >> PlanGraph traversal functions
+  //    Each returns a position in `candidates`, or -1 if no candidate matches.
+
+  int FindTallJoinLeaf(const PlanGraph& plan, const vector<uint32_t>& candidates) {
+    int tallest_height = 0;
+    int match_ndx      = -1;
+
+    for (size_t cand_ndx = 0; cand_ndx < candidates.size(); ++cand_ndx) {
+      const PlanAttrs& attrs = plan.nodes[candidates[cand_ndx]].attrs;
+
+      // we're only interested in bottom-most join operators
+      if (attrs.plan_width != 2) { continue; }
+
+      // track the index that matches our criteria
+      if (attrs.plan_height > tallest_height) {
+        std::cout << "[" << std::to_string(cand_ndx) << "]\tHeight: "
+                  <<        std::to_string(attrs.plan_height)
+                  << std::endl
+        ;
+
+        match_ndx      = static_cast<int>(cand_ndx);
+        tallest_height = attrs.plan_height;
+      }
+    }
+
+    return match_ndx;
+  }
+
+  int FindLongPipeline(const PlanGraph& plan, const vector<uint32_t>& candidates) {
+    int longest_pipelen = 0;
+    int match_ndx       = -1;
+
+    for (size_t cand_ndx = 0; cand_ndx < candidates.size(); ++cand_ndx) {
+      const PlanAttrs& attrs = plan.nodes[candidates[cand_ndx]].attrs;
+
+      // track the index that matches our criteria
+      if (attrs.pipe_len > longest_pipelen) {
+        std::cout << "[" << std::to_string(cand_ndx) << "]\tLen: "
+                  <<        std::to_string(attrs.pipe_len)
+                  << std::endl
+        ;
+
+        match_ndx       = static_cast<int>(cand_ndx);
+        longest_pipelen = attrs.pipe_len;
+      }
+    }
+
+    return match_ndx;
+  }
+
+  int FindWideJoinHead(const PlanGraph& plan, const vector<uint32_t>& candidates) {
+    int widest_width   = 0;
+    int tallest_height = 0;
+    int match_ndx      = -1;
+
+    for (size_t cand_ndx = 0; cand_ndx < candidates.size(); ++cand_ndx) {
+      const PlanNode& node = plan.nodes[candidates[cand_ndx]];
+
+      // we're only interested in join operators (more than one input)
+      if (node.input_count < 2) { continue; }
+
+      // track the index that matches our criteria
+      bool is_wider  = node.attrs.plan_width > widest_width;
+      bool is_taller = (
+            node.attrs.plan_width  == widest_width
+        and node.attrs.plan_height >  tallest_height
+      );
+
+      if (is_wider or is_taller) {
+        match_ndx      = static_cast<int>(cand_ndx);
+        widest_width   = node.attrs.plan_width;
+        tallest_height = node.attrs.plan_height;
+      }
+    }
+
+    return match_ndx;
+  }
+
+  int FindLongAggregateLeaf(const PlanGraph& plan, const vector<uint32_t>& candidates) {
+    int longest_pipelen = 0;
+    int match_ndx       = -1;
+
+    for (size_t cand_ndx = 0; cand_ndx < candidates.size(); ++cand_ndx) {
+      const PlanNode& node = plan.nodes[candidates[cand_ndx]];
+
+      // we're only interested in aggregates
+      if (node.kind != OpKind::Aggregate) { continue; }
+
+      // track the index that matches our criteria
+      if (node.attrs.pipe_len > longest_pipelen) {
+        match_ndx       = static_cast<int>(cand_ndx);
+        longest_pipelen = node.attrs.pipe_len;
+      }
+    }
+
+    return match_ndx;
+  }
+
+
+  int FindWideSetOp(const PlanGraph& plan, const vector<uint32_t>& candidates) {
+    uint32_t widest_inputs   = 0;
+    int      longest_pipelen = 0;
+    int      match_ndx       = -1;
+
+    for (size_t cand_ndx = 0; cand_ndx < candidates.size(); ++cand_ndx) {
+      const PlanNode& node = plan.nodes[candidates[cand_ndx]];
+
+      // we're only interested in set operations
+      if (node.kind != OpKind::Set) { continue; }
+
+      // track the index that matches our criteria
+      bool is_wider  = node.input_count > widest_inputs;
+      bool is_longer = (
+            node.input_count    == widest_inputs
+        and node.attrs.pipe_len >  longest_pipelen
+      );
+
+      if (is_wider or is_longer) {
+        match_ndx       = static_cast<int>(cand_ndx);
+        widest_inputs   = node.input_count;
+        longest_pipelen = node.attrs.pipe_len;
+      }
+    }
+
+    return match_ndx;
+  }
+
+
+  // >> PlanGraph cost estimation
+
+  /**
+   * Estimates the output of every node in a single pass. Nodes are in post-order, so the
+   * estimates of a node's inputs are always available when the node is estimated.
+   */
+  vector<OpEstimate> EstimateGraph(const PlanGraph& plan, const StatsMap& table_stats) {
+    vector<OpEstimate> node_ests;
+    vector<OpEstimate> input_ests;
+
+    node_ests.reserve(plan.nodes.size());
+    for (uint32_t node_ndx = 0; node_ndx < plan.nodes.size(); ++node_ndx) {
+      const PlanNode& node       = plan.nodes[node_ndx];
+      const uint32_t* input_ndxs = plan.InputsOf(node_ndx);
+
+      input_ests.clear();
+      for (uint32_t input_ndx = 0; input_ndx < node.input_count; ++input_ndx) {
+        input_ests.push_back(node_ests[input_ndxs[input_ndx]]);
+      }
+
+      node_ests.push_back(EstimateRel(
+         *(node.rel_msg), plan.TableName(node_ndx)
+        ,input_ests.data(), input_ests.size(), table_stats
+      ));
+    }
+
+    return node_ests;
+  }
+
+  /**
+   * Returns the position in `candidates` of the anchor whose sub-plans (its inputs) are
+   * cheapest to split off: the least bytes transferred, then the most rows computed by
+   * the sub-plans (see `SplitCost::IsCheaperThan`).
+   * Input sizes come from `node_ests` (see `EstimateGraph`), and the chosen anchor's cost
+   * is stored in `min_cost`. Returns -1 if there are no candidates.
+   */
+  int FindMinTransfer( const PlanGraph&          plan
+                      ,const vector<uint32_t>&   candidates
+                      ,const vector<OpEstimate>& node_ests
+                      ,SplitCost&                min_cost) {
+    int match_ndx = -1;
+
+    for (size_t cand_ndx = 0; cand_ndx < candidates.size(); ++cand_ndx) {
+      uint32_t        node_ndx   = candidates[cand_ndx];
+      const uint32_t* input_ndxs = plan.InputsOf(node_ndx);
+
+      // Each input of the anchor is a sub-plan
+      SplitCost split_cost;
+      for (uint32_t input_ndx = 0; input_ndx < plan.nodes[node_ndx].input_count; ++input_ndx) {
+        const OpEstimate& input_est = node_ests[input_ndxs[input_ndx]];
+
+        split_cost.transfer_bytes += input_est.row_count * input_est.row_width;
+        split_cost.compute_rows   += input_est.compute_rows;
+      }
+
+      // track the index that matches our criteria
+      if (match_ndx < 0 or split_cost.IsCheaperThan(min_cost)) {
+        match_ndx = static_cast<int>(cand_ndx);
+        min_cost  = split_cost;
+      }
+    }
+
+    return match_ndx;
+  }
+
+
+  // >> PlanGraph decomposition
+
+  unique_ptr<GraphSplit>
+  DecomposeGraph(const PlanGraph& plan, DecomposeAlg method, const StatsMap& table_stats) {
+    switch (method) {
+      // Without a leaf join, fall back to the default algorithm
+      case TallJoinLeaf: {
+        int split_ndx = FindTallJoinLeaf(plan, plan.break_ndxs);
+        if (split_ndx < 0) { return DecomposeGraph(plan, LongPipelineLeaf); }
+
+        return std::make_unique<GraphSplit>(plan.break_ndxs[split_ndx]);
+      }
+
+      // LongPipelineLeaf is currently default algorithm
+      case LongPipelineLeaf: {
+        int split_ndx = FindLongPipeline(plan, plan.bleaf_ndxs);
+        if (split_ndx < 0) {
+          std::cerr << "Plan has no pipeline breaker to split at" << std::endl;
+          return nullptr;
+        }
+
+        return std::make_unique<GraphSplit>(plan.bleaf_ndxs[split_ndx]);
+      }
+
+      // Without an internal breaker, fall back to the default algorithm
+      case LongPipelineHead: {
+        int split_ndx = FindLongPipeline(plan, plan.break_ndxs);
+        if (split_ndx < 0) { return DecomposeGraph(plan, LongPipelineLeaf); }
+
+        return std::make_unique<GraphSplit>(plan.break_ndxs[split_ndx]);
+      }
+
+      // Without an internal join, fall back to the default algorithm
+      case WideJoinHead: {
+        int split_ndx = FindWideJoinHead(plan, plan.break_ndxs);
+        if (split_ndx < 0) { return DecomposeGraph(plan, LongPipelineLeaf); }
+
+        return std::make_unique<GraphSplit>(plan.break_ndxs[split_ndx]);
+      }
+
+      // Candidates are both leaf and internal breakers
+      case MinTransfer: {
+        auto node_ests = EstimateGraph(plan, table_stats);
+
+        SplitCost leaf_cost, head_cost;
+        int leaf_ndx = FindMinTransfer(plan, plan.bleaf_ndxs, node_ests, leaf_cost);
+        int head_ndx = FindMinTransfer(plan, plan.break_ndxs, node_ests, head_cost);
+
+        if (head_ndx >= 0 and (leaf_ndx < 0 or head_cost.IsCheaperThan(leaf_cost))) {
+          return std::make_unique<GraphSplit>(plan.break_ndxs[head_ndx]);
+        }
+
+        if (leaf_ndx >= 0) {
+          return std::make_unique<GraphSplit>(plan.bleaf_ndxs[leaf_ndx]);
+        }
+
+        return DecomposeGraph(plan, LongPipelineLeaf);
+      }
+
+      // Without a leaf aggregate, fall back to the default algorithm
+      case PartialAggregate: {
+        int aggr_ndx = FindLongAggregateLeaf(plan, plan.bleaf_ndxs);
+        if (aggr_ndx < 0) { return DecomposeGraph(plan, LongPipelineLeaf); }
+
+        auto graph_split = std::make_unique<GraphSplit>(plan.bleaf_ndxs[aggr_ndx]);
+        graph_split->split_aggr = true;
+
+        return graph_split;
+      }
+
+      // Leaf and internal set operations are candidates; each input is a sub-plan
+      case SetBranches: {
+        int leaf_ndx = FindWideSetOp(plan, plan.bleaf_ndxs);
+        int head_ndx = FindWideSetOp(plan, plan.break_ndxs);
+
+        if (head_ndx >= 0) {
+          uint32_t head_node = plan.break_ndxs[head_ndx];
+          bool     is_wider  = (
+               leaf_ndx < 0
+            or plan.nodes[head_node].input_count
+             > plan.nodes[plan.bleaf_ndxs[leaf_ndx]].input_count
+          );
+
+          if (is_wider) { return std::make_unique<GraphSplit>(head_node); }
+        }
+
+        if (leaf_ndx >= 0) { return std::make_unique<GraphSplit>(plan.bleaf_ndxs[leaf_ndx]); }
+
+        return DecomposeGraph(plan, LongPipelineLeaf);
+      }
+
+      default: {
+        std::cerr << "Unknown decomposition method" << std::endl;
+        return nullptr;
+      }
+    }
+  }
+
+} // namespace: mohair
+
+
+// ------------------------------
+// Classes
+
+namespace mohair {
+
+  // >> PlanGraph member functions
+  const uint32_t* PlanGraph::InputsOf(uint32_t node_ndx) const {
+    return input_ndxs.data() + nodes[node_ndx].input_begin;
+  }
+
+  const string& PlanGraph::TableName(uint32_t node_ndx) const {
+    return table_names[nodes[node_ndx].name_ndx];
+  }
+
+  /** Returns the same representation as `ToString()` of the corresponding QueryOp. */
+  string PlanGraph::ToString(uint32_t node_ndx) const {
+    const string& tname = TableName(node_ndx);
+
+    switch (nodes[node_ndx].kind) {
+      case OpKind::Read:           { return u8"Read(" + tname + u8")"; }
+      case OpKind::SkyRead:        { return u8"Sky("  + tname + u8")"; }
+      case OpKind::Project:        { return u8"Π("    + tname + u8")"; }
+      case OpKind::Filter:         { return u8"σ("    + tname + u8")"; }
+      case OpKind::Fetch:          { return u8"Lim("  + tname + u8")"; }
+      case OpKind::Sort:           { return u8"Sort(" + tname + u8")"; }
+      case OpKind::Aggregate:      { return u8"Aggr(" + tname + u8")"; }
+      case OpKind::CrossJoin:      { return u8"×("    + tname + u8")"; }
+      case OpKind::Join:           { return u8"⋈("    + tname + u8")"; }
+      case OpKind::HashJoin:       { return u8"⋈→("   + tname + u8")"; }
+      case OpKind::MergeJoin:      { return u8"⋈⊕("   + tname + u8")"; }
+      case OpKind::Set:            { return u8"∪("    + tname + u8")"; }
+      case OpKind::ExtensionMulti: { return u8"Ext("  + tname + u8")"; }
+
+      default: { return u8"Err()"; }
+    }
+  }
+
+  /**
+   * Returns a view of the subtree rooted at `root_ndx`, using an iterative pre-order walk.
+   * Inputs are pushed in reverse so that they are visited in order.
+   */
+  string PlanGraph::ViewPlan(uint32_t root_ndx) const {
+    std::stringstream plan_str;
+    string            indent { "" };
+    vector<uint32_t>  node_stack { root_ndx };
+
+    while (not node_stack.empty()) {
+      uint32_t node_ndx = node_stack.back();
+      node_stack.pop_back();
+
+      // Add indentation for current node, then its representation
+      const PlanNode& node = nodes[node_ndx];
+      if      (node.is_breaker)            { plan_str << std::endl << indent << u8"↤ "; }
+      else if (node.kind == OpKind::Error) { plan_str              << "  "; }
+      else                                 { plan_str              << "  "   << u8"← "; }
+
+      plan_str << ToString(node_ndx);
+
+      // Increase indent for inputs
+      indent.append(2, ' ');
+
+      const uint32_t* node_inputs = InputsOf(node_ndx);
+      for (uint32_t input_ndx = node.input_count; input_ndx > 0; --input_ndx) {
+        node_stack.push_back(node_inputs[input_ndx - 1]);
+      }
+    }
+
+    return plan_str.str();
+  }
+
+  string PlanGraph::ViewPlan() const { return ViewPlan(RootIndex()); }
+
+} // namespace: mohair
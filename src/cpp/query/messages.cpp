@@ -21,6 +21,31 @@
 
 #include "messages.hpp"
 
+//  >> Standard libs
+#include <algorithm>
+#include <unordered_map>
+
+//  >> External libs
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+
+// ------------------------------
+// Type Aliases
+
+//  >> Substrait types
+using substrait::RelRoot;
+using substrait::extensions::SimpleExtensionURI;
+using substrait::extensions::SimpleExtensionDeclaration;
+using substrait::extensions::AdvancedExtension;
+
+//  >> Protobuf types
+using google::protobuf::Message;
+using google::protobuf::MessageLite;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::io::StringOutputStream;
+using google::protobuf::io::CodedOutputStream;
+
 
 // ------------------------------
 // Functions
@@ -46,9 +71,24 @@ namespace mohair {
   void PrintSubstraitPlan(Plan *plan_msg) { PrintProtoMessage<Plan>(plan_msg); }
 
 
+  // >> Arena functions
+
+  /**
+   * Returns a new arena for a plan. Blocks start at `plan_arena_block_size` and grow up
+   * to `plan_arena_max_block_size`, so a typical plan fits in a handful of blocks.
+   */
+  shared_ptr<Arena> NewPlanArena() {
+    ArenaOptions arena_opts;
+    arena_opts.start_block_size = plan_arena_block_size;
+    arena_opts.max_block_size   = plan_arena_max_block_size;
+
+    return std::make_shared<Arena>(arena_opts);
+  }
+
+
   // >> Conversion functions (into/out of substrait plans)
-  unique_ptr<Plan> SubstraitPlanFromString(string &plan_msg) {
-    auto substrait_plan = std::make_unique<Plan>();
+  Plan* SubstraitPlanFromString(string &plan_msg, Arena *plan_arena) {
+    auto substrait_plan = Arena::Create<Plan>(plan_arena);
 
     substrait_plan->ParseFromString(plan_msg);
     // TODO: enable in debug mode
@@ -57,8 +97,8 @@ namespace mohair {
     return substrait_plan;
   }
 
-  unique_ptr<Plan> SubstraitPlanFromFile(fstream* plan_fstream) {
-    auto substrait_plan = std::make_unique<Plan>();
+  Plan* SubstraitPlanFromFile(fstream* plan_fstream, Arena *plan_arena) {
+    auto substrait_plan = Arena::Create<Plan>(plan_arena);
     if (substrait_plan->ParseFromIstream(plan_fstream)) { return substrait_plan; }
 
     std::cerr << "Failed to parse substrait plan" << std::endl;
@@ -91,6 +131,352 @@ namespace mohair {
   }
 
 
+  // >> Functions for plan identity
+
+  // Internal functions for normalizing extension anchors
+  namespace {
+
+    using AnchorMap = std::unordered_map<uint32_t, uint32_t>;
+
+    // Old to new anchors for each kind of extension
+    struct PlanAnchors {
+      AnchorMap uri_anchors;
+      AnchorMap fn_anchors;
+      AnchorMap type_anchors;
+      AnchorMap variation_anchors;
+    };
+
+    uint32_t RemapAnchor(const AnchorMap &anchors, uint32_t old_anchor) {
+      auto anchor_entry = anchors.find(old_anchor);
+      if (anchor_entry == anchors.end()) { return old_anchor; }
+
+      return anchor_entry->second;
+    }
+
+    /**
+     * Returns the anchors that a reference field uses, or nullptr if not a reference.
+     * Reference fields are listed by name: functions are referenced by scalar, window and
+     * aggregate functions ("function_reference") and by sort fields
+     * ("comparison_function_reference").
+     */
+    const AnchorMap* AnchorsForField(const string &field_name, const PlanAnchors &anchors) {
+      if (field_name == "function_reference" or field_name == "comparison_function_reference") {
+        return &(anchors.fn_anchors);
+      }
+
+      if (field_name == "type_reference" or field_name == "user_defined_type_reference") {
+        return &(anchors.type_anchors);
+      }
+
+      if (field_name == "type_variation_reference") { return &(anchors.variation_anchors); }
+      return nullptr;
+    }
+
+    /** Recursively rewrites every extension reference in `msg` using `anchors`. */
+    void RemapReferences(Message *msg, const PlanAnchors &anchors) {
+      auto msg_reflection = msg->GetReflection();
+
+      vector<const FieldDescriptor *> msg_fields;
+      msg_reflection->ListFields(*msg, &msg_fields);
+
+      for (const FieldDescriptor *field : msg_fields) {
+        if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+          if (not field->is_repeated()) {
+            RemapReferences(msg_reflection->MutableMessage(msg, field), anchors);
+            continue;
+          }
+
+          int field_size = msg_reflection->FieldSize(*msg, field);
+          for (int elem_ndx = 0; elem_ndx < field_size; ++elem_ndx) {
+            RemapReferences(
+              msg_reflection->MutableRepeatedMessage(msg, field, elem_ndx), anchors
+            );
+          }
+
+          continue;
+        }
+
+        if (field->cpp_type() != FieldDescriptor::CPPTYPE_UINT32) { continue; }
+        if (field->is_repeated())                                  { continue; }
+
+        const AnchorMap *field_anchors = AnchorsForField(field->name(), anchors);
+        if (field_anchors == nullptr) { continue; }
+
+        msg_reflection->SetUInt32(
+          msg, field, RemapAnchor(*field_anchors, msg_reflection->GetUInt32(*msg, field))
+        );
+      }
+    }
+
+    /** Returns the uri anchor and name of an extension declaration. */
+    std::pair<uint32_t, string> DeclarationRef(const SimpleExtensionDeclaration &ext_decl) {
+      switch (ext_decl.mapping_type_case()) {
+        case SimpleExtensionDeclaration::kExtensionType: {
+          const auto &ext_type = ext_decl.extension_type();
+          return { ext_type.extension_uri_reference(), ext_type.name() };
+        }
+        case SimpleExtensionDeclaration::kExtensionTypeVariation: {
+          const auto &ext_variation = ext_decl.extension_type_variation();
+          return { ext_variation.extension_uri_reference(), ext_variation.name() };
+        }
+        case SimpleExtensionDeclaration::kExtensionFunction: {
+          const auto &ext_fn = ext_decl.extension_function();
+          return { ext_fn.extension_uri_reference(), ext_fn.name() };
+        }
+        default: {
+          return { 0, "" };
+        }
+      }
+    }
+
+  } // anonymous namespace for internal functions
+
+  /**
+   * Returns a deterministic serialization of `substrait_plan` with normalized extensions.
+   *
+   * Extension URIs are ordered by URI and extension declarations are ordered by kind, URI
+   * and name. Anchors are then reassigned in that order and every reference in the plan's
+   * relations is rewritten to match. Two plans that only differ in how their extensions
+   * were anchored produce the same string, so it can be used as a cache key.
+   */
+  string CanonicalPlanString(const Plan &substrait_plan) {
+    Arena       canonical_arena;
+    Plan&       canonical_plan = *(Arena::Create<Plan>(&canonical_arena));
+    PlanAnchors plan_anchors;
+
+    canonical_plan.CopyFrom(substrait_plan);
+
+    // >> Normalize extension URIs (ordered by URI)
+    vector<SimpleExtensionURI> ext_uris {
+      substrait_plan.extension_uris().begin(), substrait_plan.extension_uris().end()
+    };
+
+    std::sort(
+       ext_uris.begin(), ext_uris.end()
+      ,[](const SimpleExtensionURI &lhs, const SimpleExtensionURI &rhs) {
+         return lhs.uri() < rhs.uri();
+       }
+    );
+
+    std::unordered_map<uint32_t, string> uri_names;
+    canonical_plan.clear_extension_uris();
+    for (size_t uri_ndx = 0; uri_ndx < ext_uris.size(); ++uri_ndx) {
+      SimpleExtensionURI &ext_uri    = ext_uris[uri_ndx];
+      const uint32_t      new_anchor = static_cast<uint32_t>(uri_ndx + 1);
+
+      uri_names[ext_uri.extension_uri_anchor()]                = ext_uri.uri();
+      plan_anchors.uri_anchors[ext_uri.extension_uri_anchor()] = new_anchor;
+
+      ext_uri.set_extension_uri_anchor(new_anchor);
+      *(canonical_plan.add_extension_uris()) = std::move(ext_uri);
+    }
+
+    // >> Normalize extension declarations (ordered by kind, URI, then name)
+    vector<SimpleExtensionDeclaration> ext_decls {
+      substrait_plan.extensions().begin(), substrait_plan.extensions().end()
+    };
+
+    auto decl_key = [&uri_names](const SimpleExtensionDeclaration &ext_decl) {
+      auto [uri_anchor, decl_name] = DeclarationRef(ext_decl);
+      return std::make_tuple(ext_decl.mapping_type_case(), uri_names[uri_anchor], decl_name);
+    };
+
+    std::stable_sort(
+       ext_decls.begin(), ext_decls.end()
+      ,[&decl_key]( const SimpleExtensionDeclaration &lhs
+                   ,const SimpleExtensionDeclaration &rhs) {
+         return decl_key(lhs) < decl_key(rhs);
+       }
+    );
+
+    canonical_plan.clear_extensions();
+    for (size_t decl_ndx = 0; decl_ndx < ext_decls.size(); ++decl_ndx) {
+      SimpleExtensionDeclaration &ext_decl   = ext_decls[decl_ndx];
+      const uint32_t              new_anchor = static_cast<uint32_t>(decl_ndx + 1);
+
+      switch (ext_decl.mapping_type_case()) {
+        case SimpleExtensionDeclaration::kExtensionType: {
+          auto ext_type = ext_decl.mutable_extension_type();
+          plan_anchors.type_anchors[ext_type->type_anchor()] = new_anchor;
+
+          ext_type->set_type_anchor(new_anchor);
+          ext_type->set_extension_uri_reference(
+            RemapAnchor(plan_anchors.uri_anchors, ext_type->extension_uri_reference())
+          );
+          break;
+        }
+        case SimpleExtensionDeclaration::kExtensionTypeVariation: {
+          auto ext_variation = ext_decl.mutable_extension_type_variation();
+          plan_anchors.variation_anchors[ext_variation->type_variation_anchor()] = new_anchor;
+
+          ext_variation->set_type_variation_anchor(new_anchor);
+          ext_variation->set_extension_uri_reference(
+            RemapAnchor(plan_anchors.uri_anchors, ext_variation->extension_uri_reference())
+          );
+          break;
+        }
+        case SimpleExtensionDeclaration::kExtensionFunction: {
+          auto ext_fn = ext_decl.mutable_extension_function();
+          plan_anchors.fn_anchors[ext_fn->function_anchor()] = new_anchor;
+
+          ext_fn->set_function_anchor(new_anchor);
+          ext_fn->set_extension_uri_reference(
+            RemapAnchor(plan_anchors.uri_anchors, ext_fn->extension_uri_reference())
+          );
+          break;
+        }
+        default: { break; }
+      }
+
+      *(canonical_plan.add_extensions()) = std::move(ext_decl);
+    }
+
+    // >> Rewrite references in the plan's relations to use the new anchors
+    for (int rel_ndx = 0; rel_ndx < canonical_plan.relations_size(); ++rel_ndx) {
+      RemapReferences(canonical_plan.mutable_relations(rel_ndx), plan_anchors);
+    }
+
+    // >> Serialize deterministically (e.g. map fields in a stable order)
+    string canonical_str;
+    {
+      StringOutputStream canonical_stream { &canonical_str };
+      CodedOutputStream  coded_stream     { &canonical_stream };
+
+      coded_stream.SetSerializationDeterministic(true);
+      canonical_plan.SerializeToCodedStream(&coded_stream);
+    }
+
+    return canonical_str;
+  }
+
+
+  // >> Functions for emitting sub-plans
+
+  // Wire format helpers, so that sub-plans can be written field by field
+  namespace {
+
+    /** The tag of a length-delimited field (wire type 2). */
+    constexpr uint32_t LengthDelimitedTag(int field_num) {
+      return (static_cast<uint32_t>(field_num) << 3) | 2;
+    }
+
+    /** The serialized size of a length-delimited field with a `data_size` payload. */
+    size_t LengthDelimitedSize(int field_num, size_t data_size) {
+      return (
+          CodedOutputStream::VarintSize32(LengthDelimitedTag(field_num))
+        + CodedOutputStream::VarintSize64(data_size)
+        + data_size
+      );
+    }
+
+    void WriteFieldHeader(int field_num, size_t data_size, CodedOutputStream *out_stream) {
+      out_stream->WriteTag(LengthDelimitedTag(field_num));
+      out_stream->WriteVarint64(data_size);
+    }
+
+    void WriteMessageField(int field_num, const MessageLite &msg, CodedOutputStream *out_stream) {
+      // ByteSizeLong caches sizes used by SerializeWithCachedSizes
+      WriteFieldHeader(field_num, msg.ByteSizeLong(), out_stream);
+      msg.SerializeWithCachedSizes(out_stream);
+    }
+
+    void WriteStringField(int field_num, const string &str, CodedOutputStream *out_stream) {
+      WriteFieldHeader(field_num, str.size(), out_stream);
+      out_stream->WriteString(str);
+    }
+
+  } // anonymous namespace for internal functions
+
+  /**
+   * Serializes a sub-plan of `plan_msg` without copying `plan_msg`.
+   *
+   * The sub-plan shares the header of `plan_msg` (extension URIs, extension declarations,
+   * expected type URLs and version) and its relations, except that the input of the root
+   * relation (at `root_relndx`) is `subplan_rootrel` and the plan's optimization is
+   * `anchor_msg`. Each of these is written directly to the output as a `Plan` field.
+   *
+   * Returns an empty string if the sub-plan could not be serialized (a sub-plan always
+   * has a root relation, so it is never empty otherwise).
+   */
+  string SerializeSubplan( const Plan       &plan_msg
+                          ,int               root_relndx
+                          ,const Rel        &subplan_rootrel
+                          ,const PlanAnchor &anchor_msg) {
+    string subplan_str;
+    bool   had_error { false };
+    {
+      StringOutputStream subplan_stream { &subplan_str };
+      CodedOutputStream  coded_stream   { &subplan_stream };
+
+      // >> Shared header
+      for (const auto &ext_uri : plan_msg.extension_uris()) {
+        WriteMessageField(Plan::kExtensionUrisFieldNumber, ext_uri, &coded_stream);
+      }
+
+      for (const auto &ext_decl : plan_msg.extensions()) {
+        WriteMessageField(Plan::kExtensionsFieldNumber, ext_decl, &coded_stream);
+      }
+
+      // >> Relations (the root relation wraps the sub-plan root instead)
+      for (int rel_ndx = 0; rel_ndx < plan_msg.relations_size(); ++rel_ndx) {
+        const PlanRel &plan_rel = plan_msg.relations(rel_ndx);
+        if (rel_ndx != root_relndx) {
+          WriteMessageField(Plan::kRelationsFieldNumber, plan_rel, &coded_stream);
+          continue;
+        }
+
+        // compute sizes of the (implicit) PlanRel and RelRoot messages
+        const RelRoot &old_root   = plan_rel.root();
+        size_t         input_size = subplan_rootrel.ByteSizeLong();
+        size_t         root_size  = LengthDelimitedSize(RelRoot::kInputFieldNumber, input_size);
+        for (const auto &root_name : old_root.names()) {
+          root_size += LengthDelimitedSize(RelRoot::kNamesFieldNumber, root_name.size());
+        }
+
+        WriteFieldHeader(
+           Plan::kRelationsFieldNumber
+          ,LengthDelimitedSize(PlanRel::kRootFieldNumber, root_size)
+          ,&coded_stream
+        );
+
+        WriteFieldHeader(PlanRel::kRootFieldNumber , root_size , &coded_stream);
+        WriteFieldHeader(RelRoot::kInputFieldNumber, input_size, &coded_stream);
+        subplan_rootrel.SerializeWithCachedSizes(&coded_stream);
+
+        for (const auto &root_name : old_root.names()) {
+          WriteStringField(RelRoot::kNamesFieldNumber, root_name, &coded_stream);
+        }
+      }
+
+      // >> Advanced extensions (the anchor replaces any previous optimization)
+      AdvancedExtension plan_ext;
+      if (plan_msg.advanced_extensions().has_enhancement()) {
+        *(plan_ext.mutable_enhancement()) = plan_msg.advanced_extensions().enhancement();
+      }
+
+      plan_ext.mutable_optimization()->PackFrom(anchor_msg);
+      WriteMessageField(Plan::kAdvancedExtensionsFieldNumber, plan_ext, &coded_stream);
+
+      // >> Remaining header fields
+      for (const auto &type_url : plan_msg.expected_type_urls()) {
+        WriteStringField(Plan::kExpectedTypeUrlsFieldNumber, type_url, &coded_stream);
+      }
+
+      if (plan_msg.has_version()) {
+        WriteMessageField(Plan::kVersionFieldNumber, plan_msg.version(), &coded_stream);
+      }
+
+      // checked before the stream is destroyed, which trims `subplan_str` to what was written
+      had_error = coded_stream.HadError();
+    }
+
+    if (had_error) {
+      std::cerr << "Error when serializing sub-plan" << std::endl;
+      return string {};
+    }
+
+    return subplan_str;
+  }
 
 } // namespace: mohair
 
@@ -30,6 +30,7 @@
 #include "mohair/algebra.pb.h"
 
 //  >> External libs
+#include <google/protobuf/arena.h>
 #include <google/protobuf/text_format.h>
 
 
@@ -47,6 +48,8 @@ using mohair::ErrRel;
 
 //  >> Protobuf types
 using google::protobuf::TextFormat;
+using google::protobuf::Arena;
+using google::protobuf::ArenaOptions;
 
 
 // ------------------------------
@@ -54,17 +57,33 @@ using google::protobuf::TextFormat;
 
 namespace mohair {
 
+  // Sizes (in bytes) of the blocks that a plan's arena allocates
+  constexpr size_t plan_arena_block_size     = 64   * 1024;
+  constexpr size_t plan_arena_max_block_size = 1024 * 1024;
+
   // >> Debug functions
   void PrintSubstraitPlan(Plan *plan_msg);
   void PrintSubstraitRel(Rel   *rel_msg);
 
-  // >> Reader functions
-  unique_ptr<Plan> SubstraitPlanFromString(string &plan_msg);
-  unique_ptr<Plan> SubstraitPlanFromFile(fstream *plan_fstream);
+  // >> Arena functions
+  shared_ptr<Arena> NewPlanArena();
+
+  // >> Reader functions (the plan is allocated on, and owned by, `plan_arena`)
+  Plan* SubstraitPlanFromString(string &plan_msg, Arena *plan_arena);
+  Plan* SubstraitPlanFromFile(fstream *plan_fstream, Arena *plan_arena);
 
   // >> Helper functions
   int FindPlanRoot(Plan& substrait_plan);
 
+  // >> Functions for plan identity
+  string CanonicalPlanString(const Plan &substrait_plan);
+
+  // >> Functions for emitting sub-plans
+  string SerializeSubplan( const Plan       &plan_msg
+                          ,int               root_relndx
+                          ,const Rel        &subplan_rootrel
+                          ,const PlanAnchor &anchor_msg);
+
 } // namespace: mohair
 
 
@@ -73,32 +92,61 @@ namespace mohair {
 
 namespace mohair {
 
+  /**
+   * A substrait plan and the arena that owns it.
+   *
+   * Each request (e.g. a parsed plan) has its own arena, so parsing a plan is a few block
+   * allocations rather than an allocation per message, and everything derived from the
+   * plan is freed together. Sub-plans derived from this plan share its arena.
+   */
   struct PlanMessage {
-    unique_ptr<Plan> payload;
-    int              root_relndx { -1 }; // initialized to -1 as a sentinel
-    PlanRel*         root_relation;
+    shared_ptr<Arena> plan_arena;
+    Plan*             payload;
+    int               root_relndx { -1 }; // initialized to -1 as a sentinel
+    PlanRel*          root_relation;
 
     virtual ~PlanMessage() = default;
 
-    PlanMessage(unique_ptr<Plan>&& msg): payload(std::move(msg)) {}
-    PlanMessage(unique_ptr<Plan>&& msg, int root_relndx)
-      : payload(std::move(msg)), root_relndx(root_relndx) {
+    PlanMessage(shared_ptr<Arena> arena, Plan *msg)
+      : plan_arena(std::move(arena)), payload(msg) {}
+
+    PlanMessage(shared_ptr<Arena> arena, Plan *msg, int root_relndx)
+      : plan_arena(std::move(arena)), payload(msg), root_relndx(root_relndx) {
       this->root_relation = this->payload->mutable_relations(root_relndx);
     }
 
-    PlanMessage(string&  msg): PlanMessage(SubstraitPlanFromString(msg)) {}
-    PlanMessage(fstream& msg): PlanMessage(SubstraitPlanFromFile(&msg))  {}
+    // A heap-allocated plan is given to a new arena, which deletes it
+    PlanMessage(unique_ptr<Plan>&& msg)
+      : PlanMessage(NewPlanArena(), msg.get()) { plan_arena->Own(msg.release()); }
+
+    PlanMessage(unique_ptr<Plan>&& msg, int root_relndx)
+      : PlanMessage(NewPlanArena(), msg.get(), root_relndx) { plan_arena->Own(msg.release()); }
+
+    PlanMessage(string& msg): plan_arena(NewPlanArena()) {
+      this->payload = SubstraitPlanFromString(msg, plan_arena.get());
+    }
+
+    PlanMessage(fstream& msg): plan_arena(NewPlanArena()) {
+      this->payload = SubstraitPlanFromFile(&msg, plan_arena.get());
+    }
   };
 
 
-  // Forward declaration of PlanSplit for FromSplit prototype
-  struct PlanSplit;
+  // Forward declarations of GraphSplit (and friends) for FromSplit prototypes
+  struct PlanGraph;
+  struct GraphSplit;
 
   // >> Adapter for substrait messages
   struct SubstraitMessage : PlanMessage {
 
     virtual ~SubstraitMessage() = default;
 
+    SubstraitMessage(shared_ptr<Arena> arena, Plan *msg)
+      : PlanMessage(std::move(arena), msg) {}
+
+    SubstraitMessage(shared_ptr<Arena> arena, Plan *msg, int root_relndx)
+      : PlanMessage(std::move(arena), msg, root_relndx) {}
+
     SubstraitMessage(unique_ptr<Plan>&& msg): PlanMessage(std::move(msg)) {}
     SubstraitMessage(unique_ptr<Plan>&& msg, int root_relndx)
       : PlanMessage(std::move(msg), root_relndx) {}
@@ -109,8 +157,13 @@ namespace mohair {
     virtual string Serialize();
     virtual bool   SerializeToFile(const char *out_fpath);
 
-    // function implementation in plans.cpp
-    virtual vector<unique_ptr<SubstraitMessage>> SubplansFromSplit(PlanSplit& split);
+    // function implementations in plans.cpp (sub-plans are returned serialized)
+    virtual vector<string> SubplansFromSplit(const PlanGraph& plan, const GraphSplit& split);
+
+    vector<string>
+    SubplansForAnchor(Rel* anchor_rel, const vector<Rel*>& input_rels, bool split_aggr);
+
+    string SubplanFromRel(const Rel& subplan_rootrel, const PlanAnchor& anchor_msg);
   };
 
 } // namespace: mohair
@@ -31,6 +31,7 @@ namespace mohair {
   // >> Implementations for each op type to return its string representation
   const string OpErr::ToString()       { return u8"Err()";                      }
   const string OpRead::ToString()      { return u8"Read(" + table_name + u8")"; }
+  const string OpSkyRead::ToString()   { return u8"Sky("  + table_name + u8")"; }
   const string OpProj::ToString()      { return u8"Π("    + table_name + u8")"; }
   const string OpSel::ToString()       { return u8"σ("    + table_name + u8")"; }
   const string OpLimit::ToString()     { return u8"Lim("  + table_name + u8")"; }
@@ -42,99 +43,166 @@ namespace mohair {
   const string OpHashJoin::ToString()  { return u8"⋈→("   + table_name + u8")"; }
   const string OpMergeJoin::ToString() { return u8"⋈⊕("   + table_name + u8")"; }
 
+  const string OpSet::ToString()       { return u8"∪("    + table_name + u8")"; }
+  const string OpExtMulti::ToString()  { return u8"Ext("  + table_name + u8")"; }
+
   // >> Implementations for each op type to return its PlanAnchor
-  unique_ptr<PlanAnchor> PlanAnchorForRel(Rel *anchor_relmsg) {
-    // wrap Rel in a new PlanAnchor message
-    auto anchor_msg = std::make_unique<PlanAnchor>();
-    anchor_msg->set_allocated_anchor_rel(anchor_relmsg);
 
-    // Then return the constructed message
+  /**
+   * Returns a PlanAnchor that contains a copy of `anchor_relmsg` without its inputs.
+   *
+   * Inputs are detached from `rel_op` (the relation in `anchor_relmsg`) before the copy
+   * and re-attached after, so the copy is proportional to the size of the node rather than
+   * its subtree. The `unsafe_arena_*` accessors move ownership without copying, whether or
+   * not the plan is allocated on an arena.
+   *
+   * The PlanAnchor is allocated on `arena` (usually the arena of the plan that contains
+   * `anchor_relmsg`), which owns it. If `arena` is null, the caller owns it.
+   *
+   * NOTE: `anchor_relmsg` is briefly modified, so it must not be read concurrently.
+   */
+  template <typename UnaryRelMsg>
+  PlanAnchor* AnchorForUnaryRel(Rel *anchor_relmsg, UnaryRelMsg *rel_op, Arena *arena) {
+    auto anchor_msg = Arena::Create<PlanAnchor>(arena);
+
+    Rel *rel_input = rel_op->unsafe_arena_release_input();
+    anchor_msg->mutable_anchor_rel()->CopyFrom(*anchor_relmsg);
+    rel_op->unsafe_arena_set_allocated_input(rel_input);
+
     return anchor_msg;
   }
 
-  unique_ptr<PlanAnchor> OpProj::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_project()->clear_input();
+  template <typename BinaryRelMsg>
+  PlanAnchor* AnchorForBinaryRel(Rel *anchor_relmsg, BinaryRelMsg *rel_op, Arena *arena) {
+    auto anchor_msg = Arena::Create<PlanAnchor>(arena);
+
+    Rel *left_input  = rel_op->unsafe_arena_release_left();
+    Rel *right_input = rel_op->unsafe_arena_release_right();
+    anchor_msg->mutable_anchor_rel()->CopyFrom(*anchor_relmsg);
+    rel_op->unsafe_arena_set_allocated_left(left_input);
+    rel_op->unsafe_arena_set_allocated_right(right_input);
 
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+    return anchor_msg;
   }
 
-  unique_ptr<PlanAnchor> OpSel::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_filter()->clear_input();
+  /**
+   * Like AnchorForBinaryRel, but for relations with a repeated `inputs` field. Inputs are
+   * extracted (without copying) and added back in their original order.
+   */
+  template <typename VariadicRelMsg>
+  PlanAnchor* AnchorForVariadicRel(Rel *anchor_relmsg, VariadicRelMsg *rel_op, Arena *arena) {
+    auto anchor_msg = Arena::Create<PlanAnchor>(arena);
+    auto rel_inputs = rel_op->mutable_inputs();
 
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+    vector<Rel *> input_rels(rel_inputs->size());
+    rel_inputs->UnsafeArenaExtractSubrange(0, rel_inputs->size(), input_rels.data());
+    anchor_msg->mutable_anchor_rel()->CopyFrom(*anchor_relmsg);
+
+    for (const auto input_rel : input_rels) { rel_inputs->UnsafeArenaAddAllocated(input_rel); }
+
+    return anchor_msg;
   }
 
-  unique_ptr<PlanAnchor> OpLimit::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_fetch()->clear_input();
+  // a QueryOp isn't tied to the arena of its plan, so its anchor is owned by the caller
+  unique_ptr<PlanAnchor> OpProj::ToPlanAnchor() {
+    return unique_ptr<PlanAnchor> {
+      AnchorForUnaryRel(this->op_wrap, this->op_wrap->mutable_project(), nullptr)
+    };
+  }
 
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+  unique_ptr<PlanAnchor> OpSel::ToPlanAnchor() {
+    return unique_ptr<PlanAnchor> {
+      AnchorForUnaryRel(this->op_wrap, this->op_wrap->mutable_filter(), nullptr)
+    };
   }
 
-  unique_ptr<PlanAnchor> OpSort::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_sort()->clear_input();
+  unique_ptr<PlanAnchor> OpLimit::ToPlanAnchor() {
+    return unique_ptr<PlanAnchor> {
+      AnchorForUnaryRel(this->op_wrap, this->op_wrap->mutable_fetch(), nullptr)
+    };
+  }
 
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+  unique_ptr<PlanAnchor> OpSort::ToPlanAnchor() {
+    return unique_ptr<PlanAnchor> {
+      AnchorForUnaryRel(this->op_wrap, this->op_wrap->mutable_sort(), nullptr)
+    };
   }
 
   unique_ptr<PlanAnchor> OpAggr::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_aggregate()->clear_input();
-
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+    return unique_ptr<PlanAnchor> {
+      AnchorForUnaryRel(this->op_wrap, this->op_wrap->mutable_aggregate(), nullptr)
+    };
   }
 
   unique_ptr<PlanAnchor> OpCrossJoin::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_cross()->clear_left();
-    simplified_rel->mutable_cross()->clear_right();
-
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+    return unique_ptr<PlanAnchor> {
+      AnchorForBinaryRel(this->op_wrap, this->op_wrap->mutable_cross(), nullptr)
+    };
   }
 
   unique_ptr<PlanAnchor> OpJoin::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_join()->clear_left();
-    simplified_rel->mutable_join()->clear_right();
-
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+    return unique_ptr<PlanAnchor> {
+      AnchorForBinaryRel(this->op_wrap, this->op_wrap->mutable_join(), nullptr)
+    };
   }
 
   unique_ptr<PlanAnchor> OpHashJoin::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_hash_join()->clear_left();
-    simplified_rel->mutable_hash_join()->clear_right();
-
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+    return unique_ptr<PlanAnchor> {
+      AnchorForBinaryRel(this->op_wrap, this->op_wrap->mutable_hash_join(), nullptr)
+    };
   }
 
   unique_ptr<PlanAnchor> OpMergeJoin::ToPlanAnchor() {
-    // copy the Rel message and simplify its content (we don't need its full tree)
-    auto simplified_rel = std::make_unique<Rel>(*(this->op_wrap));
-    simplified_rel->mutable_merge_join()->clear_left();
-    simplified_rel->mutable_merge_join()->clear_right();
+    return unique_ptr<PlanAnchor> {
+      AnchorForBinaryRel(this->op_wrap, this->op_wrap->mutable_merge_join(), nullptr)
+    };
+  }
 
-    // Then return the PlanAnchor message
-    return PlanAnchorForRel(simplified_rel.release());
+  unique_ptr<PlanAnchor> OpSet::ToPlanAnchor() {
+    return unique_ptr<PlanAnchor> {
+      AnchorForVariadicRel(this->op_wrap, this->op_wrap->mutable_set(), nullptr)
+    };
+  }
+
+  unique_ptr<PlanAnchor> OpExtMulti::ToPlanAnchor() {
+    return unique_ptr<PlanAnchor> {
+      AnchorForVariadicRel(this->op_wrap, this->op_wrap->mutable_extension_multi(), nullptr)
+    };
+  }
+
+  /**
+   * Returns a PlanAnchor for any relation kind that has inputs (else nullptr). The
+   * PlanAnchor is allocated on, and owned by, `arena` (see `AnchorForUnaryRel`).
+   */
+  PlanAnchor* PlanAnchorForRel(Rel *anchor_relmsg, Arena *arena) {
+    switch (anchor_relmsg->rel_type_case()) {
+      case Rel::RelTypeCase::kProject:
+        return AnchorForUnaryRel(anchor_relmsg, anchor_relmsg->mutable_project(), arena);
+      case Rel::RelTypeCase::kFilter:
+        return AnchorForUnaryRel(anchor_relmsg, anchor_relmsg->mutable_filter(), arena);
+      case Rel::RelTypeCase::kFetch:
+        return AnchorForUnaryRel(anchor_relmsg, anchor_relmsg->mutable_fetch(), arena);
+      case Rel::RelTypeCase::kSort:
+        return AnchorForUnaryRel(anchor_relmsg, anchor_relmsg->mutable_sort(), arena);
+      case Rel::RelTypeCase::kAggregate:
+        return AnchorForUnaryRel(anchor_relmsg, anchor_relmsg->mutable_aggregate(), arena);
+      case Rel::RelTypeCase::kCross:
+        return AnchorForBinaryRel(anchor_relmsg, anchor_relmsg->mutable_cross(), arena);
+      case Rel::RelTypeCase::kJoin:
+        return AnchorForBinaryRel(anchor_relmsg, anchor_relmsg->mutable_join(), arena);
+      case Rel::RelTypeCase::kHashJoin:
+        return AnchorForBinaryRel(anchor_relmsg, anchor_relmsg->mutable_hash_join(), arena);
+      case Rel::RelTypeCase::kMergeJoin:
+        return AnchorForBinaryRel(anchor_relmsg, anchor_relmsg->mutable_merge_join(), arena);
+      case Rel::RelTypeCase::kSet:
+        return AnchorForVariadicRel(anchor_relmsg, anchor_relmsg->mutable_set(), arena);
+      case Rel::RelTypeCase::kExtensionMulti:
+        return AnchorForVariadicRel(
+          anchor_relmsg, anchor_relmsg->mutable_extension_multi(), arena
+        );
+
+      default: { return nullptr; }
+    }
   }
 
   // >> End of plan_anchor() implementations
@@ -161,6 +229,18 @@ namespace mohair {
   QueryOpVec OpSort::GetOpInputs()  { return GetInputsUnary(this); }
   QueryOpVec OpAggr::GetOpInputs()  { return GetInputsUnary(this); }
 
+  size_t OpProj::InputCount()  { return 1; }
+  size_t OpSel::InputCount()   { return 1; }
+  size_t OpLimit::InputCount() { return 1; }
+  size_t OpSort::InputCount()  { return 1; }
+  size_t OpAggr::InputCount()  { return 1; }
+
+  QueryOp* OpProj::InputAt(size_t)  { return std::get<0>(op_inputs).get(); }
+  QueryOp* OpSel::InputAt(size_t)   { return std::get<0>(op_inputs).get(); }
+  QueryOp* OpLimit::InputAt(size_t) { return std::get<0>(op_inputs).get(); }
+  QueryOp* OpSort::InputAt(size_t)  { return std::get<0>(op_inputs).get(); }
+  QueryOp* OpAggr::InputAt(size_t)  { return std::get<0>(op_inputs).get(); }
+
 
   template <typename BinaryQueryOp>
   QueryOpVec GetInputsBinary(BinaryQueryOp *op) {
@@ -175,6 +255,99 @@ namespace mohair {
   QueryOpVec OpHashJoin::GetOpInputs()  { return GetInputsBinary(this); }
   QueryOpVec OpMergeJoin::GetOpInputs() { return GetInputsBinary(this); }
 
+  template <typename BinaryQueryOp>
+  QueryOp* InputAtBinary(BinaryQueryOp *op, size_t input_ndx) {
+    if (input_ndx == 0) { return std::get<0>(op->op_inputs).get(); }
+    return std::get<1>(op->op_inputs).get();
+  }
+
+  size_t OpJoin::InputCount()      { return 2; }
+  size_t OpCrossJoin::InputCount() { return 2; }
+  size_t OpHashJoin::InputCount()  { return 2; }
+  size_t OpMergeJoin::InputCount() { return 2; }
+
+  QueryOp* OpJoin::InputAt(size_t ndx)      { return InputAtBinary(this, ndx); }
+  QueryOp* OpCrossJoin::InputAt(size_t ndx) { return InputAtBinary(this, ndx); }
+  QueryOp* OpHashJoin::InputAt(size_t ndx)  { return InputAtBinary(this, ndx); }
+  QueryOp* OpMergeJoin::InputAt(size_t ndx) { return InputAtBinary(this, ndx); }
+
+
+  template <typename VariadicQueryOp>
+  QueryOpVec GetInputsVariadic(VariadicQueryOp *op) {
+    QueryOpVec in_op_list;
+
+    in_op_list.reserve(op->op_inputs.size());
+    for (const auto &op_input : op->op_inputs) { in_op_list.push_back(op_input.get()); }
+
+    return in_op_list;
+  }
+
+  QueryOpVec OpSet::GetOpInputs()      { return GetInputsVariadic(this); }
+  QueryOpVec OpExtMulti::GetOpInputs() { return GetInputsVariadic(this); }
+
+  size_t OpSet::InputCount()      { return op_inputs.size(); }
+  size_t OpExtMulti::InputCount() { return op_inputs.size(); }
+
+  QueryOp* OpSet::InputAt(size_t ndx)      { return op_inputs[ndx].get(); }
+  QueryOp* OpExtMulti::InputAt(size_t ndx) { return op_inputs[ndx].get(); }
+
+  // >> Access to the inputs of substrait relations (for supported relations)
+  size_t RelInputCount(const Rel &rel_msg) {
+    switch (rel_msg.rel_type_case()) {
+      case Rel::RelTypeCase::kProject:
+      case Rel::RelTypeCase::kFilter:
+      case Rel::RelTypeCase::kFetch:
+      case Rel::RelTypeCase::kSort:
+      case Rel::RelTypeCase::kAggregate: { return 1; }
+
+      case Rel::RelTypeCase::kCross:
+      case Rel::RelTypeCase::kJoin:
+      case Rel::RelTypeCase::kHashJoin:
+      case Rel::RelTypeCase::kMergeJoin: { return 2; }
+
+      case Rel::RelTypeCase::kSet:            { return rel_msg.set().inputs_size();             }
+      case Rel::RelTypeCase::kExtensionMulti: { return rel_msg.extension_multi().inputs_size(); }
+
+      default: { return 0; }
+    }
+  }
+
+  Rel* RelInputAt(Rel *rel_msg, size_t input_ndx) {
+    switch (rel_msg->rel_type_case()) {
+      case Rel::RelTypeCase::kProject:   { return rel_msg->mutable_project()->mutable_input();   }
+      case Rel::RelTypeCase::kFilter:    { return rel_msg->mutable_filter()->mutable_input();    }
+      case Rel::RelTypeCase::kFetch:     { return rel_msg->mutable_fetch()->mutable_input();     }
+      case Rel::RelTypeCase::kSort:      { return rel_msg->mutable_sort()->mutable_input();      }
+      case Rel::RelTypeCase::kAggregate: { return rel_msg->mutable_aggregate()->mutable_input(); }
+
+      case Rel::RelTypeCase::kCross: {
+        auto cross_rel = rel_msg->mutable_cross();
+        return input_ndx == 0 ? cross_rel->mutable_left() : cross_rel->mutable_right();
+      }
+      case Rel::RelTypeCase::kJoin: {
+        auto join_rel = rel_msg->mutable_join();
+        return input_ndx == 0 ? join_rel->mutable_left() : join_rel->mutable_right();
+      }
+      case Rel::RelTypeCase::kHashJoin: {
+        auto join_rel = rel_msg->mutable_hash_join();
+        return input_ndx == 0 ? join_rel->mutable_left() : join_rel->mutable_right();
+      }
+      case Rel::RelTypeCase::kMergeJoin: {
+        auto join_rel = rel_msg->mutable_merge_join();
+        return input_ndx == 0 ? join_rel->mutable_left() : join_rel->mutable_right();
+      }
+
+      case Rel::RelTypeCase::kSet: {
+        return rel_msg->mutable_set()->mutable_inputs(input_ndx);
+      }
+      case Rel::RelTypeCase::kExtensionMulti: {
+        return rel_msg->mutable_extension_multi()->mutable_inputs(input_ndx);
+      }
+
+      default: { return nullptr; }
+    }
+  }
+
   // >> End of op_inputs() implementations
 
   // >> Specific translation functions (from Substrait to Mohair)
@@ -210,6 +383,28 @@ namespace mohair {
     return binary_op;
   }
 
+  template <typename VariadicRelMsg, typename MohairRel>
+  unique_ptr<QueryOp> FromVariadicOpMsg(Rel *rel_msg, VariadicRelMsg *substrait_op) {
+    // recurse on each input relation
+    typename MohairRel::InputsType op_inputs;
+    op_inputs.reserve(substrait_op->inputs_size());
+
+    std::stringstream tname_stream;
+    for (int input_ndx = 0; input_ndx < substrait_op->inputs_size(); ++input_ndx) {
+      op_inputs.push_back(MohairFrom(substrait_op->mutable_inputs(input_ndx)));
+
+      if (input_ndx > 0) { tname_stream << "."; }
+      tname_stream << op_inputs.back()->table_name;
+    }
+
+    // prep params for the operator
+    string op_tname { tname_stream.str() };
+    auto variadic_op = std::make_unique<MohairRel>(substrait_op, rel_msg, op_tname);
+    variadic_op->op_inputs = std::move(op_inputs);
+
+    return variadic_op;
+  }
+
   unique_ptr<QueryOp> FromReadMsg(Rel *rel_msg, ReadRel *substrait_op) {
     // construct the operator
     string op_tname { SourceNameForRead(substrait_op) };
@@ -220,19 +415,15 @@ namespace mohair {
     return read_op;
   }
 
-  /*
   unique_ptr<QueryOp> FromSkyMsg(Rel *rel_msg, unique_ptr<SkyRel> substrait_op) {
-    // TODO: implementation
-    // TODO: validate inline construction of unique pointer
-    if (substrait_op == nullptr) {
-      auto sky_op = std::make_unique<OpSkyRead>();
-      return sky_op;
-    }
+    // construct the operator
+    string op_tname { SourceNameForSky(*substrait_op) };
+    unique_ptr<QueryOp> sky_op = std::make_unique<OpSkyRead>(
+      std::move(substrait_op), rel_msg, op_tname
+    );
 
-    return OpVariant {};
-    // return OpVariant { CreateRelVariant<OpSkyRead>(std::move(substrait_op)) };
+    return sky_op;
   }
-  */
 
 
   /**
@@ -278,24 +469,30 @@ namespace mohair {
         );
       }
 
+      // Translate variadic operators (e.g. a union of partitions)
+      case Rel::RelTypeCase::kSet: {
+        return FromVariadicOpMsg<SetRel, OpSet>(rel_msg, rel_msg->mutable_set());
+      }
+      case Rel::RelTypeCase::kExtensionMulti: {
+        return FromVariadicOpMsg<ExtensionMultiRel, OpExtMulti>(
+          rel_msg, rel_msg->mutable_extension_multi()
+        );
+      }
+
       // Translate leaf operators
       case Rel::RelTypeCase::kRead: {
         return FromReadMsg(rel_msg, rel_msg->mutable_read());
       }
-      case Rel::RelTypeCase::kExtensionLeaf:
-      /* TODO
-      {
-        substrait::ExtensionLeafRel *leaf_rel = rel_msg->mutable_extension_leaf();
-        if (leaf_rel->has_detail()) {
-          auto sky_rel = std::make_unique<SkyRel>();
-          leaf_rel->detail().UnpackTo(sky_rel.get());
-
-          return FromSkyMsg(rel_msg, sky_rel);
+      case Rel::RelTypeCase::kExtensionLeaf: {
+        auto sky_rel = std::make_unique<SkyRel>();
+        if (SkyRelFromLeaf(*rel_msg, sky_rel.get())) {
+          return FromSkyMsg(rel_msg, std::move(sky_rel));
         }
 
-        return FromSkyMsg(rel_msg, nullptr);
+        return std::make_unique<OpErr>(
+          rel_msg, "ParseError: extension leaf does not contain a SkyRel"
+        );
       }
-      */
 
       // Catch all error
       default: {
@@ -335,4 +532,19 @@ namespace mohair {
     }
   }
 
+  /** A Skytether partition is named by its domain and partition (not its slices). */
+  string SourceNameForSky(const SkyRel &sky_rel) {
+    return sky_rel.domain() + "." + sky_rel.partition();
+  }
+
+  /** Unpacks the SkyRel of an ExtensionLeafRel; returns false if there is none. */
+  bool SkyRelFromLeaf(const Rel &rel_msg, SkyRel *sky_rel) {
+    if (not rel_msg.has_extension_leaf()) { return false; }
+
+    const auto &leaf_rel = rel_msg.extension_leaf();
+    if (not leaf_rel.has_detail() or not leaf_rel.detail().Is<SkyRel>()) { return false; }
+
+    return leaf_rel.detail().UnpackTo(sky_rel);
+  }
+
 } // namespace: mohair
@@ -46,6 +46,9 @@ using substrait::JoinRel;
 using substrait::HashJoinRel;
 using substrait::MergeJoinRel;
 
+using substrait::SetRel;
+using substrait::ExtensionMultiRel;
+
 using substrait::ReadRel;
 
 using mohair::SkyRel;
@@ -77,9 +80,17 @@ namespace mohair {
     const string ToString() override;
   };
 
-  // TODO: figure out how this should bridge to skytether
+  /**
+   * A read of specific slices of a Skytether partition. The SkyRel is unpacked from the
+   * `detail` of an ExtensionLeafRel, so this op owns it (unlike other ops' `plan_op`).
+   */
   struct OpSkyRead : PipelineOp {
-    SkyRel  *plan_op;
+    unique_ptr<SkyRel> plan_op;
+
+    OpSkyRead(unique_ptr<SkyRel> op, Rel *rel, string &tname)
+      : PipelineOp(rel, tname), plan_op(std::move(op)) {}
+
+    const string ToString() override;
   };
 
   // >> Complete definitions of query operators
@@ -95,6 +106,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -109,6 +122,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -123,6 +138,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -139,6 +156,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -153,6 +172,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -167,6 +188,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -181,6 +204,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -195,6 +220,8 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
@@ -209,18 +236,47 @@ namespace mohair {
 
     const string           ToString()     override;
     std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
     unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
 
-  /* TODO: needs variadic op_inputs
+  //  |> Variadic operators (any number of inputs)
   struct OpSet : BreakerOp {
-    SetRel                          *plan_op;
-    tuple<unique_ptr<QueryOp>, ...>  op_inputs;
+    using InputsType = vector<unique_ptr<QueryOp>>;
+
+    SetRel     *plan_op;
+    InputsType  op_inputs;
+
+    OpSet(SetRel *op, Rel *rel, string &tname)
+      : BreakerOp(rel, tname), plan_op(op) {}
+
+    const string           ToString()     override;
+    std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
+    unique_ptr<PlanAnchor> ToPlanAnchor() override;
+  };
+
+  struct OpExtMulti : BreakerOp {
+    using InputsType = vector<unique_ptr<QueryOp>>;
+
+    ExtensionMultiRel *plan_op;
+    InputsType         op_inputs;
+
+    OpExtMulti(ExtensionMultiRel *op, Rel *rel, string &tname)
+      : BreakerOp(rel, tname), plan_op(op) {}
+
+    const string           ToString()     override;
+    std::vector<QueryOp *> GetOpInputs()  override;
+    size_t                 InputCount()   override;
+    QueryOp*               InputAt(size_t input_ndx) override;
+    unique_ptr<PlanAnchor> ToPlanAnchor() override;
   };
-  */
 
 
   // >> Convenience functions
   string SourceNameForRead(ReadRel *substrait_op);
+  string SourceNameForSky(const SkyRel &sky_rel);
 
 } // namespace: mohair
@@ -21,6 +21,18 @@
 
 #include "plans.hpp"
 
+//  >> Standard libs
+#include <algorithm>
+#include <iomanip>
+
+
+// ------------------------------
+// Type Aliases
+
+//  >> Protobuf types
+using google::protobuf::Message;
+using google::protobuf::FieldDescriptor;
+
 
 // ------------------------------
 // Functions
@@ -43,209 +55,727 @@ namespace mohair {
   }
 
 
-  // >> Query plan traversal functions
-  size_t FindTallJoinLeaf(PlanVec &plans) {
-    int    tallest_height = 0;
-    size_t match_ndx      = 0;
+  // >> Cost estimation functions
+
+  // Assumed row reductions of operators, since we have no column statistics
+  constexpr double default_filter_selectivity = 0.33;
+  constexpr double default_group_ratio        = 0.10;
+
+  // Assumed size of a source table that we have no statistics for
+  const TableStats default_table_stats { 1000000, 64 };
+
+  /**
+   * Estimates the output of `rel_msg` from estimates of its inputs. A relation without
+   * inputs reads `table_name`, which is looked up in `table_stats`.
+   */
+  OpEstimate EstimateRel( const Rel&        rel_msg
+                         ,const string&     table_name
+                         ,const OpEstimate* input_ests
+                         ,size_t            input_count
+                         ,const StatsMap&   table_stats) {
+    // Base case: a leaf reads a source table
+    if (input_count == 0) {
+      auto stats_it = table_stats.find(table_name);
+      const TableStats& src_stats = (
+          stats_it == table_stats.end()
+        ? default_table_stats
+        : stats_it->second
+      );
+
+      return OpEstimate {
+         static_cast<double>(src_stats.row_count)
+        ,static_cast<double>(src_stats.row_width)
+        ,static_cast<double>(src_stats.row_count)
+      };
+    }
 
-    // An element in PlanVec may be null if we previously moved it
-    for (size_t plan_ndx = 0; plan_ndx < plans.size(); ++plan_ndx) {
-      unique_ptr<AppPlan>& plan = plans[plan_ndx];
-      if (plan == nullptr) { continue; }
+    // Each operator processes the rows of its inputs
+    OpEstimate op_est;
+    for (size_t input_ndx = 0; input_ndx < input_count; ++input_ndx) {
+      op_est.compute_rows += input_ests[input_ndx].compute_rows + input_ests[input_ndx].row_count;
+    }
 
-      // we're only interested in bottom-most join operators
-      if (plan->attrs.plan_width != 2) { continue; }
+    const OpEstimate& input_est = input_ests[0];
+    switch (rel_msg.rel_type_case()) {
+      case Rel::RelTypeCase::kFilter: {
+        op_est.row_count = input_est.row_count * default_filter_selectivity;
+        op_est.row_width = input_est.row_width;
+        break;
+      }
 
-      // track the index that matches our criteria
-      if (plan->attrs.plan_height > tallest_height) {
-        std::cout << "[" << std::to_string(plan_ndx) << "]\tHeight: "
-                  <<        std::to_string(plan->attrs.plan_height)
-                  << std::endl
-        ;
+      case Rel::RelTypeCase::kFetch: {
+        auto fetch_count = static_cast<double>(rel_msg.fetch().count());
+        op_est.row_count = (
+            fetch_count > 0
+          ? std::min(fetch_count, input_est.row_count)
+          : input_est.row_count
+        );
+        op_est.row_width = input_est.row_width;
+        break;
+      }
 
-        match_ndx      = plan_ndx;
-        tallest_height = plan->attrs.plan_height;
+      case Rel::RelTypeCase::kAggregate: {
+        op_est.row_count = (
+            rel_msg.aggregate().groupings_size() == 0
+          ? 1
+          : input_est.row_count * default_group_ratio
+        );
+        op_est.row_width = input_est.row_width;
+        break;
+      }
+
+      case Rel::RelTypeCase::kCross: {
+        op_est.row_count = input_ests[0].row_count * input_ests[1].row_count;
+        op_est.row_width = input_ests[0].row_width + input_ests[1].row_width;
+        break;
+      }
+
+      // Assume joins are on keys, so each row of the larger input matches once
+      case Rel::RelTypeCase::kJoin:
+      case Rel::RelTypeCase::kHashJoin:
+      case Rel::RelTypeCase::kMergeJoin: {
+        op_est.row_count = std::max(input_ests[0].row_count, input_ests[1].row_count);
+        op_est.row_width = input_ests[0].row_width + input_ests[1].row_width;
+        break;
+      }
+
+      // A union outputs the rows of each input; other set operations are bounded by the
+      // rows of their first input
+      case Rel::RelTypeCase::kSet: {
+        auto set_op = rel_msg.set().op();
+        op_est.row_count = input_est.row_count;
+        op_est.row_width = input_est.row_width;
+
+        if (   set_op == substrait::SetRel::SET_OP_UNION_ALL
+            or set_op == substrait::SetRel::SET_OP_UNION_DISTINCT) {
+          for (size_t input_ndx = 1; input_ndx < input_count; ++input_ndx) {
+            op_est.row_count += input_ests[input_ndx].row_count;
+          }
+        }
+        break;
+      }
+
+      // Project and sort keep the shape of their input
+      default: {
+        op_est.row_count = input_est.row_count;
+        op_est.row_width = input_est.row_width;
+        break;
       }
     }
 
-    return match_ndx;
+    return op_est;
   }
 
+  bool SplitCost::IsCheaperThan(const SplitCost& other) const {
+    if (transfer_bytes != other.transfer_bytes) {
+      return transfer_bytes < other.transfer_bytes;
+    }
+
+    // for equal transfer, prefer pushing down more work
+    return compute_rows > other.compute_rows;
+  }
 
-  size_t FindLongPipelineLeaf(PlanVec &plans) {
-    int    longest_pipelen = 0;
-    size_t match_ndx       = 0;
+  // >> Projection pushdown
 
-    // An element in PlanVec may be null if we previously moved it
-    for (size_t plan_ndx = 0; plan_ndx < plans.size(); ++plan_ndx) {
-      unique_ptr<AppPlan>& plan = plans[plan_ndx];
-      if (plan == nullptr) { continue; }
+  /** Returns the number of names (in a NamedStruct) used by the children of a type. */
+  int NestedNameCount(const substrait::Type& field_type) {
+    int name_count = 0;
 
-      // track the index that matches our criteria
-      if (plan->attrs.pipe_len > longest_pipelen) {
-        std::cout << "[" << std::to_string(plan_ndx) << "]\tLen: "
-                  <<        std::to_string(plan->attrs.pipe_len)
-                  << std::endl
-        ;
+    switch (field_type.kind_case()) {
+      case substrait::Type::KindCase::kStruct: {
+        for (const auto& child_type : field_type.struct_().types()) {
+          name_count += 1 + NestedNameCount(child_type);
+        }
+        break;
+      }
+
+      case substrait::Type::KindCase::kList: {
+        name_count = NestedNameCount(field_type.list().type());
+        break;
+      }
 
-        match_ndx       = plan_ndx;
-        longest_pipelen = plan->attrs.pipe_len;
+      case substrait::Type::KindCase::kMap: {
+        name_count = (
+            NestedNameCount(field_type.map().key())
+          + NestedNameCount(field_type.map().value())
+        );
+        break;
       }
+
+      default: { break; }
     }
 
-    return match_ndx;
+    return name_count;
   }
 
+  /**
+   * Rewrites each reference to a top-level field of the input in `msg` (an expression, or
+   * part of one) through `field_map` (old field index -> new field index).
+   *
+   * Returns false if a reference is to a field that `field_map` doesn't have, or if `msg`
+   * contains a relation (a subquery), whose references we don't track. Outer references
+   * belong to an enclosing query, so they are unchanged.
+   */
+  bool RemapFieldRefs(Message* msg, const std::unordered_map<int, int>& field_map) {
+    if (msg->GetDescriptor() == Rel::descriptor()) { return false; }
+
+    if (msg->GetDescriptor() == substrait::Expression::FieldReference::descriptor()) {
+      auto field_ref = static_cast<substrait::Expression::FieldReference*>(msg);
+      if (not field_ref->has_root_reference()) { return true; }
 
-  unique_ptr<PlanSplit>
-  DecomposePlan(AppPlan& plan, DecomposeAlg method) {
-    switch (method) {
-      case TallJoinLeaf: {
-        size_t split_ndx = FindTallJoinLeaf(plan.break_ops);
-        return std::make_unique<PlanSplit>(plan, *(plan.break_ops[split_ndx]));
+      if (   not field_ref->has_direct_reference()
+          or not field_ref->direct_reference().has_struct_field()) {
+        return false;
       }
 
-      // LongPipelineLeaf is currently default algorithm
-      case LongPipelineLeaf: {
-        size_t split_ndx = FindLongPipelineLeaf(plan.bleaf_ops);
-        return std::make_unique<PlanSplit>(plan, *(plan.bleaf_ops[split_ndx]));
+      auto struct_field = field_ref->mutable_direct_reference()->mutable_struct_field();
+      auto field_entry  = field_map.find(struct_field->field());
+      if (field_entry == field_map.end()) { return false; }
+
+      struct_field->set_field(field_entry->second);
+      return true;
+    }
+
+    auto msg_reflection = msg->GetReflection();
+
+    vector<const FieldDescriptor*> msg_fields;
+    msg_reflection->ListFields(*msg, &msg_fields);
+
+    for (const FieldDescriptor* field : msg_fields) {
+      if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) { continue; }
+
+      if (not field->is_repeated()) {
+        if (not RemapFieldRefs(msg_reflection->MutableMessage(msg, field), field_map)) {
+          return false;
+        }
+
+        continue;
       }
 
-      default: {
-        std::cerr << "Unknown decomposition method" << std::endl;
-        return nullptr;
+      int field_size = msg_reflection->FieldSize(*msg, field);
+      for (int elem_ndx = 0; elem_ndx < field_size; ++elem_ndx) {
+        auto elem_msg = msg_reflection->MutableRepeatedMessage(msg, field, elem_ndx);
+        if (not RemapFieldRefs(elem_msg, field_map)) { return false; }
       }
     }
+
+    return true;
   }
 
-} // namespace: mohair
+  /**
+   * Narrows the base schema of `read_rel` to the fields selected by its projection, then
+   * clears the projection. The output of the read is unchanged: with a projection, a
+   * ReadRel emits only the selected fields, in the order they are selected.
+   *
+   * A read's filter and best effort filter reference the base schema, so their field
+   * references are remapped to the narrowed schema (see `RemapFieldRefs`).
+   *
+   * Returns false (and leaves `read_rel` unchanged) if the projection selects nested
+   * fields or a field that is not in the base schema, or if a filter references a field
+   * that the projection doesn't select.
+   */
+  bool ProjectReadSchema(substrait::ReadRel* read_rel) {
+    if (not read_rel->has_projection()) { return true; }
 
+    const auto& base_schema  = read_rel->base_schema();
+    const auto& base_types   = base_schema.struct_().types();
+    const auto& struct_items = read_rel->projection().select().struct_items();
 
-// ------------------------------
-// Classes
+    // Each top-level field uses its own name and the names of its children
+    vector<int> name_offsets;
+    name_offsets.reserve(base_types.size() + 1);
+    name_offsets.push_back(0);
 
-namespace mohair {
+    for (const auto& field_type : base_types) {
+      name_offsets.push_back(name_offsets.back() + 1 + NestedNameCount(field_type));
+    }
+
+    // Gather the names and types of the selected fields
+    substrait::NamedStruct projected_schema;
+    auto projected_struct = projected_schema.mutable_struct_();
+    projected_struct->set_nullability(base_schema.struct_().nullability());
+    projected_struct->set_type_variation_reference(
+      base_schema.struct_().type_variation_reference()
+    );
+
+    // base field -> projected field (the first selection of a field, if it repeats)
+    std::unordered_map<int, int> field_map;
+
+    for (const auto& struct_item : struct_items) {
+      int field_ndx = struct_item.field();
+      if (struct_item.has_child() or field_ndx < 0 or field_ndx >= base_types.size()) {
+        return false;
+      }
+
+      field_map.emplace(field_ndx, projected_struct->types_size());
+      projected_struct->add_types()->CopyFrom(base_types[field_ndx]);
+
+      int name_end = name_offsets[field_ndx + 1];
+      for (int name_ndx = name_offsets[field_ndx]; name_ndx < name_end; ++name_ndx) {
+        projected_schema.add_names(base_schema.names(name_ndx));
+      }
+    }
+
+    // remap filters before changing anything, so that a failure leaves the read unchanged
+    substrait::Expression projected_filter;
+    substrait::Expression projected_best_effort;
 
-  // >> Helper functions
+    if (read_rel->has_filter()) {
+      projected_filter.CopyFrom(read_rel->filter());
+      if (not RemapFieldRefs(&projected_filter, field_map)) { return false; }
+    }
 
-  void InsertionSortAppPlans( std::vector<unique_ptr<AppPlan>> &plans
-                             ,unique_ptr<AppPlan>               new_plan) {
-    auto plans_it = plans.begin();
+    if (read_rel->has_best_effort_filter()) {
+      projected_best_effort.CopyFrom(read_rel->best_effort_filter());
+      if (not RemapFieldRefs(&projected_best_effort, field_map)) { return false; }
+    }
 
-    // find the spot to insert
-    for (; plans_it != plans.end(); plans_it = std::next(plans_it)) {
-      if (new_plan->attrs.pipe_len > (*plans_it)->attrs.pipe_len) { break; }
+    if (read_rel->has_filter()) { read_rel->mutable_filter()->Swap(&projected_filter); }
+    if (read_rel->has_best_effort_filter()) {
+      read_rel->mutable_best_effort_filter()->Swap(&projected_best_effort);
     }
 
-    // we always insert, even if its at the end of the list
-    plans.insert(plans_it, std::move(new_plan));
+    read_rel->mutable_base_schema()->Swap(&projected_schema);
+    read_rel->clear_projection();
+
+    return true;
   }
 
-  // >> PlanAttrs functions
-  PlanAttrs& PlanAttrs::operator=(const PlanAttrs& other) {
-    pipe_len     = other.pipe_len;
-    plan_width   = other.plan_width;
-    plan_height  = other.plan_height;
-    break_height = other.break_height;
+  /**
+   * Applies the projection of each ReadRel in `plan_msg` to its base schema (see
+   * `ProjectReadSchema`), so that a table provider is given only the columns that a read
+   * needs. Returns the number of reads that were narrowed.
+   */
+  int PushReadProjections(Plan& plan_msg) {
+    int          pushed_count = 0;
+    vector<Rel*> rel_stack;
 
-    return *this;
+    for (auto& plan_rel : *(plan_msg.mutable_relations())) {
+      if (plan_rel.has_root()) {
+        rel_stack.push_back(plan_rel.mutable_root()->mutable_input());
+      }
+      else if (plan_rel.has_rel()) { rel_stack.push_back(plan_rel.mutable_rel()); }
+    }
+
+    while (not rel_stack.empty()) {
+      Rel* rel_msg = rel_stack.back();
+      rel_stack.pop_back();
+
+      bool is_projected = (
+            rel_msg->has_read()
+        and rel_msg->read().has_projection()
+        and ProjectReadSchema(rel_msg->mutable_read())
+      );
+      if (is_projected) { ++pushed_count; }
+
+      for (size_t input_ndx = 0; input_ndx < RelInputCount(*rel_msg); ++input_ndx) {
+        rel_stack.push_back(RelInputAt(rel_msg, input_ndx));
+      }
+    }
+
+    return pushed_count;
   }
 
-  string PlanAttrs::ToString() {
-    std::stringstream prop_stream;
 
-    prop_stream << "Plan properties:"   << std::endl
-                << "\tPipeline length:" << pipe_len     << std::endl
-                << "\tPlan width     :" << plan_width   << std::endl
-                << "\tPlan height    :" << plan_height  << std::endl
-                << "\tBreaker height :" << break_height << std::endl
-    ;
+  // >> Zone predicates (filters that zone maps can evaluate)
 
-    return prop_stream.str();
+  /** Returns the zone op for a substrait comparison function (false if unsupported). */
+  bool ZoneOpForFunction(const string& fn_name, ZoneOp* zone_op) {
+    static const std::unordered_map<string, ZoneOp> zone_ops {
+       { "equal"      , ZoneOp::Equal        }
+      ,{ "lt"         , ZoneOp::Less         }
+      ,{ "lte"        , ZoneOp::LessEqual    }
+      ,{ "gt"         , ZoneOp::Greater      }
+      ,{ "gte"        , ZoneOp::GreaterEqual }
+      ,{ "is_null"    , ZoneOp::IsNull       }
+      ,{ "is_not_null", ZoneOp::IsNotNull    }
+    };
+
+    auto op_entry = zone_ops.find(fn_name);
+    if (op_entry == zone_ops.end()) { return false; }
+
+    *zone_op = op_entry->second;
+    return true;
+  }
+
+  /** Returns the op for the same comparison with its arguments swapped (a < b: b > a). */
+  ZoneOp ReversedZoneOp(ZoneOp zone_op) {
+    switch (zone_op) {
+      case ZoneOp::Less:         { return ZoneOp::Greater;      }
+      case ZoneOp::LessEqual:    { return ZoneOp::GreaterEqual; }
+      case ZoneOp::Greater:      { return ZoneOp::Less;         }
+      case ZoneOp::GreaterEqual: { return ZoneOp::LessEqual;    }
+      default:                   { return zone_op;              }
+    }
   }
 
+  /** Returns the top-level field of a direct reference to an input field (or -1). */
+  int TopFieldForExpr(const substrait::Expression& expr_msg) {
+    if (not expr_msg.has_selection()) { return -1; }
+
+    const auto& field_ref = expr_msg.selection();
+    if (not field_ref.has_direct_reference() or not field_ref.has_root_reference()) {
+      return -1;
+    }
+
+    const auto& ref_segment = field_ref.direct_reference();
+    if (not ref_segment.has_struct_field() or ref_segment.struct_field().has_child()) {
+      return -1;
+    }
 
-  // >> AppPlan static functions
+    return ref_segment.struct_field().field();
+  }
 
   /**
-   * Walks a QueryOp DAG, propagating attributes from the leaves upwards in a depth-first
-   * order. When a pipeline breaking operation is encountered (e.g. Join or Aggregate),
-   * then the corresponding PlanAttrs is moved into an AppPlan and inserted into either
-   * break_ops or bleaf_ops.
+   * Writes a literal as a string that arrow can parse (see `arrow::Scalar::Parse`), along
+   * with the literal's type. Returns false for types that zone maps don't compare (and
+   * for null literals).
    */
-  PlanAttrs WalkPlanForDiscovery( QueryOp* parent_op
-                                 ,PlanVec& break_ops
-                                 ,PlanVec& bleaf_ops) {
-    // Base case: if there are no input ops, then return an empty PlanAttrs
-    auto child_ops = parent_op->GetOpInputs();
-    if (child_ops.size() == 0) { return PlanAttrs{}; }
-
-    // Variables to propagate attributes without a PlanAttrs instance
-    int p_len = 0, pl_width = 0, pl_height = 0, b_height = 0;
-    for (size_t op_ndx = 0; op_ndx < child_ops.size(); ++op_ndx) {
-      // Recurse on this op, then we can update properties
-      auto child_op     = child_ops[op_ndx];
-      auto child_attrs  = WalkPlanForDiscovery(child_op, break_ops, bleaf_ops);
-
-      // Update local variables
-      b_height   = std::max(b_height , child_attrs.break_height);
-      pl_height  = std::max(pl_height, child_attrs.plan_height );
-      pl_width  += child_attrs.plan_width;
-
-      if (not child_op->IsBreaker()) { p_len = std::max(p_len, child_attrs.pipe_len); }
-
-      // Update indices to breakers
-      else if (child_op->IsBreaker()) {
-        auto is_bleaf   = child_attrs.break_height == 1;
-        auto child_plan = std::make_unique<AppPlan>(child_op, child_attrs);
-        if (is_bleaf) { InsertionSortAppPlans(bleaf_ops, std::move(child_plan)); }
-        else          { InsertionSortAppPlans(break_ops, std::move(child_plan)); }
-      }
-    }
-
-    // Return attribute struct (with some value adjustments)
-    if (parent_op->IsBreaker()) { ++b_height; }
-    return PlanAttrs { p_len + 1, pl_width, pl_height + 1, b_height };
+  bool LiteralForExpr( const substrait::Expression&  expr_msg
+                      ,string*                      literal_str
+                      ,shared_ptr<arrow::DataType>* literal_type) {
+    if (not expr_msg.has_literal()) { return false; }
+
+    const auto&  literal_msg = expr_msg.literal();
+    stringstream literal_stream;
+
+    // floating-point values are written with enough digits to be parsed exactly
+    switch (literal_msg.literal_type_case()) {
+      case substrait::Expression::Literal::kBoolean: {
+        literal_stream << (literal_msg.boolean() ? "true" : "false");
+        *literal_type = arrow::boolean();
+        break;
+      }
+
+      case substrait::Expression::Literal::kI8: {
+        literal_stream << literal_msg.i8();
+        *literal_type = arrow::int8();
+        break;
+      }
+
+      case substrait::Expression::Literal::kI16: {
+        literal_stream << literal_msg.i16();
+        *literal_type = arrow::int16();
+        break;
+      }
+
+      case substrait::Expression::Literal::kI32: {
+        literal_stream << literal_msg.i32();
+        *literal_type = arrow::int32();
+        break;
+      }
+
+      case substrait::Expression::Literal::kI64: {
+        literal_stream << literal_msg.i64();
+        *literal_type = arrow::int64();
+        break;
+      }
+
+      case substrait::Expression::Literal::kFp32: {
+        literal_stream << std::setprecision(9) << literal_msg.fp32();
+        *literal_type = arrow::float32();
+        break;
+      }
+
+      case substrait::Expression::Literal::kFp64: {
+        literal_stream << std::setprecision(17) << literal_msg.fp64();
+        *literal_type = arrow::float64();
+        break;
+      }
+
+      case substrait::Expression::Literal::kString: {
+        literal_stream << literal_msg.string();
+        *literal_type = arrow::utf8();
+        break;
+      }
+
+      default: { return false; }
+    }
+
+    *literal_str = literal_stream.str();
+    return true;
   }
 
-  unique_ptr<AppPlan> AppPlanFromQueryOp(QueryOp *op) {
-    // Create a plan that wraps this operator
-    auto root_plan = std::make_unique<AppPlan>(op);
+  /**
+   * Appends a zone predicate for each conjunct of `cond_msg` that compares a field of the
+   * read to a literal. Other conjuncts are ignored, which only means that fewer chunks
+   * can be skipped; a disjunction is never split, since its parts don't each hold.
+   */
+  void CollectZonePredicates( const Plan&                   plan_msg
+                             ,const substrait::Expression&  cond_msg
+                             ,const vector<string>&         field_names
+                             ,vector<ZonePredicate>*        zone_preds) {
+    if (not cond_msg.has_scalar_function()) { return; }
+
+    const auto& fn_msg  = cond_msg.scalar_function();
+    string      fn_name = FunctionName(plan_msg, fn_msg.function_reference());
+
+    if (fn_name == "and") {
+      for (const auto& fn_arg : fn_msg.arguments()) {
+        if (fn_arg.has_value()) {
+          CollectZonePredicates(plan_msg, fn_arg.value(), field_names, zone_preds);
+        }
+      }
+
+      return;
+    }
+
+    ZoneOp zone_op;
+    if (not ZoneOpForFunction(fn_name, &zone_op)) { return; }
+
+    // null checks take only a field
+    if (zone_op == ZoneOp::IsNull or zone_op == ZoneOp::IsNotNull) {
+      if (fn_msg.arguments_size() != 1 or not fn_msg.arguments(0).has_value()) { return; }
+
+      int field_ndx = TopFieldForExpr(fn_msg.arguments(0).value());
+      if (field_ndx < 0 or field_ndx >= static_cast<int>(field_names.size())) { return; }
+
+      zone_preds->push_back(ZonePredicate { field_names[field_ndx], zone_op, "", nullptr });
+      return;
+    }
+
+    // comparisons take a field and a literal (in either order)
+    if (fn_msg.arguments_size() != 2)        { return; }
+    if (not fn_msg.arguments(0).has_value()) { return; }
+    if (not fn_msg.arguments(1).has_value()) { return; }
+
+    const auto* field_arg   = &(fn_msg.arguments(0).value());
+    const auto* literal_arg = &(fn_msg.arguments(1).value());
+    if (TopFieldForExpr(*field_arg) < 0) {
+      std::swap(field_arg, literal_arg);
+      zone_op = ReversedZoneOp(zone_op);
+    }
+
+    string                      literal_str;
+    shared_ptr<arrow::DataType> literal_type;
+    int                         field_ndx = TopFieldForExpr(*field_arg);
+    if (field_ndx < 0 or field_ndx >= static_cast<int>(field_names.size())) { return; }
+    if (not LiteralForExpr(*literal_arg, &literal_str, &literal_type))      { return; }
 
-    // Recurse on input operators
-    root_plan->attrs = WalkPlanForDiscovery(
-      op, root_plan->break_ops, root_plan->bleaf_ops
+    zone_preds->push_back(
+      ZonePredicate { field_names[field_ndx], zone_op, literal_str, literal_type }
     );
+  }
+
+  /** Returns the names of the top-level fields of a read's base schema. */
+  vector<string> TopFieldNames(const substrait::NamedStruct& base_schema) {
+    vector<string> field_names;
+    int            name_ndx = 0;
+
+    for (const auto& field_type : base_schema.struct_().types()) {
+      if (name_ndx >= base_schema.names_size()) { break; }
+
+      field_names.push_back(base_schema.names(name_ndx));
+      name_ndx += 1 + NestedNameCount(field_type);
+    }
+
+    return field_names;
+  }
+
+  /**
+   * Returns zone predicates for each named table read by `plan_msg`, keyed by the table's
+   * joined name (as `JoinStr(names, ".")`). Predicates come from a read's filter and best
+   * effort filter, and from a FilterRel directly over the read.
+   *
+   * Reads are expected to have no projection (see `PushReadProjections`), so field
+   * references resolve against the base schema. A table that is read more than once gets
+   * no predicates, since the chunks one read skips may be needed by another.
+   */
+  ZonePredicateMap ZonePredicatesForReads(Plan& plan_msg) {
+    ZonePredicateMap                zone_preds;
+    std::unordered_map<string, int> read_counts;
+    vector<Rel*>                    rel_stack;
+
+    for (auto& plan_rel : *(plan_msg.mutable_relations())) {
+      if (plan_rel.has_root()) {
+        rel_stack.push_back(plan_rel.mutable_root()->mutable_input());
+      }
+      else if (plan_rel.has_rel()) { rel_stack.push_back(plan_rel.mutable_rel()); }
+    }
+
+    while (not rel_stack.empty()) {
+      Rel* rel_msg = rel_stack.back();
+      rel_stack.pop_back();
+
+      for (size_t input_ndx = 0; input_ndx < RelInputCount(*rel_msg); ++input_ndx) {
+        rel_stack.push_back(RelInputAt(rel_msg, input_ndx));
+      }
+
+      // find the read that this relation filters (a FilterRel or a ReadRel itself)
+      const substrait::ReadRel*    read_msg = nullptr;
+      const substrait::Expression* cond_msg = nullptr;
+
+      if (rel_msg->has_filter() and rel_msg->filter().input().has_read()) {
+        read_msg = &(rel_msg->filter().input().read());
+        cond_msg = &(rel_msg->filter().condition());
+      }
+      else if (rel_msg->has_read()) { read_msg = &(rel_msg->read()); }
+
+      // field references must resolve against the base schema (no projection or emit)
+      if (read_msg == nullptr or not read_msg->has_named_table())      { continue; }
+      if (read_msg->has_projection() or read_msg->common().has_emit()) { continue; }
+
+      const auto& tname_parts = read_msg->named_table().names();
+      if (tname_parts.empty()) { continue; }
+
+      string tname       = JoinStr(vector<string>(tname_parts.begin(), tname_parts.end()), ".");
+      auto   field_names = TopFieldNames(read_msg->base_schema());
+      auto&  table_preds = zone_preds[tname];
+
+      if (cond_msg != nullptr) {
+        CollectZonePredicates(plan_msg, *cond_msg, field_names, &table_preds);
+        continue;
+      }
+
+      ++read_counts[tname];
+      if (read_msg->has_filter()) {
+        CollectZonePredicates(plan_msg, read_msg->filter(), field_names, &table_preds);
+      }
+
+      if (read_msg->has_best_effort_filter()) {
+        CollectZonePredicates(
+          plan_msg, read_msg->best_effort_filter(), field_names, &table_preds
+        );
+      }
+    }
+
+    // predicates of one read don't apply to another read of the same table
+    for (const auto& [tname, read_count] : read_counts) {
+      if (read_count > 1) { zone_preds.erase(tname); }
+    }
+
+    for (auto preds_entry = zone_preds.begin(); preds_entry != zone_preds.end();) {
+      if (preds_entry->second.empty()) { preds_entry = zone_preds.erase(preds_entry); }
+      else                             { ++preds_entry;                              }
+    }
+
+    return zone_preds;
+  }
+
+
+  // >> Functions for choosing an execution engine
+
+  /**
+   * Returns the number of aggregates in `plan_msg` that group by at least one expression
+   * (hash aggregates), as opposed to aggregates that produce a single row.
+   */
+  int GroupedAggregateCount(Plan& plan_msg) {
+    int          grouped_count = 0;
+    vector<Rel*> rel_stack;
+
+    for (auto& plan_rel : *(plan_msg.mutable_relations())) {
+      if (plan_rel.has_root()) {
+        rel_stack.push_back(plan_rel.mutable_root()->mutable_input());
+      }
+      else if (plan_rel.has_rel()) { rel_stack.push_back(plan_rel.mutable_rel()); }
+    }
+
+    while (not rel_stack.empty()) {
+      Rel* rel_msg = rel_stack.back();
+      rel_stack.pop_back();
+
+      if (rel_msg->has_aggregate()) {
+        for (const auto& grouping : rel_msg->aggregate().groupings()) {
+          if (grouping.grouping_expressions_size() > 0) {
+            ++grouped_count;
+            break;
+          }
+        }
+      }
+
+      for (size_t input_ndx = 0; input_ndx < RelInputCount(*rel_msg); ++input_ndx) {
+        rel_stack.push_back(RelInputAt(rel_msg, input_ndx));
+      }
+    }
+
+    return grouped_count;
+  }
 
-    return root_plan;
+  /** Returns the SkyRel of each Skytether read in `plan_msg`. */
+  vector<SkyRel> SkyRelsForPlan(Plan& plan_msg) {
+    vector<SkyRel> sky_rels;
+    vector<Rel*>   rel_stack;
+
+    for (auto& plan_rel : *(plan_msg.mutable_relations())) {
+      if (plan_rel.has_root()) {
+        rel_stack.push_back(plan_rel.mutable_root()->mutable_input());
+      }
+      else if (plan_rel.has_rel()) { rel_stack.push_back(plan_rel.mutable_rel()); }
+    }
+
+    while (not rel_stack.empty()) {
+      Rel* rel_msg = rel_stack.back();
+      rel_stack.pop_back();
+
+      SkyRel sky_rel;
+      if (SkyRelFromLeaf(*rel_msg, &sky_rel)) { sky_rels.push_back(std::move(sky_rel)); }
+
+      for (size_t input_ndx = 0; input_ndx < RelInputCount(*rel_msg); ++input_ndx) {
+        rel_stack.push_back(RelInputAt(rel_msg, input_ndx));
+      }
+    }
+
+    return sky_rels;
   }
 
-  void ViewOp(QueryOp *op, string *indent, std::stringstream *view_stream) {
-    // Add indentation for current op
-    if (op->IsBreaker()) { (*view_stream) << std::endl << *indent; }
-    else                 { (*view_stream)              <<    "  "; }
+  /** Returns the name of each named table read in `plan_msg` (in no particular order). */
+  vector<vector<string>> NamedTablesForPlan(Plan& plan_msg) {
+    vector<vector<string>> table_names;
+    vector<Rel*>           rel_stack;
+
+    for (auto& plan_rel : *(plan_msg.mutable_relations())) {
+      if (plan_rel.has_root()) {
+        rel_stack.push_back(plan_rel.mutable_root()->mutable_input());
+      }
+      else if (plan_rel.has_rel()) { rel_stack.push_back(plan_rel.mutable_rel()); }
+    }
 
-    // Append representation for this op
-    (*view_stream) << op->ViewStr();
+    while (not rel_stack.empty()) {
+      Rel* rel_msg = rel_stack.back();
+      rel_stack.pop_back();
 
-    // Increase indent for child ops
-    indent->append(2, ' ');
+      if (rel_msg->has_read() and rel_msg->read().has_named_table()) {
+        const auto& tname = rel_msg->read().named_table().names();
+        table_names.emplace_back(tname.begin(), tname.end());
+      }
 
-    // Recurse on child ops
-    std::vector<QueryOp *> child_ops = op->GetOpInputs();
-    for (size_t ndx = 0; ndx < child_ops.size(); ++ndx) {
-      ViewOp(child_ops[ndx], indent, view_stream);
+      for (size_t input_ndx = 0; input_ndx < RelInputCount(*rel_msg); ++input_ndx) {
+        rel_stack.push_back(RelInputAt(rel_msg, input_ndx));
+      }
     }
+
+    return table_names;
+  }
+
+} // namespace: mohair
+
+
+// ------------------------------
+// Classes
+
+namespace mohair {
+
+  // >> PlanAttrs functions
+  PlanAttrs& PlanAttrs::operator=(const PlanAttrs& other) {
+    pipe_len     = other.pipe_len;
+    plan_width   = other.plan_width;
+    plan_height  = other.plan_height;
+    break_height = other.break_height;
+
+    return *this;
   }
 
-  // >> AppPlan member functions
-  string AppPlan::ViewPlan() {
-    std::stringstream plan_str;
-    string            indent { "" };
+  string PlanAttrs::ToString() {
+    std::stringstream prop_stream;
 
-    ViewOp(plan_op, &indent, &plan_str);
+    prop_stream << "Plan properties:"   << std::endl
+                << "\tPipeline length:" << pipe_len     << std::endl
+                << "\tPlan width     :" << plan_width   << std::endl
+                << "\tPlan height    :" << plan_height  << std::endl
+                << "\tBreaker height :" << break_height << std::endl
+    ;
 
-    return plan_str.str();
+    return prop_stream.str();
   }
 
 } // namespace: mohair
@@ -255,49 +785,94 @@ namespace mohair {
 namespace mohair {
 
   /**
-   * A method that creates a substrait message for each subplan derived from a PlanSplit.
+   * Returns a serialized sub-plan rooted at `subplan_rootrel` and anchored at `anchor_msg`.
    *
-   * For each subplan, the general process is to:
-   *  1. create a copy of the original substrait message
-   *  2. replace the original root rel with the root rel of the sub-plan
-   *  3. set an anchor (rel in super-plan), which identifies the sink for the sub-plan.
-   * 
-   * The order of 2 and 3 is unimportant (we already have references to both in
-   * PlanSplit). Step 2 is what will allow the next consumer to only see the sub-plan.
-   * Step 3 will allow us to make merging of the pushback plan trivial (we will be able to
-   * use operator equality).
+   * The sub-plan is written field by field from our payload (see `SerializeSubplan`), so
+   * no copy of the payload is made. Returns an empty string if serialization failed.
    */
-  vector<unique_ptr<SubstraitMessage>>
-  SubstraitMessage::SubplansFromSplit(PlanSplit& split) {
-    // Get the anchor op and initialize some variables
-    QueryOp*         anchor_op     = split.anchor_op.plan_op;
-    auto             anchor_msg    = PlanAnchorFrom(anchor_op);
-    vector<QueryOp*> anchor_inputs = anchor_op->GetOpInputs();
+  string
+  SubstraitMessage::SubplanFromRel(const Rel& subplan_rootrel, const PlanAnchor& anchor_msg) {
+    return SerializeSubplan(*(this->payload), this->root_relndx, subplan_rootrel, anchor_msg);
+  }
 
+  /**
+   * A method that creates a serialized substrait message for each subplan derived from a
+   * GraphSplit.
+   *
+   * Each subplan is the original substrait message, except that:
+   *  1. the original root rel is replaced with the root rel of the sub-plan
+   *  2. an anchor (rel in super-plan) is set, which identifies the sink for the sub-plan.
+   *
+   * Step 1 is what will allow the next consumer to only see the sub-plan. Step 2 will
+   * allow us to make merging of the pushback plan trivial (we will be able to use
+   * operator equality).
+   *
+   * Returns no sub-plans if any sub-plan could not be serialized.
+   */
+  vector<string>
+  SubstraitMessage::SubplansFromSplit(const PlanGraph& plan, const GraphSplit& split) {
+    const PlanNode& anchor_node = plan.nodes[split.anchor_ndx];
+    const uint32_t* input_ndxs  = plan.InputsOf(split.anchor_ndx);
+    vector<Rel*>    input_rels;
+
+    input_rels.reserve(anchor_node.input_count);
+    for (uint32_t input_ndx = 0; input_ndx < anchor_node.input_count; ++input_ndx) {
+      input_rels.push_back(plan.nodes[input_ndxs[input_ndx]].rel_msg);
+    }
+
+    return SubplansForAnchor(anchor_node.rel_msg, input_rels, split.split_aggr);
+  }
+
+  /**
+   * Creates the sub-plans for a split anchored at `anchor_rel`, with `input_rels` inputs.
+   *
+   * If `split_aggr` is set and the anchor aggregate can be split (see `SplitAggregate`),
+   * there is a single sub-plan, rooted at the partial aggregate, and the anchor in our
+   * payload is replaced by the final phase. Our payload is then the super-plan: it reads
+   * the sub-plan's results from a placeholder (see `SubplanResultsName`) and combines
+   * them. A PlanGraph of our payload no longer describes it after such a split.
+   */
+  vector<string>
+  SubstraitMessage::SubplansForAnchor( Rel*                anchor_rel
+                                      ,const vector<Rel*>& input_rels
+                                      ,bool                split_aggr) {
     // Initialize the list of messages to return
-    vector<unique_ptr<SubstraitMessage>> subplan_msgs;
-    subplan_msgs.reserve(anchor_inputs.size());
+    vector<string> subplan_msgs;
+    subplan_msgs.reserve(input_rels.size());
 
-    // Create a substrait message for each input to the anchor
-    for (size_t input_ndx = 0; input_ndx < anchor_inputs.size(); ++input_ndx) {
-      QueryOp* input_op        = anchor_inputs[input_ndx];
-      Rel*     subplan_rootrel = input_op->op_wrap;
+    // Functions introduced by the split are declared in our payload before it is serialized
+    if (split_aggr) {
+      auto aggr_phases = SplitAggregate(*(this->payload), anchor_rel->aggregate());
 
-      // Create a copy of the original substrait message that we can modify
-      auto subplan_msg = std::make_unique<Plan>();
-      subplan_msg->CopyFrom(*(this->payload));
+      if (aggr_phases != nullptr) {
+        PlanAnchor anchor_msg;
+        *(anchor_msg.mutable_anchor_rel()) = *(aggr_phases->final_rel);
 
-      // Set the `PlanAnchor` message and replace the super-plan root
-      auto subplan_planext = subplan_msg->mutable_advanced_extensions();
-      auto subplan_oldroot = subplan_msg->mutable_relations(this->root_relndx)->mutable_root();
+        subplan_msgs.push_back(SubplanFromRel(*(aggr_phases->partial_rel), anchor_msg));
+        if (subplan_msgs.back().empty()) {
+          subplan_msgs.clear();
+          return subplan_msgs;
+        }
 
-      subplan_planext->mutable_optimization()->PackFrom(*(anchor_msg));
-      subplan_oldroot->mutable_input()->CopyFrom(*subplan_rootrel);
+        // the super-plan combines partial results where the aggregate was
+        *anchor_rel = std::move(*(aggr_phases->final_rel));
 
-      // Add a `SubstraitMessage` that wraps the `Plan` message
-      subplan_msgs.push_back(
-        std::make_unique<SubstraitMessage>(std::move(subplan_msg), this->root_relndx)
-      );
+        return subplan_msgs;
+      }
+
+      std::cerr << "Unable to split aggregate; pushing down its inputs" << std::endl;
+    }
+
+    // Create a substrait message for each input to the anchor (the anchor is on our arena)
+    auto anchor_msg = PlanAnchorForRel(anchor_rel, this->plan_arena.get());
+    for (const auto input_rel : input_rels) {
+      subplan_msgs.push_back(SubplanFromRel(*input_rel, *anchor_msg));
+
+      if (subplan_msgs.back().empty()) {
+        std::cerr << "Unable to serialize sub-plan; dropping split" << std::endl;
+        subplan_msgs.clear();
+        break;
+      }
     }
 
     return subplan_msgs;
@@ -65,6 +65,10 @@ namespace mohair {
     virtual bool                   IsBreaker()    { return false;            }
     virtual vector<QueryOp *>      GetOpInputs()  { return {};               }
     virtual unique_ptr<PlanAnchor> ToPlanAnchor() { return nullptr;          }
+
+    // Access to inputs by index (unlike GetOpInputs, these don't allocate)
+    virtual size_t   InputCount()      { return 0;       }
+    virtual QueryOp* InputAt(size_t)   { return nullptr; }
   };
 
   // Classes for distinguishing pipeline-able operators from pipeline breakers
@@ -103,11 +107,7 @@ namespace mohair {
 
   // Derived classes for query plans representing different levels of abstraction
 
-  // Forward declarations
-  struct AppPlan;
-
-
-  // Declare a struct of various tree properties that an AppPlan will have
+  // Declare a struct of various tree properties that each node of a PlanGraph will have
   struct PlanAttrs {
     int pipe_len;
     int plan_width;
@@ -119,7 +119,7 @@ namespace mohair {
       {}
 
     PlanAttrs() : PlanAttrs(1, 1, 1, 0) {}
-    PlanAttrs(PlanAttrs &other)
+    PlanAttrs(const PlanAttrs &other)
       : PlanAttrs(other.pipe_len, other.plan_width, other.plan_height, other.break_height)
       {}
 
@@ -128,35 +128,75 @@ namespace mohair {
     string ToString();
   };
 
+  // Kinds of operators in a PlanGraph
+  enum class OpKind : uint8_t {
+     Error
+    ,Read
+    ,Project
+    ,Filter
+    ,Fetch
+    ,Sort
+    ,Aggregate
+    ,CrossJoin
+    ,Join
+    ,HashJoin
+    ,MergeJoin
+    ,Set
+    ,ExtensionMulti
+    ,SkyRead
+  };
+
+  /**
+   * An operator in a PlanGraph.
+   *
+   * The node's inputs are the `input_count` node indices that start at `input_begin` in
+   * `PlanGraph::input_ndxs`, and its table name is at `name_ndx` in
+   * `PlanGraph::table_names`.
+   */
+  struct PlanNode {
+    OpKind    kind;
+    bool      is_breaker;
+    uint32_t  input_begin;
+    uint32_t  input_count;
+    uint32_t  name_ndx;
+    Rel      *rel_msg;
+    PlanAttrs attrs;
+  };
+
   /**
-   * A query plan that contains logical data manipulation operators only.
+   * A query plan that contains logical data manipulation operators only, in a compact,
+   * index-based representation.
    *
    * This is a query plan that is at the same abstraction level as an application and
    * knows nothing about decomposition or execution. This is the query plan that is
    * received by a computational storage system.
    *
-   * The properties of an AppPlan are used for:
+   * Nodes are stored contiguously in post-order (each node follows its inputs and the root
+   * is last), with their PlanAttrs precomputed. A PlanGraph indexes pipeline breakers
+   * (other than the root), ordered by descending pipeline length, which are used for:
    *  - splitting a query into a super-plan and many sub-plans
    *  - merging a sub-plan into a super-plan (repeated to merge many sub-plans)
    */
-  struct AppPlan : QueryPlan {
-    // A set of attributes that a node in an AppPlan has
-    PlanAttrs      attrs;
-    vector<string> source_names;
-
-    // Indices into interesting operators in the AppPlan
-    vector<unique_ptr<AppPlan>> break_ops;
-    vector<unique_ptr<AppPlan>> bleaf_ops;
-
-    AppPlan(QueryOp *op)                       : QueryPlan(op)                   {};
-    AppPlan(QueryOp *op, PlanAttrs &new_attrs) : QueryPlan(op), attrs(new_attrs) {};
-
-    string ViewPlan();
+  struct PlanGraph {
+    vector<PlanNode> nodes;
+    vector<uint32_t> input_ndxs;
+    vector<string>   table_names;
+
+    // Indices into interesting nodes
+    vector<uint32_t> break_ndxs;
+    vector<uint32_t> bleaf_ndxs;
+
+    uint32_t        RootIndex()                  const { return nodes.size() - 1; }
+    const uint32_t* InputsOf(uint32_t node_ndx)  const;
+    const string&   TableName(uint32_t node_ndx) const;
+
+    string ToString(uint32_t node_ndx) const;
+    string ViewPlan(uint32_t root_ndx) const;
+    string ViewPlan()                  const;
   };
 
-  using PlanVec = vector<unique_ptr<AppPlan>>;
-
-  unique_ptr<AppPlan> AppPlanFromQueryOp(QueryOp *op);
+  unique_ptr<PlanGraph> PlanGraphFrom(Rel *rel_msg);
+  unique_ptr<PlanGraph> PlanGraphFrom(PlanMessage& substrait_plan);
 
 
   /**
@@ -168,7 +208,7 @@ namespace mohair {
    * same data processing operators as an application. This is the query plan that a
    * computational storage device may pass downstream.
    *
-   * NOTE: Without information, a SysPlan is identical to an AppPlan. In the limit, a
+   * NOTE: Without information, a SysPlan is identical to a PlanGraph. In the limit, a
    * SysPlan will have data flow operators that represent a "best distribution" of the
    * query plan across the computational storage system.
    *
@@ -212,16 +252,19 @@ namespace mohair {
 namespace mohair {
 
   /**
-   * A class that points to a super-plan and an anchor operator.
+   * A split of a PlanGraph at an anchor: the node at `anchor_ndx`.
    *
    * The anchor is an operator whose input is on the cut of the plan. This means that the
    * anchor is a leaf in the super-plan and a parent of each sub-plan root.
+   *
+   * If `split_aggr` is set, the anchor is an aggregate that should be split into a
+   * partial aggregate (the sub-plan root) and a final aggregate (the anchor).
    */
-  struct PlanSplit {
-    AppPlan& query_plan;
-    AppPlan& anchor_op;
+  struct GraphSplit {
+    uint32_t anchor_ndx;
+    bool     split_aggr { false };
 
-    PlanSplit(AppPlan& qplan, AppPlan& anchor): query_plan(qplan), anchor_op(anchor) {}
+    GraphSplit(uint32_t anchor): anchor_ndx(anchor) {}
   };
 
   enum DecomposeAlg {
@@ -229,6 +272,44 @@ namespace mohair {
     ,LongPipelineHead // Internal pipeline breaker with longest pipeline
     ,TallJoinLeaf     // Leaf join operation with tallest plan height
     ,WideJoinHead     // Internal join operation with largest plan width
+    ,PartialAggregate // Leaf aggregate split into partial and final phases
+    ,MinTransfer      // Pipeline breaker whose inputs transfer the fewest bytes
+    ,SetBranches      // Set operation (e.g. union) with the most inputs
+  };
+
+  /**
+   * The estimated cost of a split: bytes that sub-plans transfer to the super-plan, and
+   * rows that sub-plans process (work that is pushed down).
+   */
+  struct SplitCost {
+    double transfer_bytes { 0 };
+    double compute_rows   { 0 };
+
+    bool IsCheaperThan(const SplitCost& other) const;
+  };
+
+  /** The estimated output of an operator and the rows processed by its subtree. */
+  struct OpEstimate {
+    double row_count    { 0 };
+    double row_width    { 0 };
+    double compute_rows { 0 };
+  };
+
+  // First part of a table name that a super-plan reads the results of a sub-plan from
+  const string subplan_results_marker { "mohair.subplan" };
+
+  /**
+   * The two phases of a split aggregate.
+   *
+   * The partial phase is pushed down (it replaces the aggregate in a sub-plan) and the
+   * final phase combines partial results (it replaces the aggregate in the super-plan).
+   * The final phase reads partial results from a placeholder: a read of the named table
+   * [subplan_results_marker, "0"] (see `SubplanResultsName`), which an engine binds to
+   * the sub-plan's results.
+   */
+  struct AggrPhases {
+    unique_ptr<Rel> partial_rel;
+    unique_ptr<Rel> final_rel;
   };
 
 } // namespace: mohair
@@ -243,10 +324,54 @@ namespace mohair {
   unique_ptr<QueryOp>    MohairFrom(Rel *rel_msg);
   unique_ptr<QueryOp>    MohairPlanFrom(PlanMessage& substrait_plan);
   unique_ptr<PlanAnchor> PlanAnchorFrom(QueryOp* mohair_op);
+  PlanAnchor*            PlanAnchorForRel(Rel* anchor_relmsg, Arena* arena);
   Rel&                   SubstraitRelFrom(QueryOp* mohair_op);
 
+  // >> Access to Skytether reads (SkyRel in the detail of an ExtensionLeafRel)
+  bool           SkyRelFromLeaf(const Rel& rel_msg, SkyRel* sky_rel);
+  vector<SkyRel> SkyRelsForPlan(Plan& plan_msg);
+
+  // >> Access to named table reads
+  vector<vector<string>> NamedTablesForPlan(Plan& plan_msg);
+
+  // >> Access to the inputs of substrait relations
+  size_t RelInputCount(const Rel& rel_msg);
+  Rel*   RelInputAt(Rel* rel_msg, size_t input_ndx);
+
   // >> Functions for query plan processing
-  unique_ptr<PlanSplit>
-  DecomposePlan(AppPlan& plan, DecomposeAlg method = LongPipelineLeaf);
+  OpEstimate EstimateRel( const Rel&        rel_msg
+                         ,const string&     table_name
+                         ,const OpEstimate* input_ests
+                         ,size_t            input_count
+                         ,const StatsMap&   table_stats);
+
+  // >> Functions for rewriting plans before execution
+  int  NestedNameCount(const substrait::Type& field_type);
+  bool ProjectReadSchema(substrait::ReadRel* read_rel);
+  int  PushReadProjections(Plan& plan_msg);
+
+  // >> Functions for pruning reads with zone maps (predicates keyed by joined table name)
+  using ZonePredicateMap = std::unordered_map<string, vector<ZonePredicate>>;
+  ZonePredicateMap ZonePredicatesForReads(Plan& plan_msg);
+
+  // >> Functions for choosing an execution engine
+  int GroupedAggregateCount(Plan& plan_msg);
+
+  // >> Functions for extension declarations (implementation in aggregates.cpp)
+  string FunctionName(const Plan& plan_msg, uint32_t fn_anchor);
+
+  // >> Functions for PlanGraph processing (implementation in graph.cpp)
+  vector<OpEstimate> EstimateGraph(const PlanGraph& plan, const StatsMap& table_stats = {});
+
+  unique_ptr<GraphSplit>
+  DecomposeGraph( const PlanGraph& plan
+                 ,DecomposeAlg     method      = LongPipelineLeaf
+                 ,const StatsMap&  table_stats = {});
+
+  // >> Functions for splitting aggregates (implementation in aggregates.cpp)
+  vector<string> SubplanResultsName(size_t subplan_ndx);
+
+  unique_ptr<AggrPhases>
+  SplitAggregate(Plan& plan_msg, const substrait::AggregateRel& aggr_msg);
 
 } // namespace: mohair
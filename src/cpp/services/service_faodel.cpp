@@ -21,7 +21,7 @@
 namespace mohair::services {
 
   Status StartDefaultFaodelService() {
-    unique_ptr<FlightServerBase> faodel_service = std::make_unique<FaodelService>();
+    unique_ptr<MohairService> faodel_service = std::make_unique<FaodelService>();
     return StartService(faodel_service);
   }
 
@@ -36,9 +36,12 @@ namespace mohair::services {
   //  >> FaodelService
 
   Status FaodelService::Init(const FlightServerOptions &options) {
+    // Plans execute within the context configured for the Faodel adapter (see
+    // `QueryContextForConfig`), so the base Init does not make another
+    query_ctx = faodel_if.query_ctx;
+
     // Call base Init and return if an error occurred
-    std::cout << "Initializing Base Server" << std::endl;
-    auto parent_status = FlightServerBase::Init(options);
+    auto parent_status = MohairService::Init(options);
     if (not parent_status.ok()) { return parent_status; }
 
     // Initialize a Faodel adapter for this service to interact with
@@ -46,95 +49,88 @@ namespace mohair::services {
     faodel_if.BootstrapWithKelpie(/*argc=*/0, /*argv=*/nullptr);
     faodel_if.PrintMPIInfo();
 
-    // register a compute function with kelpie
+    // register compute functions with kelpie (they execute within our query context)
     faodel_if.RegisterEngineAcero();
     faodel_pool = faodel_if.ConnectToPool();
 
     return Status::OK();
   }
 
-  Status FaodelService::ListFlights( [[maybe_unused]] const ServerCallContext   &context
-                                    ,[[maybe_unused]] const Criteria            *criteria
-                                    ,[[maybe_unused]] unique_ptr<FlightListing> *listings) {
-
-    // TODO: figure out how to query catalog metadata
-    /*
-    vector<FlightInfo> flights = ...;
-    *listings = std::make_unique<SimpleFlightListing>(flights);
-    */
-
-    return Status::NotImplemented("TODO");
-  }
-
-  Status FaodelService::GetFlightInfo( [[maybe_unused]] const ServerCallContext &context
-                                      ,[[maybe_unused]] const FlightDescriptor  &request
-                                      ,[[maybe_unused]] unique_ptr<FlightInfo>  *info) {
-    return Status::NotImplemented("TODO");
+  /**
+   * Named tables are resolved from the kelpie pool. Each table is fetched when the plan is
+   * translated and scanned lazily, one chunk at a time, during execution. Chunks are
+   * prefetched on the executor of this service's query context.
+   */
+  NamedTableProvider FaodelService::TableProvider() {
+    return mohair::adapters::ProviderForKelpPool(
+       faodel_pool
+      ,faodel_if.stream_opts.batch_size
+      ,query_ctx != nullptr ? query_ctx->QueryExecutor() : nullptr
+    );
   }
 
-  // >= 13.0.0
-  /*
-  Status FaodelService::PollFlightInfo( const ServerCallContext &context
-                                       ,const FlightDescriptor   &request
-                                       ,unique_ptr<PollInfo>     *info) {
-    return Status::NotImplemented("TODO");
+  /**
+   * If the plan is a union (all) of branches that each read one table or partition, each
+   * branch is executed where its data is (see `ScatterBranches`). Otherwise, the plan is
+   * executed here, like any other service. Errors (e.g. when executing a branch) are
+   * returned as they are; they never cause the plan to be executed here instead.
+   */
+  Result<shared_ptr<RecordBatchReader>>
+  FaodelService::StreamQuery(const shared_ptr<Buffer> &plan_msg) {
+    ARROW_ASSIGN_OR_RAISE(auto scatter_reader, ScatterBranches(plan_msg));
+    if (scatter_reader == nullptr) { return MohairService::StreamQuery(plan_msg); }
+
+    return scatter_reader;
   }
-  */
 
-  Status FaodelService::GetSchema( [[maybe_unused]] const ServerCallContext  &context
-                                  ,[[maybe_unused]] const FlightDescriptor   &request
-                                  ,[[maybe_unused]] unique_ptr<SchemaResult> *schema) {
-    return Status::NotImplemented("TODO");
-  }
-
-  Status FaodelService::DoGet( [[maybe_unused]] const ServerCallContext      &context
-                              ,[[maybe_unused]] const Ticket                 &request
-                              ,[[maybe_unused]] unique_ptr<FlightDataStream> *writer) {
-    return Status::NotImplemented("TODO");
-  }
+  /**
+   * Splits a plan whose root is a union (all) into its branches (see `SetBranches`),
+   * derives the key of each branch from its read (see `KeysForBranches`), and executes
+   * the branches against their keys concurrently. Results are read as the branches
+   * produce them (see `ScatterEngineAcero`).
+   *
+   * Returns nullptr if the plan is not a union of branches that can be split this way,
+   * and an error if the plan is invalid or a branch fails.
+   */
+  Result<shared_ptr<RecordBatchReader>>
+  FaodelService::ScatterBranches(const shared_ptr<Buffer> &plan_msg) {
+    string           plan_str { plan_msg->ToString() };
+    SubstraitMessage substrait_msg { plan_str };
+    if (substrait_msg.payload == nullptr) {
+      return Status::Invalid("Unable to parse substrait plan");
+    }
 
-  Status FaodelService::DoPut( [[maybe_unused]] const ServerCallContext          &context
-                              ,[[maybe_unused]] unique_ptr<FlightMessageReader>   reader
-                              ,[[maybe_unused]] unique_ptr<FlightMetadataWriter>  writer) {
-    return Status::NotImplemented("TODO");
-  }
+    auto plan_graph = mohair::PlanGraphFrom(substrait_msg);
+    if (plan_graph == nullptr or plan_graph->nodes.empty()) {
+      return Status::Invalid("Unable to build plan graph (expected exactly one root)");
+    }
 
-  Status FaodelService::DoExchange( [[maybe_unused]] const ServerCallContext         &context
-                                   ,[[maybe_unused]] unique_ptr<FlightMessageReader>  reader
-                                   ,[[maybe_unused]] unique_ptr<FlightMessageWriter>  writer) {
-    return Status::NotImplemented("TODO");
-  }
+    const auto &root_node = plan_graph->nodes[plan_graph->RootIndex()];
+    bool        is_union  = (
+          root_node.kind == mohair::OpKind::Set
+      and root_node.rel_msg->set().op() == substrait::SetRel::SET_OP_UNION_ALL
+    );
+    if (not is_union) { return nullptr; }
 
-  Status FaodelService::DoAction( [[maybe_unused]] const ServerCallContext  &context
-                                 ,                 const Action             &action
-                                 ,                 unique_ptr<ResultStream> *result) {
-    if (action.type == "query") {
-      return ActionQuery(context, action.body, result);
+    auto plan_split = mohair::DecomposeGraph(*plan_graph, mohair::SetBranches);
+    if (plan_split == nullptr or plan_split->anchor_ndx != plan_graph->RootIndex()) {
+      return nullptr;
     }
 
-    // Catch all that returns Status::NotImplemented()
-    return ActionUnknown(context, action.type);
-  }
-
-  Status FaodelService::ListActions( [[maybe_unused]] const ServerCallContext  &context
-                                    ,[[maybe_unused]] vector<ActionType>       *actions) {
-    return Status::NotImplemented("TODO");
-  }
+    auto subplan_msgs = substrait_msg.SubplansFromSplit(*plan_graph, *plan_split);
+    if (subplan_msgs.empty()) { return Status::Invalid("Unable to serialize union branches"); }
 
+    // a branch that doesn't read exactly one table or partition is executed here
+    auto branch_keys = mohair::adapters::KeysForBranches(subplan_msgs);
+    if (not branch_keys.ok()) { return nullptr; }
 
-  Status FaodelService::ActionQuery( [[maybe_unused]] const ServerCallContext  &context
-                                    ,                 const shared_ptr<Buffer>  plan_msg
-                                    ,[[maybe_unused]] unique_ptr<ResultStream> *result) {
-    // TODO receive the plan then execute it with Faodel.
-    // faodel_if.ExecuteEngineAcero(faodel_pool, <key>, plan_msg);
-    string plan_data = plan_msg->ToString();
-    auto substrait_plan = mohair::SubstraitPlanFromString(plan_data);
-    return Status::NotImplemented("TODO: query service");
-  }
+    vector<shared_ptr<Buffer>> branch_plans;
+    branch_plans.reserve(subplan_msgs.size());
+    for (auto &subplan_msg : subplan_msgs) {
+      branch_plans.push_back(Buffer::FromString(std::move(subplan_msg)));
+    }
 
-  Status FaodelService::ActionUnknown( [[maybe_unused]] const ServerCallContext &context
-                                      ,                 const string             action_type) {
-    return Status::NotImplemented("Unknown action: [", action_type, "]");
+    return faodel_if.ScatterEngineAcero(faodel_pool, *branch_keys, branch_plans);
   }
 
 } // namespace: mohair::services
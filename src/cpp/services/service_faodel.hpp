@@ -41,69 +41,26 @@
 
       Status Init(const FlightServerOptions &options) override;
 
-      Status ListFlights(
-         const ServerCallContext&   context
-        ,const Criteria*            criteria
-        ,unique_ptr<FlightListing>* listings
-      ) override;
-
-      Status GetFlightInfo(
-         const ServerCallContext& context
-        ,const FlightDescriptor&  request
-        ,unique_ptr<FlightInfo>*  info
-      ) override;
-   
-      Status GetSchema(
-         const ServerCallContext&  context
-        ,const FlightDescriptor&   request
-        ,unique_ptr<SchemaResult>* schema
-      ) override;
-
-      Status DoGet(
-         const ServerCallContext&      context
-        ,const Ticket&                 request
-        ,unique_ptr<FlightDataStream>* stream
-      ) override;
-
-      Status DoPut(
-         const ServerCallContext&         context
-        ,unique_ptr<FlightMessageReader>  reader
-        ,unique_ptr<FlightMetadataWriter> writer
-      ) override;
-
-      Status DoExchange(
-         const ServerCallContext&        context
-        ,unique_ptr<FlightMessageReader> reader
-        ,unique_ptr<FlightMessageWriter> writer
-      ) override;
-
-      Status DoAction(
-         const ServerCallContext&  context
-        ,const Action&             action
-        ,unique_ptr<ResultStream>* result
-      ) override;
-
-      Status ListActions(
-         const ServerCallContext& context
-        ,vector<ActionType>*      actions
-      ) override;
-
-      Status ActionQuery(
-         const ServerCallContext&  context
-        ,const shared_ptr<Buffer>  plan_msg
-        ,unique_ptr<ResultStream>* result
-      ) override;
-
-      Status ActionUnknown(
-         const ServerCallContext& context
-        ,const string             action_type
-      ) override;
-
-      //  >> Convenience functions
-      FlightInfo MakeFlightInfo();
+      //  >> Functions for query execution
+      NamedTableProvider TableProvider() override;
+
+      Result<shared_ptr<RecordBatchReader>>
+      StreamQuery(const shared_ptr<Buffer> &plan_msg) override;
+
+      Result<shared_ptr<RecordBatchReader>> ScatterBranches(const shared_ptr<Buffer> &plan_msg);
 
     };
 
   } // namespace: mohair::services
 
+
+  // ------------------------------
+  // Functions
+
+  namespace mohair::services {
+
+    Status StartDefaultFaodelService();
+
+  } // namespace: mohair::services
+
 #endif // essentially an include guard that uses USE_FAODEL
@@ -0,0 +1,59 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "service_files.hpp"
+
+
+// ------------------------------
+// Functions
+
+namespace mohair::services {
+
+  Status StartFileService(const string &root_uri) {
+    unique_ptr<MohairService> file_service = std::make_unique<FileService>(root_uri);
+    return StartService(file_service);
+  }
+
+} // namespace: mohair::services
+
+
+// ------------------------------
+// Classes and Methods
+
+namespace mohair::services {
+
+  //  >> FileService
+
+  /** The provider is created once, so the root is only resolved when the service starts. */
+  Status FileService::Init(const FlightServerOptions &options) {
+    auto parent_status = MohairService::Init(options);
+    if (not parent_status.ok()) { return parent_status; }
+
+    std::cout << "Serving tables under: " << root_uri << std::endl;
+    file_provider = mohair::adapters::ProviderForDirectory(root_uri, scan_opts);
+
+    return Status::OK();
+  }
+
+  /** Named tables are resolved to IPC or Parquet files under `root_uri`. */
+  NamedTableProvider FileService::TableProvider() { return file_provider; }
+
+} // namespace: mohair::services
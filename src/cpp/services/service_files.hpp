@@ -0,0 +1,63 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+#pragma once
+
+// >> flight deps
+#include "service_mohair.hpp"
+
+// >> integration with files (IPC and Parquet)
+#include "../engines/adapter_files.hpp"
+
+
+// ------------------------------
+// Classes
+
+namespace mohair::services {
+
+  /**
+   * A service whose named tables are files under a root directory (see
+   * `ProviderForDirectory`). A root may be a local path or a filesystem URI.
+   */
+  struct FileService : public virtual MohairService {
+    string                            root_uri;
+    mohair::adapters::FileScanOptions scan_opts;
+    NamedTableProvider                file_provider;
+
+    FileService(const string &root, const mohair::adapters::FileScanOptions &opts = {})
+      : root_uri(root), scan_opts(opts) {}
+
+    Status Init(const FlightServerOptions &options) override;
+
+    //  >> Functions for query execution
+    NamedTableProvider TableProvider() override;
+  };
+
+} // namespace: mohair::services
+
+
+// ------------------------------
+// Functions
+
+namespace mohair::services {
+
+  Status StartFileService(const string &root_uri);
+
+} // namespace: mohair::services
@@ -34,13 +34,13 @@ namespace mohair::services {
     return Status::OK();
   }
 
-  Status StartService(unique_ptr<FlightServerBase>& service) {
+  Status StartService(unique_ptr<MohairService>& service) {
     // Initialize a location
-    Location *srv_loc { nullptr };
-    ARROW_RETURN_NOT_OK(SetDefaultLocation(srv_loc));
+    Location srv_loc;
+    ARROW_RETURN_NOT_OK(SetDefaultLocation(&srv_loc));
 
     // Create the service instance
-    FlightServerOptions options { *srv_loc };
+    FlightServerOptions options { srv_loc };
 
     std::cout << "Initializing service..." << std::endl;
     ARROW_RETURN_NOT_OK(service->Init(options));
@@ -55,3 +55,368 @@ namespace mohair::services {
   }
 
 } // namespace: mohair::services
+
+
+// ------------------------------
+// Classes and Methods
+
+namespace mohair::services {
+
+  //  >> MohairService
+
+  /** If DuckDB is enabled but cannot be started, every plan is executed by Acero. */
+  Status MohairService::Init(const FlightServerOptions &options) {
+    std::cout << "Initializing Base Server" << std::endl;
+
+    // subclasses may share a context made elsewhere (e.g. from an adapter's config)
+    if (query_ctx == nullptr) {
+      ARROW_ASSIGN_OR_RAISE(
+         query_ctx
+        ,mohair::adapters::QueryContext::Make(query_threads, query_limit)
+      );
+    }
+
+    #if USE_DUCKDB
+      auto duck_result = mohair::adapters::DuckEngine::Make();
+      if (duck_result.ok()) { duck_engine = std::move(duck_result).ValueOrDie(); }
+      else { mohair::PrintError("Unable to start DuckDB engine", duck_result.status()); }
+    #endif
+
+    return FlightServerBase::Init(options);
+  }
+
+  /** Flights are not listed: a flight only exists for a plan that a client submits. */
+  Status MohairService::ListFlights( [[maybe_unused]] const ServerCallContext   &context
+                                    ,[[maybe_unused]] const Criteria            *criteria
+                                    ,[[maybe_unused]] unique_ptr<FlightListing> *listings) {
+    return Status::NotImplemented(
+      "ListFlights is not supported; submit a plan via GetFlightInfo or the 'query' action"
+    );
+  }
+
+  /**
+   * Submits the substrait plan in a command descriptor and describes its results.
+   *
+   * The returned FlightInfo contains the result schema and a single endpoint whose ticket
+   * can be passed to `DoGet`. The row count is not known until the plan is executed, so
+   * it is estimated from table statistics (see `EstimateRowsFor`). The schema comes from
+   * the translated plan, so no named tables are bound (or read) until the ticket is
+   * retrieved.
+   */
+  Status MohairService::GetFlightInfo( [[maybe_unused]] const ServerCallContext &context
+                                      ,                 const FlightDescriptor  &request
+                                      ,                 unique_ptr<FlightInfo>  *info) {
+    if (request.type != FlightDescriptor::CMD) {
+      return Status::Invalid("Expected a substrait plan as a command descriptor");
+    }
+
+    auto plan_msg = Buffer::FromString(request.cmd);
+    ARROW_ASSIGN_OR_RAISE(auto result_schema, ResultSchemaFor(plan_msg));
+
+    auto ticket_id = RegisterQuery(plan_msg);
+    ARROW_ASSIGN_OR_RAISE(
+       auto flight_info
+      ,MakeFlightInfo(request, ticket_id, *result_schema, EstimateRowsFor(plan_msg))
+    );
+
+    *info = std::make_unique<FlightInfo>(std::move(flight_info));
+    return Status::OK();
+  }
+
+  Status MohairService::GetSchema( [[maybe_unused]] const ServerCallContext  &context
+                                  ,                 const FlightDescriptor   &request
+                                  ,                 unique_ptr<SchemaResult> *schema) {
+    if (request.type != FlightDescriptor::CMD) {
+      return Status::Invalid("Expected a substrait plan as a command descriptor");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto result_schema, ResultSchemaFor(Buffer::FromString(request.cmd)));
+    ARROW_ASSIGN_OR_RAISE(*schema, SchemaResult::Make(*result_schema));
+    return Status::OK();
+  }
+
+  /**
+   * Executes the plan for a ticket and streams its results as they are produced (see
+   * `StreamQuery`).
+   *
+   * Each ticket may only be retrieved once.
+   */
+  Status MohairService::DoGet( [[maybe_unused]] const ServerCallContext      &context
+                              ,                 const Ticket                 &request
+                              ,                 unique_ptr<FlightDataStream> *stream) {
+    ARROW_ASSIGN_OR_RAISE(auto plan_msg     , FindQuery(request.ticket, /*release=*/true));
+    ARROW_ASSIGN_OR_RAISE(auto result_reader, StreamQuery(plan_msg));
+
+    // results are pulled from the executing plan by the flight stream
+    *stream = std::make_unique<RecordBatchStream>(std::move(result_reader));
+
+    return Status::OK();
+  }
+
+  /** Tables are not uploaded through this service; it only executes plans. */
+  Status MohairService::DoPut( [[maybe_unused]] const ServerCallContext          &context
+                              ,[[maybe_unused]] unique_ptr<FlightMessageReader>   reader
+                              ,[[maybe_unused]] unique_ptr<FlightMetadataWriter>  writer) {
+    return Status::NotImplemented("DoPut is not supported; this service only executes plans");
+  }
+
+  /**
+   * Like `DoGet`, but the ticket is the command of the exchange's descriptor, and results
+   * are written to the exchange as they are produced (see `StreamQuery`). Batches that
+   * the client writes to the exchange are ignored.
+   *
+   * Each ticket may only be retrieved once.
+   */
+  Status MohairService::DoExchange( [[maybe_unused]] const ServerCallContext         &context
+                                   ,                 unique_ptr<FlightMessageReader>  reader
+                                   ,                 unique_ptr<FlightMessageWriter>  writer) {
+    const FlightDescriptor &request = reader->descriptor();
+    if (request.type != FlightDescriptor::CMD) {
+      return Status::Invalid("DoExchange expects a command descriptor that holds a ticket");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto plan_msg     , FindQuery(request.cmd, /*release=*/true));
+    ARROW_ASSIGN_OR_RAISE(auto result_reader, StreamQuery(plan_msg));
+
+    // results are pulled from the executing plan and written as they are read
+    ARROW_RETURN_NOT_OK(writer->Begin(result_reader->schema()));
+    while (true) {
+      shared_ptr<RecordBatch> result_batch;
+      ARROW_RETURN_NOT_OK(result_reader->ReadNext(&result_batch));
+      if (result_batch == nullptr) { break; }
+
+      ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*result_batch));
+    }
+
+    ARROW_RETURN_NOT_OK(result_reader->Close());
+    return writer->Close();
+  }
+
+  Status MohairService::DoAction( [[maybe_unused]] const ServerCallContext  &context
+                                 ,                 const Action             &action
+                                 ,                 unique_ptr<ResultStream> *result) {
+    if (action.type == "query") {
+      return ActionQuery(context, action.body, result);
+    }
+
+    // Catch all that returns Status::NotImplemented()
+    return ActionUnknown(context, action.type);
+  }
+
+  Status MohairService::ListActions( [[maybe_unused]] const ServerCallContext  &context
+                                    ,                 vector<ActionType>       *actions) {
+    *actions = {
+      ActionType { "query", "Submit a substrait plan; returns a ticket for DoGet" }
+    };
+
+    return Status::OK();
+  }
+
+  /**
+   * Accepts a substrait plan and returns a ticket (as the only result) that can be passed
+   * to `DoGet` to execute the plan and stream its results.
+   */
+  Status MohairService::ActionQuery( [[maybe_unused]] const ServerCallContext  &context
+                                    ,                 const shared_ptr<Buffer>  plan_msg
+                                    ,                 unique_ptr<ResultStream> *result) {
+    // validate the plan before accepting it
+    Plan substrait_plan;
+    if (not substrait_plan.ParseFromArray(plan_msg->data(), plan_msg->size())) {
+      return Status::Invalid("Unable to parse substrait plan");
+    }
+
+    auto ticket_id = RegisterQuery(plan_msg);
+
+    vector<FlightResult> query_results;
+    query_results.push_back(FlightResult { Buffer::FromString(ticket_id) });
+    *result = std::make_unique<SimpleResultStream>(std::move(query_results));
+
+    return Status::OK();
+  }
+
+  Status MohairService::ActionUnknown( [[maybe_unused]] const ServerCallContext &context
+                                      ,                 const string             action_type) {
+    return Status::NotImplemented("Unknown action: [", action_type, "]");
+  }
+
+
+  //  >> Functions for query execution
+
+  /**
+   * Returns the NamedTableProvider used to resolve named tables in submitted plans.
+   *
+   * The default provider raises an error for any named table; derived services that have
+   * access to data should override this.
+   */
+  NamedTableProvider MohairService::TableProvider() {
+    return ConversionOptions{}.named_table_provider;
+  }
+
+  /**
+   * Returns statistics of the tables that submitted plans may read, keyed by table name.
+   * The default service has no tables, so it has no statistics.
+   */
+  StatsMap MohairService::StatsForTables() { return {}; }
+
+  /**
+   * Stores a plan for later execution and returns the ticket that identifies it.
+   *
+   * Tickets are random, so a ticket can't be guessed from another. Tickets that are never
+   * retrieved expire after `ticket_ttl`, and at most `max_tickets` tickets are kept (the
+   * oldest are forgotten first).
+   */
+  string MohairService::RegisterQuery(const shared_ptr<Buffer> &plan_msg) {
+    std::lock_guard<std::mutex> query_lock { query_mutex };
+    ExpireQueries();
+
+    while (not query_plans.empty() and query_plans.size() >= max_tickets) {
+      auto oldest_entry = std::min_element(
+         query_plans.begin(), query_plans.end()
+        ,[](const auto &lhs, const auto &rhs) {
+           return lhs.second.submit_time < rhs.second.submit_time;
+         }
+      );
+
+      query_plans.erase(oldest_entry);
+    }
+
+    string ticket_id;
+    do {
+      std::stringstream ticket_ss;
+      ticket_ss << "query." << std::hex << std::setfill('0')
+                << std::setw(16) << ticket_rng()
+                << std::setw(16) << ticket_rng()
+      ;
+
+      ticket_id = ticket_ss.str();
+    } while (query_plans.count(ticket_id));
+
+    query_plans[ticket_id] = PendingQuery { plan_msg, std::chrono::steady_clock::now() };
+
+    return ticket_id;
+  }
+
+  /** Forgets tickets older than `ticket_ttl`. The caller must hold `query_mutex`. */
+  void MohairService::ExpireQueries() {
+    auto expire_time = std::chrono::steady_clock::now() - ticket_ttl;
+
+    for (auto plan_entry = query_plans.begin(); plan_entry != query_plans.end(); ) {
+      if (plan_entry->second.submit_time < expire_time) {
+        plan_entry = query_plans.erase(plan_entry);
+      }
+
+      else { ++plan_entry; }
+    }
+  }
+
+  /** Returns the plan for a ticket and, if `release` is true, forgets the ticket. */
+  Result<shared_ptr<Buffer>>
+  MohairService::FindQuery(const string &ticket_id, bool release) {
+    std::lock_guard<std::mutex> query_lock { query_mutex };
+    ExpireQueries();
+
+    auto plan_entry = query_plans.find(ticket_id);
+    if (plan_entry == query_plans.end()) {
+      return Status::KeyError("Unknown or expired ticket: [", ticket_id, "]");
+    }
+
+    auto plan_msg = plan_entry->second.plan_msg;
+    if (release) { query_plans.erase(plan_entry); }
+
+    return plan_msg;
+  }
+
+  /**
+   * Translates a serialized substrait plan to Acero using this service's tables.
+   *
+   * Translated plans are cached, so only the named tables are resolved for a plan that
+   * this service has seen recently.
+   */
+  Result<PlanInfo> MohairService::AceroPlanFor(const shared_ptr<Buffer> &plan_msg) {
+    return plan_cache.PlanFor(*plan_msg, TableProvider());
+  }
+
+  /**
+   * Executes a plan with the engine expected to execute it fastest (see `EngineForPlan`)
+   * and returns a reader that pulls results from the running plan.
+   *
+   * Plans run within this service's QueryContext with either engine. Named tables of a
+   * plan given to DuckDB are rewritten and bound to sources (see `InputSourcesFor`),
+   * which DuckDB scans as it executes.
+   */
+  Result<shared_ptr<RecordBatchReader>>
+  MohairService::StreamQuery(const shared_ptr<Buffer> &plan_msg) {
+    #if USE_DUCKDB
+      Plan substrait_plan;
+      if (not substrait_plan.ParseFromArray(plan_msg->data(), plan_msg->size())) {
+        return Status::Invalid("Unable to parse substrait plan");
+      }
+
+      auto plan_engine = mohair::adapters::EngineForPlan(substrait_plan);
+      if (duck_engine != nullptr and plan_engine == mohair::adapters::ExecEngine::DuckDB) {
+        ARROW_ASSIGN_OR_RAISE(
+           auto input_sources
+          ,mohair::adapters::InputSourcesFor(substrait_plan, TableProvider())
+        );
+
+        return duck_engine->StreamSubstrait(
+          substrait_plan.SerializeAsString(), input_sources, *query_ctx
+        );
+      }
+    #endif
+
+    ARROW_ASSIGN_OR_RAISE(auto acero_plan, AceroPlanFor(plan_msg));
+    return mohair::adapters::StreamPlan(acero_plan, *query_ctx);
+  }
+
+  /** Returns the result schema of a plan, without binding its named tables. */
+  Result<shared_ptr<Schema>>
+  MohairService::ResultSchemaFor(const shared_ptr<Buffer> &plan_msg) {
+    ARROW_ASSIGN_OR_RAISE(auto plan_template, plan_cache.TemplateFor(*plan_msg, TableProvider()));
+
+    return plan_template.root.output_schema;
+  }
+
+
+  /**
+   * Estimates the rows of a plan's result (see `EstimateGraph`) from the statistics of the
+   * tables it reads (see `StatsForTables`). Returns -1 (unknown) if the plan can't be parsed
+   * or if any table it reads has no statistics.
+   */
+  int64_t MohairService::EstimateRowsFor(const shared_ptr<Buffer> &plan_msg) {
+    string           plan_str { plan_msg->ToString() };
+    SubstraitMessage substrait_msg { plan_str };
+    if (substrait_msg.payload == nullptr)                 { return -1; }
+    if (mohair::FindPlanRoot(*substrait_msg.payload) < 0) { return -1; }
+
+    auto plan_graph = mohair::PlanGraphFrom(substrait_msg);
+    if (plan_graph == nullptr or plan_graph->nodes.empty()) { return -1; }
+
+    auto table_stats = StatsForTables();
+    for (uint32_t node_ndx = 0; node_ndx < plan_graph->nodes.size(); ++node_ndx) {
+      if (plan_graph->nodes[node_ndx].input_count > 0) { continue; }
+      if (not table_stats.count(plan_graph->TableName(node_ndx))) { return -1; }
+    }
+
+    auto node_ests = mohair::EstimateGraph(*plan_graph, table_stats);
+    return std::llround(node_ests[plan_graph->RootIndex()].row_count);
+  }
+
+
+  //  >> Convenience functions
+
+  /** `row_count` is the estimated rows of the result, or -1 if it is unknown. */
+  Result<FlightInfo>
+  MohairService::MakeFlightInfo( const FlightDescriptor &descriptor
+                                ,const string           &ticket_id
+                                ,const Schema           &result_schema
+                                ,int64_t                 row_count) {
+    // no locations: the ticket is retrieved from the service that issued it
+    vector<FlightEndpoint> endpoints { FlightEndpoint { Ticket { ticket_id }, {} } };
+
+    return FlightInfo::Make(
+      result_schema, descriptor, endpoints, /*total_records=*/row_count, /*total_bytes=*/-1
+    );
+  }
+
+} // namespace: mohair::services
@@ -26,6 +26,19 @@
 // >> integration with mohair query processing
 #include "../query/plans.hpp"
 
+// >> integration with execution engines
+#include "../engines/adapter_acero.hpp"
+#include "../engines/adapter_duckdb.hpp"
+
+//  >> Standard libs
+#include <map>
+#include <mutex>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+
 //  >> Third-party libs
 //    |> Arrow flight
 #include <arrow/flight/api.h>
@@ -47,6 +60,9 @@ using arrow::flight::FlightMessageWriter;
 using arrow::flight::FlightMetadataWriter;
 using arrow::flight::SchemaResult;
 using arrow::flight::ResultStream;
+using arrow::flight::SimpleResultStream;
+using arrow::flight::RecordBatchStream;
+using FlightResult = arrow::flight::Result;
 
 // >= 13.0.0
 // using arrow::flight::PollInfo;
@@ -57,6 +73,7 @@ using arrow::flight::SimpleFlightListing;
 using arrow::flight::ServerCallContext;
 using arrow::flight::Criteria;
 using arrow::flight::FlightDescriptor;
+using arrow::flight::FlightEndpoint;
 using arrow::flight::Ticket;
 using arrow::flight::Location;
 using arrow::flight::Action;
@@ -68,10 +85,45 @@ using arrow::flight::ActionType;
 
 namespace mohair::services {
 
+  // Default bounds on queries that have been submitted but not yet retrieved
+  constexpr size_t               default_max_tickets { 1024 };
+  constexpr std::chrono::seconds default_ticket_ttl  { 300  };
+
+  /** A submitted plan and when it was submitted (tickets expire, see `RegisterQuery`). */
+  struct PendingQuery {
+    shared_ptr<Buffer>                    plan_msg;
+    std::chrono::steady_clock::time_point submit_time;
+  };
+
   struct MohairService : public FlightServerBase {
 
+    //  >> State for queries that have been submitted but not yet retrieved
+    std::mutex                     query_mutex;
+    std::mt19937_64                ticket_rng  { std::random_device{}() };
+    std::map<string, PendingQuery> query_plans;
+    size_t                         max_tickets { default_max_tickets };
+    std::chrono::seconds           ticket_ttl  { default_ticket_ttl  };
+
+    //  >> State for reusing translated plans across queries
+    mohair::adapters::PlanCache          plan_cache;
+
+    //  >> State for executing plans (executor, memory pool, and admission)
+    //     Unless set beforehand, the context is made by `Init`, with a pool of
+    //     `query_threads` threads (one per core, if not positive) that runs `query_limit`
+    //     plans at once
+    int                                        query_threads { 0 };
+    size_t                                     query_limit   { adapters::default_max_queries };
+    shared_ptr<mohair::adapters::QueryContext> query_ctx;
+
+    //  >> State for executing plans that DuckDB executes faster (see `EngineForPlan`)
+    #if USE_DUCKDB
+      shared_ptr<mohair::adapters::DuckEngine> duck_engine;
+    #endif
+
+    virtual ~MohairService() = default;
+
     //  >> FlightServerBase functions to override
-    Status Init(const FlightServerOptions &options);
+    virtual Status Init(const FlightServerOptions &options);
 
     virtual Status ListFlights(
        const ServerCallContext&   context
@@ -140,8 +192,25 @@ namespace mohair::services {
       ,const string action_type
     );
 
+    //  >> Functions for query execution
+    virtual NamedTableProvider TableProvider();
+    virtual StatsMap           StatsForTables();
+
+    string                     RegisterQuery(const shared_ptr<Buffer> &plan_msg);
+    void                       ExpireQueries();
+    Result<shared_ptr<Buffer>> FindQuery(const string &ticket_id, bool release);
+    Result<PlanInfo>           AceroPlanFor(const shared_ptr<Buffer> &plan_msg);
+    Result<shared_ptr<Schema>> ResultSchemaFor(const shared_ptr<Buffer> &plan_msg);
+    int64_t                    EstimateRowsFor(const shared_ptr<Buffer> &plan_msg);
+
+    virtual Result<shared_ptr<RecordBatchReader>>
+    StreamQuery(const shared_ptr<Buffer> &plan_msg);
+
     //  >> Convenience functions
-    virtual FlightInfo MakeFlightInfo();
+    virtual Result<FlightInfo> MakeFlightInfo( const FlightDescriptor &descriptor
+                                              ,const string           &ticket_id
+                                              ,const Schema           &result_schema
+                                              ,int64_t                 row_count = -1);
 
   };
 
@@ -155,6 +224,6 @@ namespace mohair::services {
 
   // >> Convenience functions
   Status SetDefaultLocation(Location *srv_loc);
-  Status StartService(unique_ptr<FlightServerBase>& service);
+  Status StartService(unique_ptr<MohairService>& service);
 
 } // namespace: mohair::services
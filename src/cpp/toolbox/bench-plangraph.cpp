@@ -0,0 +1,156 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "../mohair.hpp"
+#include "../query/plans.hpp"
+
+#include <chrono>
+#include <iomanip>
+
+
+// >> Type Aliases
+using mohair::PlanGraph;
+
+using std::chrono::steady_clock;
+using std::chrono::nanoseconds;
+
+
+// >> Function Aliases
+using mohair::PlanGraphFrom;
+
+
+// ------------------------------
+// Variables
+
+// Default size of the largest plan (in join units, see `SyntheticPlanRel`) and the number
+// of times each plan is traversed
+constexpr size_t default_max_units   = 8192;
+constexpr int    default_repetitions = 10;
+
+// A unit is followed by an aggregate (a pipeline breaker) every `aggr_interval` units
+constexpr size_t aggr_interval = 8;
+
+
+// ------------------------------
+// Functions
+
+/** Makes `rel_msg` a read of the named table "t<table_ndx>". */
+void SetNamedRead(Rel *rel_msg, size_t table_ndx) {
+  rel_msg->mutable_read()
+         ->mutable_named_table()
+         ->add_names("t" + std::to_string(table_ndx));
+}
+
+/**
+ * Builds a left-deep plan of `unit_count` join units on `plan_arena`: each unit is an
+ * inner join of a filter (over the previous unit) and a read, and every `aggr_interval`
+ * units are aggregated. The plan is built from the root down, so every relation is
+ * allocated in place on the arena.
+ */
+Rel* SyntheticPlanRel(Arena *plan_arena, size_t unit_count) {
+  Rel *root_rel = Arena::Create<Rel>(plan_arena);
+  Rel *next_rel = root_rel;
+
+  for (size_t unit_ndx = unit_count; unit_ndx > 0; --unit_ndx) {
+    if (unit_ndx % aggr_interval == 0) {
+      next_rel = next_rel->mutable_aggregate()->mutable_input();
+    }
+
+    auto join_rel = next_rel->mutable_join();
+    join_rel->set_type(substrait::JoinRel::JOIN_TYPE_INNER);
+    SetNamedRead(join_rel->mutable_right(), unit_ndx);
+
+    next_rel = join_rel->mutable_left()->mutable_filter()->mutable_input();
+  }
+
+  SetNamedRead(next_rel, 0);
+  return root_rel;
+}
+
+/** Returns the mean time (in nanoseconds) to build a PlanGraph from `root_rel`. */
+double MeanTraversalTime(Rel *root_rel, int repetitions, size_t *node_count) {
+  nanoseconds total_time { 0 };
+
+  for (int rep_ndx = 0; rep_ndx < repetitions; ++rep_ndx) {
+    auto start_time = steady_clock::now();
+    auto plan_graph = PlanGraphFrom(root_rel);
+    total_time     += steady_clock::now() - start_time;
+
+    *node_count = plan_graph->nodes.size();
+  }
+
+  return static_cast<double>(total_time.count()) / repetitions;
+}
+
+int ValidateArgs(int argc, char **argv, size_t *max_units, int *repetitions) {
+  if (argc > 3) {
+    std::cerr << "Usage: bench-plangraph [max-join-units] [repetitions]" << std::endl;
+    return 1;
+  }
+
+  if (argc > 1) { *max_units   = std::stoul(argv[1]); }
+  if (argc > 2) { *repetitions = std::stoi(argv[2]);  }
+
+  if (*max_units == 0 or *repetitions < 1) {
+    std::cerr << "Join units and repetitions must be positive" << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
+
+
+// ------------------------------
+// Main Logic
+
+/**
+ * Times `PlanGraphFrom` on synthetic plans whose sizes double, up to `max-join-units`.
+ * If traversal is linear in plan size, the time per node stays roughly constant.
+ */
+int main(int argc, char **argv) {
+  size_t max_units   = default_max_units;
+  int    repetitions = default_repetitions;
+
+  int validate_status = ValidateArgs(argc, argv, &max_units, &repetitions);
+  if (validate_status != 0) { return validate_status; }
+
+  std::cout << std::setw(12) << "nodes"
+            << std::setw(16) << "mean (us)"
+            << std::setw(16) << "per node (ns)"
+            << std::endl
+  ;
+
+  for (size_t unit_count = 1; unit_count <= max_units; unit_count *= 2) {
+    auto plan_arena = mohair::NewPlanArena();
+    Rel *root_rel   = SyntheticPlanRel(plan_arena.get(), unit_count);
+
+    size_t node_count = 0;
+    double mean_time  = MeanTraversalTime(root_rel, repetitions, &node_count);
+
+    std::cout << std::setw(12) << node_count
+              << std::setw(16) << std::fixed << std::setprecision(1) << mean_time / 1000
+              << std::setw(16) << std::fixed << std::setprecision(1) << mean_time / node_count
+              << std::endl
+    ;
+  }
+
+  return 0;
+}
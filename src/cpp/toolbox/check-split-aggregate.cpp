@@ -0,0 +1,284 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "../engines/adapter_files.hpp"
+
+#include <arrow/compute/api.h>
+
+
+// >> Type Aliases
+using mohair::SubstraitMessage;
+
+using TableMap = std::unordered_map<string, shared_ptr<Table>>;
+
+
+// >> Function Aliases
+using mohair::InputStreamForFile;
+using mohair::PlanGraphFrom;
+using mohair::adapters::ExecutePlan;
+using mohair::adapters::ProviderForDirectory;
+
+
+// ------------------------------
+// Variables
+
+// Number of partitions (row ranges of each table) that partial aggregates run over
+constexpr int default_partition_count = 4;
+
+// Largest absolute difference allowed between values of split and unsplit results
+constexpr double result_tolerance = 1e-6;
+
+
+// ------------------------------
+// Functions
+int ValidateArgs(int argc, char **argv) {
+  if (argc < 3 or argc > 4) {
+    std::cerr << "Usage: check-split-aggregate <path-to-substrait-plan>"
+              << " <root directory or URI> [partition count]"
+              << std::endl
+    ;
+    return 1;
+  }
+
+  return 0;
+}
+
+/** Translates and executes a serialized plan whose named tables are bound by `provider`. */
+Result<shared_ptr<Table>>
+ExecuteSerialized(const string &plan_msg, const NamedTableProvider &provider) {
+  ConversionOptions conv_opts;
+  conv_opts.named_table_provider = provider;
+
+  ExtensionSet acero_ext_set;
+  ARROW_ASSIGN_OR_RAISE(
+     auto acero_plan
+    ,arrow::engine::DeserializePlan(
+        *Buffer::FromString(plan_msg)
+       ,arrow::engine::default_extension_id_registry()
+       ,&acero_ext_set
+       ,conv_opts
+     )
+  );
+
+  return ExecutePlan(acero_plan);
+}
+
+/**
+ * Returns a provider that serves partition `part_ndx` (of `part_count`) of each table
+ * that `base_provider` serves: a contiguous range of the table's rows. Each table is read
+ * once, into `table_cache`.
+ */
+NamedTableProvider ProviderForPartition( NamedTableProvider  base_provider
+                                        ,TableMap           *table_cache
+                                        ,int                 part_ndx
+                                        ,int                 part_count) {
+  return [base_provider, table_cache, part_ndx, part_count]( const vector<string> &tname
+                                                            ,const Schema         &tschema)
+                                                            -> Result<Declaration> {
+    string table_key   { mohair::JoinStr(tname, ".") };
+    auto   table_entry = table_cache->find(table_key);
+
+    if (table_entry == table_cache->end()) {
+      ARROW_ASSIGN_OR_RAISE(auto table_decl, base_provider(tname, tschema));
+      ARROW_ASSIGN_OR_RAISE(auto table_data, arrow::acero::DeclarationToTable(table_decl));
+
+      table_entry = table_cache->emplace(table_key, std::move(table_data)).first;
+    }
+
+    const auto &table_data = table_entry->second;
+    int64_t     part_len   = (table_data->num_rows() + part_count - 1) / part_count;
+    int64_t     part_start = std::min(part_ndx * part_len, table_data->num_rows());
+
+    return Declaration {
+      "table_source", TableSourceNodeOptions { table_data->Slice(part_start, part_len) }
+    };
+  };
+}
+
+/** Sorts `table_data` by each of its columns, in order, so that row order doesn't matter. */
+Result<shared_ptr<Table>> SortedTable(const shared_ptr<Table> &table_data) {
+  vector<arrow::compute::SortKey> sort_keys;
+  for (int col_ndx = 0; col_ndx < table_data->num_columns(); ++col_ndx) {
+    sort_keys.emplace_back(arrow::FieldRef { col_ndx });
+  }
+
+  ARROW_ASSIGN_OR_RAISE(
+     auto sort_ndxs
+    ,arrow::compute::SortIndices(table_data, arrow::compute::SortOptions { sort_keys })
+  );
+  ARROW_ASSIGN_OR_RAISE(auto sorted_data, arrow::compute::Take(table_data, sort_ndxs));
+
+  return sorted_data.table();
+}
+
+/** Compares sorted results, casting split results to the types of unsplit results. */
+Result<bool> ResultsMatch(const Table &expected, const Table &actual) {
+  if (expected.num_columns() != actual.num_columns()) { return false; }
+  if (expected.num_rows()    != actual.num_rows())    { return false; }
+
+  auto eq_opts = arrow::EqualOptions::Defaults().atol(result_tolerance).nans_equal(true);
+  for (int col_ndx = 0; col_ndx < expected.num_columns(); ++col_ndx) {
+    auto expected_col = expected.column(col_ndx);
+    auto actual_col   = actual.column(col_ndx);
+
+    if (not actual_col->type()->Equals(expected_col->type())) {
+      ARROW_ASSIGN_OR_RAISE(auto cast_col, arrow::compute::Cast(actual_col, expected_col->type()));
+      actual_col = cast_col.chunked_array();
+    }
+
+    if (not expected_col->ApproxEquals(*actual_col, eq_opts)) { return false; }
+  }
+
+  return true;
+}
+
+
+// ------------------------------
+// Main Logic
+
+/**
+ * Splits the leaf aggregate of a plan (see `SplitAggregate`), then checks that combining
+ * the partial results of each partition (the super-plan) matches the unsplit plan.
+ */
+int main(int argc, char **argv) {
+  int validate_status = ValidateArgs(argc, argv);
+  if (validate_status != 0) {
+    std::cerr << "Failed to validate input command-line args" << std::endl;
+    return validate_status;
+  }
+
+  int part_count = (argc == 4) ? std::atoi(argv[3]) : default_partition_count;
+  if (part_count < 1) {
+    std::cerr << "Partition count must be positive" << std::endl;
+    return 1;
+  }
+
+  // Read the substrait plan from a file; it is rewritten into the super-plan below
+  auto file_stream   = InputStreamForFile(argv[1]);
+  auto substrait_msg = std::make_unique<SubstraitMessage>(file_stream);
+  if (substrait_msg->payload == nullptr) {
+    std::cerr << "Failed to read substrait plan from file" << std::endl;
+    return 2;
+  }
+
+  string unsplit_plan { substrait_msg->Serialize() };
+
+  // Split the plan at its leaf aggregate
+  auto plan_graph = PlanGraphFrom(*substrait_msg);
+  if (plan_graph == nullptr) {
+    std::cerr << "Failed to parse substrait plan" << std::endl;
+    return 10;
+  }
+
+  auto plan_split = mohair::DecomposeGraph(*plan_graph, mohair::PartialAggregate);
+  if (plan_split == nullptr or not plan_split->split_aggr) {
+    std::cerr << "Plan has no leaf aggregate to split" << std::endl;
+    return 11;
+  }
+
+  Rel *anchor_rel   = plan_graph->nodes[plan_split->anchor_ndx].rel_msg;
+  auto subplan_msgs = substrait_msg->SubplansFromSplit(*plan_graph, *plan_split);
+  if (subplan_msgs.size() != 1 or anchor_rel->has_aggregate()) {
+    std::cerr << "Unable to split the plan's aggregate" << std::endl;
+    return 12;
+  }
+
+  string super_plan { substrait_msg->Serialize() };
+
+  // Execute the unsplit plan, then the sub-plan over each partition
+  TableMap table_cache;
+  auto     base_provider = ProviderForDirectory(argv[2]);
+
+  auto unsplit_result = ExecuteSerialized(
+    unsplit_plan, ProviderForPartition(base_provider, &table_cache, 0, 1)
+  );
+  if (not unsplit_result.ok()) {
+    mohair::PrintError("Failed to execute unsplit plan", unsplit_result.status());
+    return 3;
+  }
+
+  vector<shared_ptr<Table>> partial_results;
+  partial_results.reserve(part_count);
+  for (int part_ndx = 0; part_ndx < part_count; ++part_ndx) {
+    auto partial_result = ExecuteSerialized(
+       subplan_msgs[0]
+      ,ProviderForPartition(base_provider, &table_cache, part_ndx, part_count)
+    );
+
+    if (not partial_result.ok()) {
+      mohair::PrintError("Failed to execute sub-plan", partial_result.status());
+      return 3;
+    }
+
+    partial_results.push_back(std::move(partial_result).ValueOrDie());
+  }
+
+  auto partials = arrow::ConcatenateTables(partial_results);
+  if (not partials.ok()) {
+    mohair::PrintError("Failed to gather partial results", partials.status());
+    return 3;
+  }
+
+  // Execute the super-plan, which combines partial results
+  NamedTableProvider results_provider = [&partials]( const vector<string> &tname
+                                                    ,const Schema         &tschema)
+                                                    -> Result<Declaration> {
+    if (tname != mohair::SubplanResultsName(0)) {
+      return Status::Invalid("Super-plan reads unknown table: ", mohair::JoinStr(tname, "."));
+    }
+
+    return Declaration { "table_source", TableSourceNodeOptions { *partials } };
+  };
+
+  auto split_result = ExecuteSerialized(super_plan, results_provider);
+  if (not split_result.ok()) {
+    mohair::PrintError("Failed to execute super-plan", split_result.status());
+    return 3;
+  }
+
+  // Compare results, regardless of row order
+  auto sorted_unsplit = SortedTable(*unsplit_result);
+  auto sorted_split   = SortedTable(*split_result);
+  if (not sorted_unsplit.ok() or not sorted_split.ok()) {
+    std::cerr << "Failed to sort results" << std::endl;
+    return 4;
+  }
+
+  std::cout << "Unsplit results:" << std::endl;
+  mohair::PrintTable(*sorted_unsplit, 0, 10);
+
+  std::cout << "Split results (" << std::to_string(part_count) << " partitions):" << std::endl;
+  mohair::PrintTable(*sorted_split, 0, 10);
+
+  auto results_match = ResultsMatch(**sorted_unsplit, **sorted_split);
+  if (not results_match.ok()) {
+    mohair::PrintError("Failed to compare results", results_match.status());
+    return 4;
+  }
+
+  if (not *results_match) {
+    std::cerr << "Split results do not match unsplit results" << std::endl;
+    return 5;
+  }
+
+  std::cout << "Split results match unsplit results" << std::endl;
+  return 0;
+}
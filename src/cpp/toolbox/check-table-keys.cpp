@@ -0,0 +1,101 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "../engines/adapter_faodel.hpp"
+
+
+// >> Function Aliases
+using mohair::adapters::KeyForSubplan;
+using mohair::adapters::KeyForTableName;
+using mohair::adapters::TableNameForKey;
+
+
+// ------------------------------
+// Functions
+
+/** A plan whose root reads the named table `tname`. */
+Plan PlanForRead(const vector<string> &tname) {
+  Plan plan_msg;
+
+  auto read_msg = plan_msg.add_relations()->mutable_root()->mutable_input()->mutable_read();
+  for (const auto &name_part : tname) {
+    read_msg->mutable_named_table()->add_names(name_part);
+  }
+
+  return plan_msg;
+}
+
+/**
+ * Checks that a table is published, looked up, and routed to by the same key. A
+ * qualified name (more than one part) must not be split into a row and a column.
+ */
+int CheckTableName(const vector<string> &tname, const string &expected_row) {
+  KelpKey expected_key { expected_row };
+
+  auto table_key = KeyForTableName(tname);
+  if (not (table_key == expected_key)) {
+    std::cerr << "Table key [" << table_key.str() << "] does not match the published key ["
+              << expected_key.str() << "]"
+              << std::endl
+    ;
+    return 1;
+  }
+
+  if (TableNameForKey(table_key) != expected_row) {
+    std::cerr << "Table name of key [" << table_key.str() << "] is not: "
+              << expected_row
+              << std::endl
+    ;
+    return 2;
+  }
+
+  auto read_plan   = PlanForRead(tname);
+  auto subplan_key = KeyForSubplan(read_plan);
+  if (not subplan_key.ok()) {
+    mohair::PrintError("Failed to derive key of subplan", subplan_key.status());
+    return 3;
+  }
+
+  if (not (*subplan_key == expected_key)) {
+    std::cerr << "Subplan is routed to [" << subplan_key->str() << "] instead of ["
+              << expected_key.str() << "]"
+              << std::endl
+    ;
+    return 3;
+  }
+
+  return 0;
+}
+
+
+int main(int argc, char **argv) {
+  int check_status = CheckTableName({ "lineitem" }, "lineitem");
+  if (check_status != 0) { return check_status; }
+
+  check_status = CheckTableName({ "tpch", "lineitem" }, "tpch.lineitem");
+  if (check_status != 0) { return check_status; }
+
+  check_status = CheckTableName({ "catalog", "tpch", "lineitem" }, "catalog.tpch.lineitem");
+  if (check_status != 0) { return check_status; }
+
+  std::cout << "Table keys match for qualified and unqualified names" << std::endl;
+  return 0;
+}
@@ -0,0 +1,54 @@
+// ------------------------------
+// License
+//
+// Copyright 2024 Aldrin Montana
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// ------------------------------
+// Dependencies
+
+#include "../services/service_files.hpp"
+
+
+// ------------------------------
+// Functions
+int ValidateArgs(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: file-service <root directory or URI>" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+
+// ------------------------------
+// Main Logic
+int main(int argc, char **argv) {
+  int validate_status = ValidateArgs(argc, argv);
+  if (validate_status != 0) {
+    std::cerr << "Failed to validate input command-line args" << std::endl;
+    return validate_status;
+  }
+
+  // Start the flight service
+  auto status_service = mohair::services::StartFileService(argv[1]);
+  if (not status_service.ok()) {
+    mohair::PrintError("Error running file service", status_service);
+    return 2;
+  }
+
+  return 0;
+}
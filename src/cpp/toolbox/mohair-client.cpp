@@ -72,21 +72,34 @@ int SendMohairRequest(const char* plan_fpath) {
     return 5;
   }
 
+  // The only result of a query action is a ticket for the query results
   unique_ptr<ResultStream> query_results = std::move(result_stream).ValueOrDie();
   auto result_response = query_results->Next();
-  do {
-    if (not result_response.ok()) {
-      mohair::PrintError("Execution error.", result_response.status());
-      return 6;
-    }
+  if (not result_response.ok() or *result_response == nullptr) {
+    std::cerr << "Execution error: no ticket received" << std::endl;
+    return 6;
+  }
+
+  Ticket query_ticket { (*result_response)->body->ToString() };
+  std::cout << "Received ticket: " << query_ticket.ticket << std::endl;
 
-    std::cout << "parsed successful results" << std::endl;
+  // >> Retrieve the query results (streamed as they are produced)
+  auto result_reader = mohair_client->DoGet(flight_opts, query_ticket);
+  if (not result_reader.ok()) {
+    mohair::PrintError("Error retrieving query results", result_reader.status());
+    return 7;
+  }
 
-    result_response = query_results->Next();
+  auto result_table = (*result_reader)->ToTable();
+  if (not result_table.ok()) {
+    mohair::PrintError("Error reading query results", result_table.status());
+    return 8;
   }
-  while (result_response.ok());
 
   std::cout << "Query results:" << std::endl;
+  mohair::PrintTable(*result_table, 0, 10);
+
+  return 0;
 }
 
 
@@ -26,11 +26,9 @@
 
 
 // >> Type Aliases
-using mohair::QueryOp;
-using mohair::AppPlan;
 using mohair::DecomposeAlg;
 using mohair::SubstraitMessage;
-using mohair::PlanSplit;
+using mohair::GraphSplit;
 
 using google::protobuf::TextFormat;
 
@@ -38,9 +36,7 @@ using google::protobuf::TextFormat;
 // >> Function Aliases
 using mohair::InputStreamForFile;
 using mohair::OutputStreamForFile;
-using mohair::MohairPlanFrom;
-using mohair::AppPlanFromQueryOp;
-using mohair::DecomposePlan;
+using mohair::PlanGraphFrom;
 
 
 // ------------------------------
@@ -73,13 +69,9 @@ int main(int argc, char **argv) {
   }
 
   // Convert substrait to a plan we understand
-  // NOTE: keep this alive, everything else references from it.
-  std::cout << "Parsing Substrait..." << std::endl;
-  unique_ptr<QueryOp> mohair_root = MohairPlanFrom(*substrait_msg);
-
-  // NOTE: each AppPlan instance is a unique_ptr
-  std::cout << "Traversing Mohair plan..." << std::endl;
-  auto application_plan = AppPlanFromQueryOp(mohair_root.get());
+  // NOTE: keep `substrait_msg` alive, the plan graph references relations in it.
+  std::cout << "Traversing Substrait plan..." << std::endl;
+  auto application_plan = PlanGraphFrom(*substrait_msg);
   if (application_plan == nullptr) {
     std::cerr << "Failed to parse substrait plan" << std::endl;
     return 10;
@@ -91,30 +83,32 @@ int main(int argc, char **argv) {
 
   /* NOTE: this is just to peek at the result of walking the substrait plan */
   std::cout << "Breaker Leaves:" << std::endl;
-  std::vector<unique_ptr<AppPlan>>& plan_bleaves = application_plan->bleaf_ops;
+  const auto& plan_bleaves = application_plan->bleaf_ndxs;
   for (size_t bleaf_ndx = 0; bleaf_ndx < plan_bleaves.size(); ++bleaf_ndx) {
     std::cout << "\t[" << std::to_string(bleaf_ndx) << "]" << std::endl;
-
-    unique_ptr<AppPlan>& bleaf = plan_bleaves[bleaf_ndx];
-    std::cout << bleaf->ViewPlan() << std::endl;
+    std::cout << application_plan->ViewPlan(plan_bleaves[bleaf_ndx]) << std::endl;
   }
 
   std::cout << "Breaker Ops:" << std::endl;
-  std::vector<unique_ptr<AppPlan>>& plan_breakers = application_plan->break_ops;
+  const auto& plan_breakers = application_plan->break_ndxs;
   for (size_t break_ndx = 0; break_ndx < plan_breakers.size(); ++break_ndx) {
     std::cout << "\t[" << std::to_string(break_ndx) << "]" << std::endl;
-
-    unique_ptr<AppPlan>& breaker = plan_breakers[break_ndx];
-    std::cout << breaker->ViewPlan() << std::endl;
+    std::cout << application_plan->ViewPlan(plan_breakers[break_ndx]) << std::endl;
   }
 
   int subplan_total = 1;
   for (size_t split_ndx = 0; split_ndx < plan_breakers.size(); ++split_ndx) {
-    auto plan_split = std::make_unique<PlanSplit>(
-      *application_plan, *(plan_breakers[split_ndx])
-    );
+    GraphSplit plan_split { plan_breakers[split_ndx] };
+
+    auto subplan_msgs = substrait_msg->SubplansFromSplit(*application_plan, plan_split);
+    if (subplan_msgs.empty()) {
+      std::cerr << "Failed to serialize subplans for split [" << std::to_string(split_ndx) << "]"
+                << std::endl
+      ;
+
+      return 12;
+    }
 
-    auto subplan_msgs = substrait_msg->SubplansFromSplit(*plan_split);
     for (int subplan_ndx = 0; subplan_ndx < subplan_msgs.size(); ++subplan_ndx) {
       std::cout << "Creating subplan [" << std::to_string(subplan_total) << "]"
                 << std::endl
@@ -127,10 +121,10 @@ int main(int argc, char **argv) {
                               + ".substrait"
       };
 
-      SubstraitMessage& subplan_msg = *(subplan_msgs)[subplan_ndx];
-      auto success = subplan_msg.SerializeToFile(out_fname.data());
+      auto out_stream = OutputStreamForFile(out_fname.data());
+      out_stream << subplan_msgs[subplan_ndx];
 
-      if (not success) { return 11; }
+      if (not out_stream) { return 11; }
     }
   }
 
@@ -118,22 +118,16 @@ int main(int argc, char **argv) {
 
     fs::path path_to_arrow = local_file_protocol + fs::absolute(argv[1]).string();
 
-    // Create a RecordBatchStreamReader for the given `path_to_arrow`
-    arrow::Result<shared_ptr<Table>> read_result = mohair::ReadIPCFile(path_to_arrow.string());
-    if (not read_result.ok()) {
-      std::cerr << "Could not read file:"       << std::endl
-                << "\t" << read_result.status() << std::endl
-      ;
-      return 2;
-    }
+    // read only the first 10 columns of the first batch (for readability); the file is
+    // memory-mapped and other columns and batches are never decoded
+    mohair::IPCSelection file_sample { {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, 0, 1 };
 
-    // project the first 10 columns for readability
-    auto result_projection = (*read_result)->SelectColumns({0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    auto result_projection = mohair::ReadIPCFile(path_to_arrow.string(), file_sample);
     if (not result_projection.ok()) {
-      std::cerr << "Could not do projection:"         << std::endl
+      std::cerr << "Could not read file:"             << std::endl
                 << "\t" << result_projection.status() << std::endl
       ;
-      return 3;
+      return 2;
     }
 
     // print the first 10 rows for readability
@@ -21,12 +21,19 @@
 
 #include "mohair.hpp"
 
+#include <algorithm>
+
+#include <arrow/compute/api.h>
+#include <arrow/util/byte_size.h>
+#include <arrow/util/thread_pool.h>
+
 
 // >> Aliases
 
 using arrow::RecordBatchVector;
 
 using arrow::io::RandomAccessFile;
+using arrow::io::MemoryMappedFile;
 
 using arrow::ipc::RecordBatchStreamReader;
 using arrow::ipc::RecordBatchFileReader;
@@ -41,25 +48,41 @@ namespace mohair {
 
   // >> Internal functions only
   namespace {
-    /** Given a file path, return an arrow::ReadableFile. */
-    Result<shared_ptr<RandomAccessFile>> HandleForIPCFile(const std::string &path_as_uri) {
+    /**
+     * Given a file path, return an arrow::ReadableFile. If `file_access` is MemoryMapped
+     * and the path is on the local filesystem, the file is memory-mapped (read-only), so
+     * that buffers read from it are zero-copy slices of the mapping and the page cache is
+     * shared with other processes that map the same file.
+     */
+    Result<shared_ptr<RandomAccessFile>>
+    HandleForIPCFile(const std::string &path_as_uri, IPCAccess file_access) {
       std::cout << "Creating handle for arrow IPC-formatted file: " << path_as_uri << std::endl;
       std::string path_to_file;
 
       // get a `FileSystem` instance (local fs scheme is "file://")
       ARROW_ASSIGN_OR_RAISE(auto localfs, arrow::fs::FileSystemFromUri(path_as_uri, &path_to_file));
 
+      // only local files can be mapped; other filesystems are read through
+      if (file_access == IPCAccess::MemoryMapped and localfs->type_name() == "local") {
+        ARROW_ASSIGN_OR_RAISE(
+           auto mapped_file
+          ,MemoryMappedFile::Open(path_to_file, arrow::io::FileMode::READ)
+        );
+
+        return std::static_pointer_cast<RandomAccessFile>(mapped_file);
+      }
+
       // use the `FileSystem` instance to open a handle to the file
       return localfs->OpenInputFile(path_to_file);
     }
 
     /** Given a file path, create a RecordBatchStreamReader. */
     Result<shared_ptr<RecordBatchStreamReader>>
-    ReaderForIPCStream(const std::string &path_as_uri) {
+    ReaderForIPCStream(const std::string &path_as_uri, IPCAccess file_access) {
       std::cout << "Creating reader for IPC stream" << std::endl;
 
       // use the `FileSystem` instance to open a handle to the file
-      ARROW_ASSIGN_OR_RAISE(auto input_file_handle, HandleForIPCFile(path_as_uri));
+      ARROW_ASSIGN_OR_RAISE(auto input_file_handle, HandleForIPCFile(path_as_uri, file_access));
 
       // read from the handle using `RecordBatchStreamReader`
       return RecordBatchStreamReader::Open(input_file_handle, IPCReadOpts::Defaults());
@@ -67,15 +90,121 @@ namespace mohair {
 
     /** Given a file path, create a RecordBatchFileReader. */
     Result<shared_ptr<RecordBatchFileReader>>
-    ReaderForIPCFile(const std::string &path_as_uri) {
+    ReaderForIPCFile(const std::string &path_as_uri, IPCAccess file_access) {
       std::cout << "Creating reader for IPC file" << std::endl;
 
       // use the `FileSystem` instance to open a handle to the file
-      ARROW_ASSIGN_OR_RAISE(auto input_file_handle, HandleForIPCFile(path_as_uri));
+      ARROW_ASSIGN_OR_RAISE(auto input_file_handle, HandleForIPCFile(path_as_uri, file_access));
 
       // read from the handle using `RecordBatchStreamReader`
       return RecordBatchFileReader::Open(input_file_handle, IPCReadOpts::Defaults());
     }
+
+    // Names of zone ops in serialized zone predicates (indexed by ZoneOp)
+    const vector<string> zone_op_names {
+      "eq", "lt", "le", "gt", "ge", "is_null", "is_not_null"
+    };
+
+    /** The type of a literal in serialized zone predicates (null if unknown). */
+    shared_ptr<arrow::DataType> LiteralTypeForName(const string &type_name) {
+      static const std::unordered_map<string, shared_ptr<arrow::DataType>> literal_types {
+         { arrow::boolean()->ToString(), arrow::boolean() }
+        ,{ arrow::int8()->ToString()   , arrow::int8()    }
+        ,{ arrow::int16()->ToString()  , arrow::int16()   }
+        ,{ arrow::int32()->ToString()  , arrow::int32()   }
+        ,{ arrow::int64()->ToString()  , arrow::int64()   }
+        ,{ arrow::float32()->ToString(), arrow::float32() }
+        ,{ arrow::float64()->ToString(), arrow::float64() }
+        ,{ arrow::utf8()->ToString()   , arrow::utf8()    }
+      };
+
+      auto type_entry = literal_types.find(type_name);
+      if (type_entry == literal_types.end()) { return nullptr; }
+
+      return type_entry->second;
+    }
+
+    /** True if a zone map records the min and max of columns of type `col_type`. */
+    bool IsZonedType(const arrow::DataType &col_type) {
+      return (
+           arrow::is_integer(col_type.id())
+        or arrow::is_floating(col_type.id())
+        or arrow::is_temporal(col_type.id())
+        or col_type.id() == arrow::Type::STRING
+        or col_type.id() == arrow::Type::LARGE_STRING
+      );
+    }
+
+    /** Compares two scalars of the same type using the compute function `cmp_fn`. */
+    Result<bool> CompareScalars( const char                      *cmp_fn
+                                ,const shared_ptr<arrow::Scalar> &lhs
+                                ,const shared_ptr<arrow::Scalar> &rhs) {
+      ARROW_ASSIGN_OR_RAISE(auto cmp_datum, arrow::compute::CallFunction(cmp_fn, {lhs, rhs}));
+
+      const auto &cmp_scalar = cmp_datum.scalar_as<arrow::BooleanScalar>();
+      return cmp_scalar.is_valid and cmp_scalar.value;
+    }
+
+    /**
+     * True if a chunk whose `col_min` and `col_max` are given may contain a row where the
+     * column satisfies `zone_pred`. Undecidable predicates are assumed to match.
+     *
+     * The literal is compared in the column's type only if it converts exactly (see
+     * `LiteralForType`). Otherwise, the min and max are compared in the literal's type,
+     * which is only decided if they convert exactly.
+     */
+    bool RangeMayMatch( const ZonePredicate       &zone_pred
+                       ,shared_ptr<arrow::Scalar>  col_min
+                       ,shared_ptr<arrow::Scalar>  col_max) {
+      auto literal = LiteralForType(zone_pred, col_min->type);
+      if (not literal.ok()) {
+        if (zone_pred.literal_type == nullptr) { return true; }
+
+        literal     = arrow::Scalar::Parse(zone_pred.literal_type, zone_pred.literal);
+        auto lt_min = ExactCast(col_min, zone_pred.literal_type);
+        auto lt_max = ExactCast(col_max, zone_pred.literal_type);
+        if (not literal.ok() or not lt_min.ok() or not lt_max.ok()) { return true; }
+
+        col_min = *lt_min;
+        col_max = *lt_max;
+      }
+
+      Result<bool> is_excluded { false };
+      switch (zone_pred.op) {
+        case ZoneOp::Equal: {
+          is_excluded = CompareScalars("less", *literal, col_min);
+          if (is_excluded.ok() and not *is_excluded) {
+            is_excluded = CompareScalars("greater", *literal, col_max);
+          }
+          break;
+        }
+
+        case ZoneOp::Less: {
+          is_excluded = CompareScalars("greater_equal", col_min, *literal);
+          break;
+        }
+
+        case ZoneOp::LessEqual: {
+          is_excluded = CompareScalars("greater", col_min, *literal);
+          break;
+        }
+
+        case ZoneOp::Greater: {
+          is_excluded = CompareScalars("less_equal", col_max, *literal);
+          break;
+        }
+
+        case ZoneOp::GreaterEqual: {
+          is_excluded = CompareScalars("less", col_max, *literal);
+          break;
+        }
+
+        default: { break; }
+      }
+
+      return not is_excluded.ok() or not *is_excluded;
+    }
+
   } // anonymous namespace for internal functions
 
   //  >> Reader functions
@@ -115,21 +244,26 @@ namespace mohair {
   }
 
   /** Given a file path to an Arrow IPC stream, return a Table. */
-  Result<shared_ptr<Table>> ReadIPCStream(const std::string& path_to_file) {
+  Result<shared_ptr<Table>>
+  ReadIPCStream(const std::string& path_to_file, IPCAccess file_access) {
     std::cout << "Parsing file: " << path_to_file << std::endl;
 
     // Declares and initializes `batch_reader`
-    ARROW_ASSIGN_OR_RAISE(auto batch_reader, ReaderForIPCStream(path_to_file));
+    ARROW_ASSIGN_OR_RAISE(auto batch_reader, ReaderForIPCStream(path_to_file, file_access));
 
     return arrow::Table::FromRecordBatchReader(batch_reader.get());
   }
 
-  /** Given a file path to an Arrow IPC file, return a Table. */
-  Result<shared_ptr<Table>> ReadIPCFile(const std::string& path_to_file) {
+  /**
+   * Given a file path to an Arrow IPC file, return a Table. If the file is memory-mapped,
+   * the Table's buffers reference the mapping (uncompressed data is not copied).
+   */
+  Result<shared_ptr<Table>>
+  ReadIPCFile(const std::string& path_to_file, IPCAccess file_access) {
     std::cout << "Reading file: " << path_to_file << std::endl;
 
     // Declares and initializes `ipc_file_reader`
-    ARROW_ASSIGN_OR_RAISE(auto ipc_file_reader, ReaderForIPCFile(path_to_file));
+    ARROW_ASSIGN_OR_RAISE(auto ipc_file_reader, ReaderForIPCFile(path_to_file, file_access));
 
     // Based on RecordBatchFileReader::ToTable (Arrow >12.0.1)
     // https://github.com/apache/arrow/blob/main/cpp/src/arrow/ipc/reader.h#L236-L237
@@ -144,6 +278,369 @@ namespace mohair {
     return arrow::Table::FromRecordBatches(ipc_file_reader->schema(), batches);
   }
 
+  /** Given a file path to an Arrow IPC file, return a Table of the selected data. */
+  Result<shared_ptr<Table>>
+  ReadIPCFile( const std::string  &path_to_file
+              ,const IPCSelection &selection
+              ,IPCAccess           file_access) {
+    ARROW_ASSIGN_OR_RAISE(auto batch_reader, OpenIPCFile(path_to_file, selection, file_access));
+
+    return arrow::Table::FromRecordBatchReader(batch_reader.get());
+  }
+
+  /**
+   * Given a file path to an Arrow IPC file, return a reader that reads each batch when it
+   * is requested (see `IPCFileBatchReader`). By default, the file is memory-mapped.
+   */
+  Result<shared_ptr<IPCFileBatchReader>>
+  OpenIPCFile(const std::string& path_to_file, IPCAccess file_access) {
+    return OpenIPCFile(path_to_file, IPCSelection {}, file_access);
+  }
+
+  /**
+   * Like `OpenIPCFile`, but only the selected fields and batches are read. Fields are
+   * selected via `IpcReadOptions::included_fields`, so other fields are never decoded, and
+   * batches are located via the file's footer, so other batches are never read.
+   */
+  Result<shared_ptr<IPCFileBatchReader>>
+  OpenIPCFile( const std::string  &path_to_file
+              ,const IPCSelection &selection
+              ,IPCAccess           file_access) {
+    std::cout << "Opening file: " << path_to_file << std::endl;
+
+    ARROW_ASSIGN_OR_RAISE(auto file_handle, HandleForIPCFile(path_to_file, file_access));
+    return OpenIPCFile(file_handle, selection);
+  }
+
+  /**
+   * Like `OpenIPCFile`, but reads from an open `file_handle` (e.g. a file opened through a
+   * FileSystem). The handle is shared by the reader and its prefetch readers.
+   */
+  Result<shared_ptr<IPCFileBatchReader>>
+  OpenIPCFile( const shared_ptr<RandomAccessFile> &file_handle
+              ,const IPCSelection                 &selection) {
+    auto read_opts            = IPCReadOpts::Defaults();
+    read_opts.included_fields = selection.field_ndxs;
+
+    ARROW_ASSIGN_OR_RAISE(auto file_reader, RecordBatchFileReader::Open(file_handle, read_opts));
+
+    // validate the batch range against the footer
+    int batch_count = file_reader->num_record_batches();
+    int batch_end   = selection.batch_end < 0 ? batch_count : selection.batch_end;
+    if (selection.batch_begin < 0 or selection.batch_begin > batch_end) {
+      return Status::Invalid(
+        "Invalid batch range: [", selection.batch_begin, ", ", batch_end, ")"
+      );
+    }
+
+    if (batch_end > batch_count) {
+      return Status::IndexError(
+        "Batch range ends at ", batch_end, " but file has ", batch_count, " batches"
+      );
+    }
+
+    auto batch_reader = std::make_shared<IPCFileBatchReader>(
+      std::move(file_reader), selection.batch_begin, batch_end
+    );
+
+    // prefetch readers share the file handle (reads at an offset are thread-safe)
+    for (int reader_ndx = 0; reader_ndx < selection.prefetch_count; ++reader_ndx) {
+      ARROW_ASSIGN_OR_RAISE(
+         auto prefetch_reader
+        ,RecordBatchFileReader::Open(file_handle, read_opts)
+      );
+
+      batch_reader->prefetch_readers.push_back(std::move(prefetch_reader));
+    }
+
+    return batch_reader;
+  }
+
+
+  // >> Statistics functions
+
+  /**
+   * Estimates the bytes per row of a table with `table_schema`. Fixed-width types use
+   * their byte width and variable-width types use `default_varwidth_bytes`.
+   */
+  int64_t EstimateRowWidth(const Schema &table_schema) {
+    int64_t row_width = 0;
+
+    for (const auto &field : table_schema.fields()) {
+      auto fixed_type = dynamic_cast<const arrow::FixedWidthType*>(field->type().get());
+
+      if (fixed_type == nullptr) { row_width += default_varwidth_bytes;            }
+      else                       { row_width += (fixed_type->bit_width() + 7) / 8; }
+    }
+
+    return row_width;
+  }
+
+  /** Statistics for an in-memory table, using the size of its buffers. */
+  TableStats StatsForTable(const Table &table_data) {
+    TableStats table_stats { table_data.num_rows(), EstimateRowWidth(*table_data.schema()) };
+
+    if (table_stats.row_count > 0) {
+      table_stats.row_width = (
+        arrow::util::TotalBufferSize(table_data) / table_stats.row_count
+      );
+    }
+
+    return table_stats;
+  }
+
+  /**
+   * Statistics for an Arrow IPC file, using only the schema and batch metadata from the
+   * file footer (no column data is read).
+   */
+  Result<TableStats> StatsForIPCFile(const std::string& path_to_file) {
+    ARROW_ASSIGN_OR_RAISE(
+       auto ipc_file_reader
+      ,ReaderForIPCFile(path_to_file, IPCAccess::MemoryMapped)
+    );
+    ARROW_ASSIGN_OR_RAISE(auto row_count      , ipc_file_reader->CountRows());
+
+    return TableStats { row_count, EstimateRowWidth(*(ipc_file_reader->schema())) };
+  }
+
+
+  // >> Zone map functions
+
+  /**
+   * Serializes zone predicates as lines of tab-separated fields (column, op, literal type,
+   * literal), so that they can be attached to a schema as metadata. Predicates whose
+   * column or literal contain a separator are dropped (a dropped predicate only means
+   * fewer skipped chunks). An unknown literal type is written as an empty field.
+   */
+  string SerializeZonePredicates(const vector<ZonePredicate> &zone_preds) {
+    stringstream preds_stream;
+
+    for (const auto &zone_pred : zone_preds) {
+      bool has_separator = (
+           zone_pred.column_name.find_first_of("\t\n") != string::npos
+        or zone_pred.literal.find_first_of("\t\n")     != string::npos
+      );
+      if (has_separator) { continue; }
+
+      string type_name = zone_pred.literal_type ? zone_pred.literal_type->ToString() : "";
+      preds_stream << zone_pred.column_name                            << "\t"
+                   << zone_op_names[static_cast<size_t>(zone_pred.op)] << "\t"
+                   << type_name                                        << "\t"
+                   << zone_pred.literal                                << "\n"
+      ;
+    }
+
+    return preds_stream.str();
+  }
+
+  /** Parses zone predicates serialized by `SerializeZonePredicates`, skipping bad lines. */
+  vector<ZonePredicate> ParseZonePredicates(const string &serialized_preds) {
+    vector<ZonePredicate> zone_preds;
+    stringstream          preds_stream { serialized_preds };
+    string                pred_line;
+
+    while (std::getline(preds_stream, pred_line)) {
+      auto op_begin   = pred_line.find('\t');
+      auto type_begin = pred_line.find('\t', op_begin + 1);
+      auto lit_begin  = pred_line.find('\t', type_begin + 1);
+      if (op_begin == string::npos or type_begin == string::npos) { continue; }
+      if (lit_begin == string::npos)                                { continue; }
+
+      auto op_name  = pred_line.substr(op_begin + 1, type_begin - op_begin - 1);
+      auto op_entry = std::find(zone_op_names.begin(), zone_op_names.end(), op_name);
+      if (op_entry == zone_op_names.end()) { continue; }
+
+      zone_preds.push_back(ZonePredicate {
+         pred_line.substr(0, op_begin)
+        ,static_cast<ZoneOp>(op_entry - zone_op_names.begin())
+        ,pred_line.substr(lit_begin + 1)
+        ,LiteralTypeForName(pred_line.substr(type_begin + 1, lit_begin - type_begin - 1))
+      });
+    }
+
+    return zone_preds;
+  }
+
+  /** The zone predicates attached to `table_schema` (see `zone_predicates_key`), if any. */
+  vector<ZonePredicate> ZonePredicatesForSchema(const Schema &table_schema) {
+    const auto &schema_meta = table_schema.metadata();
+    if (schema_meta == nullptr) { return {}; }
+
+    auto serialized_preds = schema_meta->Get(zone_predicates_key);
+    if (not serialized_preds.ok()) { return {}; }
+
+    return ParseZonePredicates(*serialized_preds);
+  }
+
+  /**
+   * Returns `scalar` cast to `to_type`, but only if the cast is exact: casting the result
+   * back gives the original value. A lossy cast (e.g. 2.5 to an integer) is an error.
+   */
+  Result<shared_ptr<arrow::Scalar>> ExactCast( const shared_ptr<arrow::Scalar>   &scalar
+                                              ,const shared_ptr<arrow::DataType> &to_type) {
+    if (scalar->type->Equals(*to_type)) { return scalar; }
+
+    auto cast_opts = arrow::compute::CastOptions::Unsafe(to_type);
+    ARROW_ASSIGN_OR_RAISE(auto cast_datum, arrow::compute::Cast(scalar, cast_opts));
+
+    cast_opts.to_type = scalar->type;
+    ARROW_ASSIGN_OR_RAISE(auto back_datum, arrow::compute::Cast(cast_datum, cast_opts));
+
+    if (not back_datum.scalar()->Equals(*scalar)) {
+      return Status::Invalid("Cast of ", scalar->ToString(), " to ", to_type->ToString()
+                            ," is not exact");
+    }
+
+    return cast_datum.scalar();
+  }
+
+  /**
+   * Returns the literal of `zone_pred` as a scalar of `to_type` (e.g. a column's type). A
+   * literal of a known type is parsed in that type and then cast, and only an exact cast
+   * (see `ExactCast`) succeeds, so a literal is never rounded.
+   */
+  Result<shared_ptr<arrow::Scalar>> LiteralForType( const ZonePredicate               &zone_pred
+                                                   ,const shared_ptr<arrow::DataType> &to_type) {
+    if (zone_pred.literal_type == nullptr) {
+      return arrow::Scalar::Parse(to_type, zone_pred.literal);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(
+       auto literal
+      ,arrow::Scalar::Parse(zone_pred.literal_type, zone_pred.literal)
+    );
+
+    return ExactCast(literal, to_type);
+  }
+
+  /**
+   * Returns a zone map for a sequence of tables (chunks): a table with a row per chunk.
+   *
+   * The zone map has a "row_count" column and, for each column of an orderable type, the
+   * columns "<name>.min", "<name>.max" and "<name>.null_count". Other columns (e.g.
+   * nested types) have no statistics, so predicates on them never skip a chunk. The zone
+   * map's schema is marked with `zone_map_key`, so it can be stored alongside its chunks.
+   */
+  Result<shared_ptr<Table>> ZoneMapForChunks(const vector<shared_ptr<Table>> &chunks) {
+    if (chunks.empty()) { return Status::Invalid("Zone map requires at least 1 chunk"); }
+
+    const auto &chunk_schema = chunks[0]->schema();
+    arrow::FieldVector zone_fields { arrow::field("row_count", arrow::int64()) };
+    vector<int>        zoned_ndxs;
+
+    for (int field_ndx = 0; field_ndx < chunk_schema->num_fields(); ++field_ndx) {
+      const auto &chunk_field = chunk_schema->field(field_ndx);
+      if (not IsZonedType(*chunk_field->type())) { continue; }
+
+      zoned_ndxs.push_back(field_ndx);
+      zone_fields.push_back(arrow::field(chunk_field->name() + ".min", chunk_field->type()));
+      zone_fields.push_back(arrow::field(chunk_field->name() + ".max", chunk_field->type()));
+      zone_fields.push_back(arrow::field(chunk_field->name() + ".null_count", arrow::int64()));
+    }
+
+    // a builder per zone map column, in the same order as `zone_fields`
+    vector<unique_ptr<arrow::ArrayBuilder>> zone_builders;
+    zone_builders.reserve(zone_fields.size());
+    for (const auto &zone_field : zone_fields) {
+      ARROW_ASSIGN_OR_RAISE(auto zone_builder, arrow::MakeBuilder(zone_field->type()));
+      zone_builders.push_back(std::move(zone_builder));
+    }
+
+    arrow::compute::ScalarAggregateOptions minmax_opts { /*skip_nulls=*/true };
+    for (const auto &chunk_table : chunks) {
+      ARROW_RETURN_NOT_OK(
+        zone_builders[0]->AppendScalar(arrow::Int64Scalar { chunk_table->num_rows() })
+      );
+
+      size_t builder_ndx = 1;
+      for (const int zoned_ndx : zoned_ndxs) {
+        const auto &chunk_column = chunk_table->column(zoned_ndx);
+        ARROW_ASSIGN_OR_RAISE(
+           auto minmax_datum
+          ,arrow::compute::MinMax(chunk_column, minmax_opts)
+        );
+
+        // min and max are null if every value is null
+        const auto &minmax_scalar = minmax_datum.scalar_as<arrow::StructScalar>();
+        ARROW_RETURN_NOT_OK(zone_builders[builder_ndx++]->AppendScalar(*minmax_scalar.value[0]));
+        ARROW_RETURN_NOT_OK(zone_builders[builder_ndx++]->AppendScalar(*minmax_scalar.value[1]));
+        ARROW_RETURN_NOT_OK(
+          zone_builders[builder_ndx++]->AppendScalar(
+            arrow::Int64Scalar { chunk_column->null_count() }
+          )
+        );
+      }
+    }
+
+    arrow::ArrayVector zone_columns;
+    zone_columns.reserve(zone_builders.size());
+    for (auto &zone_builder : zone_builders) {
+      ARROW_ASSIGN_OR_RAISE(auto zone_column, zone_builder->Finish());
+      zone_columns.push_back(std::move(zone_column));
+    }
+
+    auto zone_meta = arrow::key_value_metadata({ zone_map_key }, { "true" });
+    return Table::Make(arrow::schema(zone_fields, zone_meta), zone_columns);
+  }
+
+  /** True if `table_data` is a zone map (see `ZoneMapForChunks`). */
+  bool IsZoneMap(const Table &table_data) {
+    const auto &schema_meta = table_data.schema()->metadata();
+    if (schema_meta == nullptr) { return false; }
+
+    return schema_meta->Contains(zone_map_key);
+  }
+
+  /**
+   * True unless the statistics of chunk `chunk_ndx` in `zone_map` prove that no row of
+   * the chunk satisfies every predicate in `zone_preds`. This is conservative: a predicate
+   * on a column without statistics, or that can't be evaluated, never excludes a chunk.
+   */
+  bool ChunkMayMatch( const Table                 &zone_map
+                     ,int64_t                      chunk_ndx
+                     ,const vector<ZonePredicate> &zone_preds) {
+    if (chunk_ndx < 0 or chunk_ndx >= zone_map.num_rows()) { return true; }
+
+    auto row_count_col = zone_map.GetColumnByName("row_count");
+    if (row_count_col == nullptr) { return true; }
+
+    auto row_count = row_count_col->GetScalar(chunk_ndx);
+    if (not row_count.ok()) { return true; }
+
+    const auto chunk_rows = std::static_pointer_cast<arrow::Int64Scalar>(*row_count)->value;
+    if (chunk_rows == 0) { return zone_preds.empty(); }
+
+    for (const auto &zone_pred : zone_preds) {
+      auto null_count_col = zone_map.GetColumnByName(zone_pred.column_name + ".null_count");
+      auto min_col        = zone_map.GetColumnByName(zone_pred.column_name + ".min");
+      auto max_col        = zone_map.GetColumnByName(zone_pred.column_name + ".max");
+      if (null_count_col == nullptr or min_col == nullptr or max_col == nullptr) { continue; }
+
+      auto null_count = null_count_col->GetScalar(chunk_ndx);
+      if (not null_count.ok()) { continue; }
+
+      const auto chunk_nulls = std::static_pointer_cast<arrow::Int64Scalar>(*null_count)->value;
+      switch (zone_pred.op) {
+        case ZoneOp::IsNull:    { if (chunk_nulls == 0)          { return false; } break; }
+        case ZoneOp::IsNotNull: { if (chunk_nulls == chunk_rows) { return false; } break; }
+
+        default: {
+          // comparisons to null are never true, so a chunk of only nulls never matches
+          if (chunk_nulls == chunk_rows) { return false; }
+
+          auto col_min = min_col->GetScalar(chunk_ndx);
+          auto col_max = max_col->GetScalar(chunk_ndx);
+          if (not col_min.ok() or not col_max.ok()) { break; }
+
+          if (not RangeMayMatch(zone_pred, *col_min, *col_max)) { return false; }
+          break;
+        }
+      }
+    }
+
+    return true;
+  }
+
 
   // >> Convenience Functions
 
@@ -196,3 +693,60 @@ namespace mohair {
   }
 
 } // namespace: mohair
+
+
+// ------------------------------
+// Classes and Methods
+
+namespace mohair {
+
+  //  >> IPCFileBatchReader
+
+  /** Starts reading batches (on Arrow's CPU pool) until each prefetch reader has one. */
+  void IPCFileBatchReader::PrefetchBatches() {
+    auto cpu_pool = arrow::internal::GetCpuThreadPool();
+
+    while (prefetched_batches.size() < prefetch_readers.size() and batch_ndx < batch_end) {
+      auto read_batch = cpu_pool->Submit(
+        [ prefetch_reader = prefetch_readers[batch_ndx % prefetch_readers.size()]
+         ,file_batch_ndx  = batch_ndx]() {
+          return prefetch_reader->ReadRecordBatch(file_batch_ndx);
+        }
+      );
+
+      ++batch_ndx;
+      if (not read_batch.ok()) {
+        prefetched_batches.push_back(BatchFuture::MakeFinished(read_batch.status()));
+      }
+      else { prefetched_batches.push_back(std::move(read_batch).ValueOrDie()); }
+    }
+  }
+
+  /** The schema of the selected fields. */
+  shared_ptr<Schema> IPCFileBatchReader::schema() const { return file_reader->schema(); }
+
+  /**
+   * Reads the next batch in the range (the oldest prefetched batch, if any), or emits
+   * nullptr after the last batch.
+   */
+  Status IPCFileBatchReader::ReadNext(shared_ptr<arrow::RecordBatch> *batch) {
+    *batch = nullptr;
+    PrefetchBatches();
+
+    if (prefetched_batches.empty()) {
+      if (batch_ndx >= batch_end) { return Status::OK(); }
+
+      ARROW_ASSIGN_OR_RAISE(*batch, file_reader->ReadRecordBatch(batch_ndx++));
+      return Status::OK();
+    }
+
+    auto next_batch = std::move(prefetched_batches.front());
+    prefetched_batches.pop_front();
+
+    ARROW_ASSIGN_OR_RAISE(*batch, next_batch.result());
+    PrefetchBatches();
+
+    return Status::OK();
+  }
+
+} // namespace: mohair